@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+#
+# Addon server: Runs an addon for many dump files in one python process
+#
+# Cppcheck starts the server once per addon and then writes the paths of
+# the dump files to its stdin, one path per line. The addon is executed
+# for each dump file as if it had been started from the command line and
+# the output is followed by a line with DONE_MARKER. The python
+# interpreter, cppcheckdata and the compiled addon script are loaded once.
+#
+# Usage:
+# python addonserver.py <addon script> [addon arguments]
+
+import os
+import sys
+import traceback
+
+DONE_MARKER = '@@cppcheck-addon-done@@'
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.stderr.write('Usage: %s <addon script> [addon arguments]\n' % sys.argv[0])
+        sys.exit(1)
+
+    script = sys.argv[1]
+    addonArgs = sys.argv[2:]
+
+    # The addon imports cppcheckdata and its own modules from its directory
+    scriptDir = os.path.dirname(os.path.abspath(script))
+    if scriptDir not in sys.path:
+        sys.path.insert(0, scriptDir)
+
+    with open(script, 'rt') as f:
+        code = compile(f.read(), script, 'exec')
+
+    # Errors of the addon are reported to cppcheck together with its output
+    stdout = sys.stdout
+    sys.stderr = stdout
+
+    while True:
+        dumpfile = sys.stdin.readline()
+        if not dumpfile:
+            break
+        dumpfile = dumpfile.rstrip('\r\n')
+        if not dumpfile:
+            break
+
+        sys.argv = [script] + addonArgs + [dumpfile]
+        if 'cppcheckdata' in sys.modules:
+            sys.modules['cppcheckdata'].EXIT_CODE = 0
+        try:
+            exec(code, {'__name__': '__main__', '__file__': script})
+        except SystemExit:
+            pass
+        except Exception:
+            traceback.print_exc(file=stdout)
+
+        stdout.write('\n' + DONE_MARKER + '\n')
+        stdout.flush()
+
+
+if __name__ == '__main__':
+    main()
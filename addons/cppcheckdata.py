@@ -842,6 +842,8 @@ class CppcheckData:
         :param filename: Path to Cppcheck dump file
         """
         self.filename = filename
+        self.rawTokens = []
+        self.suppressions = []
 
         files = []  # source files for elements occurred in this configuration
         platform_done = False
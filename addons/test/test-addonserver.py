@@ -0,0 +1,46 @@
+# Running the test with Python 2:
+# Be sure to install pytest version 4.6.4 (newer should also work)
+# Command in cppcheck directory:
+# python -m pytest addons/test/test-addonserver.py
+#
+# Running the test with Python 3:
+# Command in cppcheck directory:
+# PYTHONPATH=./addons python3 -m pytest addons/test/test-addonserver.py
+
+import subprocess
+import sys
+import pytest
+
+from .util import dump_create, dump_remove
+
+TEST_SOURCE_FILES = ['./addons/test/cert-test.c', './addons/test/misc-test.cpp']
+DONE_MARKER = '@@cppcheck-addon-done@@'
+
+
+def setup_module(module):
+    for f in TEST_SOURCE_FILES:
+        dump_create(f)
+
+
+def teardown_module(module):
+    for f in TEST_SOURCE_FILES:
+        dump_remove(f)
+
+
+def run_addon(script, dumpfile):
+    p = subprocess.Popen([sys.executable, script, '--cli', dumpfile], stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    return p.communicate()[0]
+
+
+@pytest.mark.parametrize('script', ['./addons/cert.py', './addons/misc.py'])
+def test_same_output(script):
+    dumpfiles = [f + '.dump' for f in TEST_SOURCE_FILES]
+    p = subprocess.Popen([sys.executable, './addons/addonserver.py', script, '--cli'], stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+    # Each dump file is checked twice to see that no state is left from the previous run
+    output = p.communicate(''.join(f + '\n' for f in dumpfiles + dumpfiles) + '\n')[0]
+    assert p.returncode == 0
+
+    results = output.split('\n' + DONE_MARKER + '\n')
+    assert results[-1] == ''
+    expected = [run_addon(script, f) for f in dumpfiles + dumpfiles]
+    assert results[:-1] == expected
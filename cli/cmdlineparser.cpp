@@ -247,6 +247,26 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 }
             }
 
+            // Threads checking the configurations of a file
+            else if (std::strncmp(argv[i], "--config-jobs=", 14) == 0) {
+                std::istringstream iss(14+argv[i]);
+                if (!(iss >> mSettings->configJobs)) {
+                    printMessage("cppcheck: argument to '--config-jobs=' is not a number.");
+                    return false;
+                }
+
+                if (mSettings->configJobs < 1) {
+                    printMessage("cppcheck: argument to '--config-jobs=' must be greater than 0.");
+                    return false;
+                }
+
+                if (mSettings->configJobs > 10000) {
+                    // This limit is here just to catch typos, same as for '-j'.
+                    printMessage("cppcheck: argument for '--config-jobs=' is allowed to be 10000 at max.");
+                    return false;
+                }
+            }
+
             else if (std::strncmp(argv[i], "--cppcheck-build-dir=", 21) == 0) {
                 mSettings->buildDir = Path::fromNativeSeparators(argv[i] + 21);
                 if (endsWith(mSettings->buildDir, '/'))
@@ -337,6 +357,20 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 CppCheckExecutor::setExceptionOutput((exceptionOutfilename=="stderr") ? stderr : stdout);
             }
 
+            else if (std::strncmp(argv[i], "--executor=", 11) == 0) {
+                const std::string type = 11 + argv[i];
+                if (type == "thread")
+                    mSettings->executor = Settings::ExecutorType::Thread;
+#ifdef THREADING_MODEL_FORK
+                else if (type == "process")
+                    mSettings->executor = Settings::ExecutorType::Process;
+#endif
+                else {
+                    printMessage("cppcheck: unknown executor: '" + type + "'.");
+                    return false;
+                }
+            }
+
             // Filter errors
             else if (std::strncmp(argv[i], "--exitcode-suppressions=", 24) == 0) {
                 // exitcode-suppressions=filename.txt
@@ -516,6 +550,11 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 mSettings->libraries.emplace_back(argv[i] + 10);
             }
 
+            // Cache directory for the binary library configurations
+            else if (std::strncmp(argv[i], "--library-cache-dir=", 20) == 0) {
+                mSettings->library.setCacheDir(Path::fromNativeSeparators(argv[i] + 20));
+            }
+
             // Set maximum number of #ifdef configurations to check
             else if (std::strncmp(argv[i], "--max-configs=", 14) == 0) {
                 mSettings->force = false;
@@ -852,6 +891,26 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
                 }
             }
 
+            // Threads running the ValueFlow analysis of a file
+            else if (std::strncmp(argv[i], "--valueflow-jobs=", 17) == 0) {
+                std::istringstream iss(17+argv[i]);
+                if (!(iss >> mSettings->valueFlowJobs)) {
+                    printMessage("cppcheck: argument to '--valueflow-jobs=' is not a number.");
+                    return false;
+                }
+
+                if (mSettings->valueFlowJobs < 1) {
+                    printMessage("cppcheck: argument to '--valueflow-jobs=' must be greater than 0.");
+                    return false;
+                }
+
+                if (mSettings->valueFlowJobs > 10000) {
+                    // This limit is here just to catch typos, same as for '-j'.
+                    printMessage("cppcheck: argument for '--valueflow-jobs=' is allowed to be 10000 at max.");
+                    return false;
+                }
+            }
+
             else if (std::strcmp(argv[i], "-v") == 0 || std::strcmp(argv[i], "--verbose") == 0)
                 mSettings->verbose = true;
 
@@ -917,10 +976,6 @@ bool CmdLineParser::parseFromArgs(int argc, const char* const argv[])
     else if ((def || mSettings->preprocessOnly) && !maxconfigs)
         mSettings->maxConfigs = 1U;
 
-    if (mSettings->isEnabled(Settings::UNUSED_FUNCTION) && mSettings->jobs > 1) {
-        printMessage("cppcheck: unusedFunction check can't be used with '-j' option. Disabling unusedFunction check.");
-    }
-
     if (argc <= 1) {
         mShowHelp = true;
         mExitAfterPrint = true;
@@ -990,6 +1045,10 @@ void CmdLineParser::printHelp()
               "                         be considered for evaluation.\n"
               "    --config-excludes-file=<file>\n"
               "                         A file that contains a list of config-excludes\n"
+              "    --config-jobs=<jobs> Start <jobs> threads to check the preprocessor\n"
+              "                         configurations of each file simultaneously. The\n"
+              "                         results are reported in the same order as when the\n"
+              "                         configurations are checked one after another.\n"
               "    --dump               Dump xml data for each translation unit. The dump\n"
               "                         files have the extension .dump and contain ast,\n"
               "                         tokenlist, symboldatabase, valueflow.\n"
@@ -1031,6 +1090,15 @@ void CmdLineParser::printHelp()
               "                         provided. Note that your operating system can modify\n"
               "                         this value, e.g. '256' can become '0'.\n"
               "    --errorlist          Print a list of all the error messages in XML format.\n"
+#ifdef THREADING_MODEL_FORK
+              "    --executor=<type>    Specifies how the files are checked when -j is used:\n"
+              "                          * thread (default)\n"
+              "                                  Check the files in threads of the cppcheck\n"
+              "                                  process.\n"
+              "                          * process\n"
+              "                                  Check each file in a child process. Slower, but\n"
+              "                                  a crash only affects the file being checked.\n"
+#endif
               "    --exitcode-suppressions=<file>\n"
               "                         Used when certain messages should be displayed but\n"
               "                         should not cause a non-zero exitcode.\n"
@@ -1070,7 +1138,7 @@ void CmdLineParser::printHelp()
               "                         on the lines before the warning to suppress.\n"
               "    -j <jobs>            Start <jobs> threads to do the checking simultaneously.\n"
 #ifdef THREADING_MODEL_FORK
-              "    -l <load>            Specifies that no new threads should be started if\n"
+              "    -l <load>            Specifies that no new files should be started if\n"
               "                         there are other threads running and the load average is\n"
               "                         at least <load>.\n"
 #endif
@@ -1084,6 +1152,11 @@ void CmdLineParser::printHelp()
               "                         distributed with Cppcheck is loaded automatically.\n"
               "                         For more information about library files, read the\n"
               "                         manual.\n"
+              "    --library-cache-dir=<directory>\n"
+              "                         Cache the loaded library files in binary form in the\n"
+              "                         given directory. Later runs load the cached files\n"
+              "                         which is faster than reading the xml files. Changed\n"
+              "                         .cfg files are detected and loaded again.\n"
               "    --max-ctu-depth=N    Max depth in whole program analysis. The default value\n"
               "                         is 2. A larger value will mean more errors can be found\n"
               "                         but also means the analysis will be slower.\n"
@@ -1210,6 +1283,10 @@ void CmdLineParser::printHelp()
               "    -U<ID>               Undefine preprocessor symbol. Use -U to explicitly\n"
               "                         hide certain #ifdef <ID> code paths from checking.\n"
               "                         Example: '-UDEBUG'\n"
+              "    --valueflow-jobs=<jobs>\n"
+              "                         Start <jobs> threads to run the ValueFlow analysis of\n"
+              "                         the functions of a file simultaneously. Useful for\n"
+              "                         files with very many functions.\n"
               "    -v, --verbose        Output more detailed error information.\n"
               "    --version            Print out version number.\n"
               "    --xml                Write results in xml format to error stream (stderr).\n"
@@ -23,6 +23,7 @@
 #include "config.h"
 #include "cppcheck.h"
 #include "filelister.h"
+#include "headercache.h"
 #include "importproject.h"
 #include "library.h"
 #include "path.h"
@@ -61,6 +62,15 @@
 #endif
 #endif
 
+#if defined(THREADING_MODEL_FORK)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #if !defined(NO_UNIX_BACKTRACE_SUPPORT) && defined(USE_UNIX_SIGNAL_HANDLING) && defined(__GNUC__) && defined(__GLIBC__) && !defined(__CYGWIN__) && !defined(__MINGW32__) && !defined(__NetBSD__) && !defined(__SVR4) && !defined(__QNX__)
 #define USE_UNIX_BACKTRACE_SUPPORT
 #include <cxxabi.h>
@@ -211,6 +221,7 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
     CheckUnusedFunctions::clear();
 
     CppCheck cppCheck(*this, true, executeCommand);
+    cppCheck.setAddonServerCallback(startAddonServer);
 
     const Settings& settings = cppCheck.settings();
     mSettings = &settings;
@@ -231,6 +242,12 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
     else
         ret = check_internal(cppCheck, argc, argv);
 
+    CppCheck::printTimerResults(settings.showtime);
+    if (settings.showtime != SHOWTIME_MODES::SHOWTIME_NONE) {
+        const HeaderCache &headerCache = HeaderCache::instance();
+        std::cout << "Header cache: " << headerCache.hits() << " hit(s), " << headerCache.misses() << " miss(es)" << std::endl;
+    }
+
     mSettings = nullptr;
     return ret;
 }
@@ -847,6 +864,17 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
 {
     Settings& settings = cppcheck.settings();
     mSettings = &settings;
+
+    if (!settings.library.cacheDir().empty()) {
+        std::list<std::string> libraries(1, "std.cfg");
+        libraries.insert(libraries.end(), settings.libraries.begin(), settings.libraries.end());
+        if (settings.posix())
+            libraries.emplace_back("posix.cfg");
+        if (settings.isWindowsPlatform())
+            libraries.emplace_back("windows.cfg");
+        settings.library.loadCache(argv[0], libraries);
+    }
+
     const bool std = tryLoadLibrary(settings.library, argv[0], "std.cfg");
 
     for (const std::string &lib : settings.libraries) {
@@ -957,6 +985,8 @@ int CppCheckExecutor::check_internal(CppCheck& cppcheck, int /*argc*/, const cha
         // Multiple processes
         ThreadExecutor executor(mFiles, settings, *this);
         returnValue = executor.check();
+        if (settings.buildDir.empty() && cppcheck.analyseWholeProgram(executor.getFileInfo()))
+            returnValue++;
     }
 
     cppcheck.analyseWholeProgram(mSettings->buildDir, mFiles);
@@ -1034,10 +1064,9 @@ static inline std::string ansiToOEM(const std::string &msg, bool doConvert)
 void CppCheckExecutor::reportErr(const std::string &errmsg)
 {
     // Alert only about unique errors
-    if (mShownErrors.find(errmsg) != mShownErrors.end())
+    if (!mShownErrors.insert(errmsg))
         return;
 
-    mShownErrors.insert(errmsg);
     if (mErrorOutput)
         *mErrorOutput << errmsg << std::endl;
     else {
@@ -1200,3 +1229,133 @@ bool CppCheckExecutor::executeCommand(std::string exe, std::vector<std::string>
     return true;
 }
 
+#if defined(THREADING_MODEL_FORK)
+namespace {
+    /** An addon server in a child process, the requests and the output are sent through a socket pair */
+    class AddonServerProcess : public AddonServer {
+    public:
+        AddonServerProcess(pid_t pid, int fd) : mPid(pid), mFd(fd) {}
+
+        ~AddonServerProcess() OVERRIDE {
+            // An empty line stops the server
+            send("\n");
+            close(mFd);
+            waitpid(mPid, nullptr, 0);
+        }
+
+        bool execute(const std::string &dumpFile, std::string *output) OVERRIDE {
+            static const std::string doneMarker("\n@@cppcheck-addon-done@@\n");
+            output->clear();
+            if (!send(dumpFile + '\n'))
+                return false;
+            char buffer[4096];
+            while (!endsWith(*output, doneMarker.c_str(), doneMarker.size())) {
+                const ssize_t bytesRead = read(mFd, buffer, sizeof(buffer));
+                if (bytesRead < 0 && errno == EINTR)
+                    continue;
+                if (bytesRead <= 0)
+                    return false;
+                output->append(buffer, bytesRead);
+            }
+            output->resize(output->size() + 1 - doneMarker.size());
+            return true;
+        }
+
+    private:
+        bool send(const std::string &data) {
+            for (std::size_t pos = 0; pos < data.size();) {
+#ifdef MSG_NOSIGNAL
+                const ssize_t bytesWritten = ::send(mFd, data.data() + pos, data.size() - pos, MSG_NOSIGNAL);
+#else
+                const ssize_t bytesWritten = ::send(mFd, data.data() + pos, data.size() - pos, 0);
+#endif
+                if (bytesWritten < 0 && errno == EINTR)
+                    continue;
+                if (bytesWritten <= 0)
+                    return false;
+                pos += bytesWritten;
+            }
+            return true;
+        }
+
+        const pid_t mPid;
+        const int mFd;
+    };
+}
+#endif
+
+#if defined(THREADING_MODEL_FORK)
+/** Find @p exe in PATH like execvp() does, the file name is returned as is if it is not found */
+static std::string findExecutable(const std::string &exe)
+{
+    const char *env = std::getenv("PATH");
+    if (exe.find('/') != std::string::npos || !env)
+        return exe;
+    const std::string path(env);
+    std::string::size_type start = 0;
+    for (;;) {
+        const std::string::size_type end = path.find(':', start);
+        const std::string dir = path.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        const std::string fileName = (dir.empty() ? std::string(".") : dir) + '/' + exe;
+        struct stat st;
+        if (stat(fileName.c_str(), &st) == 0 && S_ISREG(st.st_mode) && access(fileName.c_str(), X_OK) == 0)
+            return fileName;
+        if (end == std::string::npos)
+            return exe;
+        start = end + 1;
+    }
+}
+#endif
+
+std::unique_ptr<AddonServer> CppCheckExecutor::startAddonServer(const std::string &exe, const std::vector<std::string> &args)
+{
+#if defined(THREADING_MODEL_FORK)
+    // The servers are started from the threads of the ThreadExecutor, so
+    // only async-signal-safe functions may be called in the child. The
+    // executable is looked up and the arguments are prepared before the
+    // fork, the child only calls dup2(), execv() and _exit().
+    const std::string fileName = findExecutable(exe);
+    std::vector<char *> argv;
+    argv.push_back(const_cast<char *>(exe.c_str()));
+    for (const std::string &arg : args)
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    argv.push_back(nullptr);
+
+    // Other servers that are started in parallel must not inherit the socket
+    int fds[2];
+#ifdef SOCK_CLOEXEC
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0)
+        return std::unique_ptr<AddonServer>();
+#else
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+        return std::unique_ptr<AddonServer>();
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+#ifdef SO_NOSIGPIPE
+    const int noSigPipe = 1;
+    setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+    const pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return std::unique_ptr<AddonServer>();
+    }
+    if (pid == 0) {
+        // stdin, stdout and stderr of the server
+        dup2(fds[1], 0);
+        dup2(fds[1], 1);
+        dup2(fds[1], 2);
+        execv(fileName.c_str(), argv.data());
+        _exit(127);
+    }
+    close(fds[1]);
+    return std::unique_ptr<AddonServer>(new AddonServerProcess(pid, fds[0]));
+#else
+    (void)exe;
+    (void)args;
+    return std::unique_ptr<AddonServer>();
+#endif
+}
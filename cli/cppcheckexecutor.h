@@ -24,9 +24,11 @@
 #include <cstdio>
 #include <ctime>
 #include <map>
-#include <set>
+#include <memory>
 #include <string>
+#include <vector>
 
+class AddonServer;
 class CppCheck;
 class Library;
 class Settings;
@@ -113,6 +115,14 @@ public:
      */
     static bool executeCommand(std::string exe, std::vector<std::string> args, std::string redirect, std::string *output);
 
+    /**
+     * Start an addon server process, it is stopped when the returned object is destroyed. Returns nullptr if
+     * the process could not be started or addon servers are not supported on this platform.
+     * This is called from the threads of the ThreadExecutor. The children of the process executor do not
+     * start addon servers.
+     */
+    static std::unique_ptr<AddonServer> startAddonServer(const std::string &exe, const std::vector<std::string> &args);
+
 protected:
 
     /**
@@ -172,7 +182,7 @@ private:
     /**
      * Used to filter out duplicate error messages.
      */
-    std::set<std::string> mShownErrors;
+    ReportedErrors mShownErrors;
 
     /**
      * Filename associated with size of file
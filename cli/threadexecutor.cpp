@@ -31,6 +31,7 @@
 #include <cstring>
 #include <iostream>
 #include <utility>
+#include <vector>
 
 #ifdef __SVR4  // Solaris
 #include <sys/loadavg.h>
@@ -40,9 +41,17 @@
 #include <sys/prctl.h>
 #endif
 #include <sys/select.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <fcntl.h>
 #include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <memory>
+#include <thread>
 #endif
 #ifdef THREADING_MODEL_WIN
 #include <process.h>
@@ -71,6 +80,13 @@ ThreadExecutor::~ThreadExecutor()
     //dtor
 }
 
+void ThreadExecutor::sortFileInfo()
+{
+    mFileInfo.sort([](const AnalyzerInformation::TranslationUnitInfo &a, const AnalyzerInformation::TranslationUnitInfo &b) {
+        return a.sourcefile < b.sourcefile || (a.sourcefile == b.sourcefile && a.cfg < b.cfg);
+    });
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////
 ////// This code is for platforms that support fork() only ////////////////////
@@ -83,65 +99,152 @@ void ThreadExecutor::addFileContent(const std::string &path, const std::string &
     mFileContents[ path ] = content;
 }
 
+// The pipe buffer of the child, so the messages in it can be written when
+// the child is terminated by a signal. The buffer holds complete messages
+// up to pipeBufferEnd, the bytes before pipeBufferWritten are in the pipe.
+static int pipeBufferFd = -1;
+static std::atomic<const char *> pipeBufferData(nullptr);
+static std::atomic<std::size_t> pipeBufferEnd(0);
+static std::atomic<std::size_t> pipeBufferWritten(0);
+
+// The signals that write the pipe buffer in the child, and their previous handlers
+static const int childSignals[] = { SIGABRT, SIGBUS, SIGFPE, SIGILL, SIGINT, SIGQUIT, SIGSEGV, SIGSYS, SIGTERM };
+static struct sigaction oldChildActions[sizeof(childSignals) / sizeof(childSignals[0])];
+
+// Only async-signal-safe functions are used here
+static void childSignalHandler(int signo, siginfo_t *info, void *context)
+{
+    const char * const data = pipeBufferData;
+    std::size_t pos = pipeBufferWritten;
+    const std::size_t end = pipeBufferEnd;
+    while (pos < end) {
+        const ssize_t n = write(pipeBufferFd, data + pos, end - pos);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR)
+                continue;
+            break;
+        }
+        pos += n;
+    }
+    pipeBufferWritten = pos;
+
+    // Let the previous handler terminate the child
+    for (std::size_t i = 0; i < sizeof(childSignals) / sizeof(childSignals[0]); ++i) {
+        if (childSignals[i] != signo)
+            continue;
+        const struct sigaction &old = oldChildActions[i];
+        if (old.sa_flags & SA_SIGINFO)
+            old.sa_sigaction(signo, info, context);
+        else if (old.sa_handler != SIG_DFL && old.sa_handler != SIG_IGN)
+            old.sa_handler(signo);
+        else if (old.sa_handler == SIG_DFL) {
+            // The signal is delivered again when this handler returns
+            sigaction(signo, &old, nullptr);
+            raise(signo);
+        }
+        break;
+    }
+}
+
+static void installChildSignalHandlers(int wpipe)
+{
+    pipeBufferFd = wpipe;
+
+    struct sigaction act;
+    std::memset(&act, 0, sizeof(act));
+    act.sa_flags = SA_SIGINFO | SA_ONSTACK;
+    act.sa_sigaction = childSignalHandler;
+    for (std::size_t i = 0; i < sizeof(childSignals) / sizeof(childSignals[0]); ++i)
+        sigaction(childSignals[i], &act, &oldChildActions[i]);
+}
+
 int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
 {
-    char type = 0;
-    if (read(rpipe, &type, 1) <= 0) {
-        if (errno == EAGAIN)
+    char buf[65536];
+    const ssize_t n = read(rpipe, buf, sizeof(buf));
+    if (n <= 0) {
+        if (n < 0 && (errno == EAGAIN || errno == EINTR))
             return 0;
-
+        mPipeData.erase(rpipe);
         return -1;
     }
 
-    if (type != REPORT_OUT && type != REPORT_ERROR && type != REPORT_INFO && type != CHILD_END) {
-        std::cerr << "#### ThreadExecutor::handleRead error, type was:" << type << std::endl;
-        std::exit(0);
-    }
-
-    unsigned int len = 0;
-    if (read(rpipe, &len, sizeof(len)) <= 0) {
-        std::cerr << "#### ThreadExecutor::handleRead error, type was:" << type << std::endl;
-        std::exit(0);
+    PipeData &pipeData = mPipeData[rpipe];
+    pipeData.buffer.append(buf, n);
+
+    // Handle the complete messages, the rest of a message might not be written yet
+    const std::size_t headerSize = 1 + sizeof(unsigned int);
+    std::size_t pos = 0;
+    while (pipeData.buffer.size() - pos >= headerSize) {
+        const char type = pipeData.buffer[pos];
+        unsigned int len = 0;
+        std::memcpy(&len, pipeData.buffer.data() + pos + 1, sizeof(len));
+        if (pipeData.buffer.size() - pos - headerSize < len)
+            break;
+        const char *data = pipeData.buffer.data() + pos + headerSize;
+        pos += headerSize + len;
+        if (!handleMessage(pipeData, type, data, len, result)) {
+            mPipeData.erase(rpipe);
+            return -1;
+        }
     }
+    pipeData.buffer.erase(0, pos);
 
-    // Don't rely on incoming data being null-terminated.
-    // Allocate +1 element and null-terminate the buffer.
-    char *buf = new char[len + 1];
-    const ssize_t readIntoBuf = read(rpipe, buf, len);
-    if (readIntoBuf <= 0) {
-        std::cerr << "#### ThreadExecutor::handleRead error, type was:" << type << std::endl;
-        std::exit(0);
-    }
-    buf[readIntoBuf] = 0;
+    return 1;
+}
 
-    if (type == REPORT_OUT) {
-        mErrorLogger.reportOut(buf);
-    } else if (type == REPORT_ERROR || type == REPORT_INFO) {
-        ErrorMessage msg;
-        msg.deserialize(buf);
+bool ThreadExecutor::handleMessage(PipeData &pipeData, char type, const char *data, std::size_t len, unsigned int &result)
+{
+    switch (type) {
+    case REPORT_OUT:
+        mErrorLogger.reportOut(std::string(data, len));
+        break;
+    case REPORT_VERIFICATION:
+        mErrorLogger.bughuntingReport(std::string(data, len));
+        break;
+    case REPORT_FILENAME:
+        pipeData.fileNames.emplace_back(data, len);
+        break;
+    case REPORT_ERROR:
+    case REPORT_INFO: {
+        const std::vector<std::string> &fileNames = pipeData.fileNames;
+        const auto getFileName = [&fileNames](long long index) -> const std::string * {
+            return (index >= 0 && index < static_cast<long long>(fileNames.size())) ? &fileNames[index] : nullptr;
+        };
+        AnalyzerInfoReader reader(data, len);
+        if (!mPipeMessage.deserialize(reader, getFileName)) {
+            std::cerr << "#### ThreadExecutor::handleRead error, invalid error message" << std::endl;
+            std::exit(0);
+        }
 
-        if (!mSettings.nomsg.isSuppressed(msg.toSuppressionsErrorMessage())) {
+        if (!mSettings.nomsg.isSuppressed(mPipeMessage.toSuppressionsErrorMessage())) {
             // Alert only about unique errors
-            std::string errmsg = msg.toString(mSettings.verbose);
-            if (std::find(mErrorList.begin(), mErrorList.end(), errmsg) == mErrorList.end()) {
-                mErrorList.emplace_back(errmsg);
+            if (mReportedErrors.insert(mPipeMessage.fingerprint(mSettings.verbose))) {
                 if (type == REPORT_ERROR)
-                    mErrorLogger.reportErr(msg);
+                    mErrorLogger.reportErr(mPipeMessage);
                 else
-                    mErrorLogger.reportInfo(msg);
+                    mErrorLogger.reportInfo(mPipeMessage);
             }
         }
-    } else if (type == CHILD_END) {
-        std::istringstream iss(buf);
+        break;
+    }
+    case REPORT_FILEINFO:
+        mFileInfo.emplace_back();
+        if (!mFileInfo.back().loadFromString(std::string(data, len)))
+            mFileInfo.pop_back();
+        break;
+    case CHILD_END: {
+        std::istringstream iss(std::string(data, len));
         unsigned int fileResult = 0;
         iss >> fileResult;
         result += fileResult;
-        delete [] buf;
-        return -1;
+        return false;
     }
-
-    delete [] buf;
-    return 1;
+    default:
+        std::cerr << "#### ThreadExecutor::handleRead error, type was:" << type << std::endl;
+        std::exit(0);
+    }
+    return true;
 }
 
 bool ThreadExecutor::checkLoadAverage(size_t nchildren)
@@ -165,8 +268,189 @@ bool ThreadExecutor::checkLoadAverage(size_t nchildren)
 }
 
 unsigned int ThreadExecutor::check()
+{
+    mFileInfo.clear();
+    const unsigned int result = (mSettings.executor == Settings::ExecutorType::Process) ? checkProcesses() : checkThreads();
+    sortFileInfo();
+    return result;
+}
+
+namespace {
+    /** A file from the file list or the project that shall be checked */
+    struct FileTask {
+        const std::string *file;
+        const ImportProject::FileSettings *fileSettings;
+        std::size_t size;
+    };
+
+    /**
+     * The files of one checking thread. The owner takes the largest
+     * file from the front, when its own queue is empty the thread steals
+     * the smallest file from the back of another queue.
+     */
+    class FileQueue {
+    public:
+        void push(const FileTask &task) {
+            mTasks.push_back(task);
+        }
+
+        bool pop(FileTask *task) {
+            std::lock_guard<std::mutex> lock(mSync);
+            if (mTasks.empty())
+                return false;
+            *task = mTasks.front();
+            mTasks.pop_front();
+            return true;
+        }
+
+        bool steal(FileTask *task) {
+            std::lock_guard<std::mutex> lock(mSync);
+            if (mTasks.empty())
+                return false;
+            *task = mTasks.back();
+            mTasks.pop_back();
+            return true;
+        }
+
+    private:
+        std::deque<FileTask> mTasks;
+        std::mutex mSync;
+    };
+}
+
+static std::size_t getFileSize(const std::string &filename)
+{
+    struct stat statBuf;
+    if (stat(filename.c_str(), &statBuf) != 0)
+        return 0;
+    return static_cast<std::size_t>(statBuf.st_size);
+}
+
+unsigned int ThreadExecutor::checkThreads()
 {
     mFileCount = 0;
+
+    std::vector<FileTask> tasks;
+    std::size_t totalfilesize = 0;
+    for (std::map<std::string, std::size_t>::const_iterator i = mFiles.begin(); i != mFiles.end(); ++i) {
+        tasks.push_back({&i->first, nullptr, i->second});
+        totalfilesize += i->second;
+    }
+    for (const ImportProject::FileSettings &fs : mSettings.project.fileSettings)
+        tasks.push_back({nullptr, &fs, getFileSize(fs.filename)});
+    if (tasks.empty())
+        return 0;
+
+    // Start with the largest files so a big file is not left for the end
+    std::stable_sort(tasks.begin(), tasks.end(), [](const FileTask &a, const FileTask &b) {
+        return a.size > b.size;
+    });
+
+    const std::size_t threadCount = std::min<std::size_t>(std::max(mSettings.jobs, 1U), tasks.size());
+    std::vector<FileQueue> queues(threadCount);
+    for (std::size_t i = 0; i < tasks.size(); ++i)
+        queues[i % threadCount].push(tasks[i]);
+
+    const std::size_t totalFiles = tasks.size();
+    std::size_t processedsize = 0;
+    std::atomic<std::size_t> busyThreads(0);
+    std::atomic<unsigned int> result(0);
+
+    const auto createFileChecker = [this]() {
+        std::unique_ptr<CppCheck> fileChecker;
+        {
+            // guard static members of CppCheck against concurrent access
+            std::lock_guard<std::mutex> lock(mReportSync);
+            fileChecker.reset(new CppCheck(*this, false, CppCheckExecutor::executeCommand));
+            fileChecker->setAddonServerCallback(CppCheckExecutor::startAddonServer);
+            fileChecker->settings() = mSettings;
+        }
+        if (mSettings.buildDir.empty()) {
+            fileChecker->setFileInfoCallback([this](const AnalyzerInformation::TranslationUnitInfo &fileInfo) {
+                std::lock_guard<std::mutex> lock(mFileInfoSync);
+                mFileInfo.push_back(fileInfo);
+            });
+        }
+        return fileChecker;
+    };
+
+    // An exception that escapes the checking is reported like a crashed child process
+    const auto reportInternalError = [this](const FileTask &task, const std::string &msg) {
+        std::list<ErrorMessage::FileLocation> locations;
+        locations.emplace_back(task.fileSettings ? (task.fileSettings->filename + ' ' + task.fileSettings->cfg) : *task.file, 0, 0);
+        const ErrorMessage errmsg(locations,
+                                  emptyString,
+                                  Severity::error,
+                                  "Internal error: Checking thread caught an exception: " + msg,
+                                  "cppcheckError",
+                                  false);
+        report(errmsg, MessageType::REPORT_ERROR);
+    };
+
+    const auto threadProc = [&](std::size_t queueIndex) {
+        std::unique_ptr<CppCheck> fileChecker = createFileChecker();
+
+        for (;;) {
+            // Do not start another file while the load average is too high
+            while (!checkLoadAverage(busyThreads))
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+
+            FileTask task = {nullptr, nullptr, 0};
+            bool found = queues[queueIndex].pop(&task);
+            for (std::size_t i = 1; !found && i < threadCount; ++i)
+                found = queues[(queueIndex + i) % threadCount].steal(&task);
+            if (!found)
+                break;
+
+            ++busyThreads;
+            unsigned int resultOfCheck = 0;
+            try {
+                if (task.fileSettings) {
+                    resultOfCheck = fileChecker->check(*task.fileSettings);
+                    if (mSettings.clangTidy)
+                        fileChecker->analyseClangTidy(*task.fileSettings);
+                } else {
+                    const std::map<std::string, std::string>::const_iterator fileContent = mFileContents.find(*task.file);
+                    if (fileContent != mFileContents.end()) {
+                        // File content was given as a string
+                        resultOfCheck = fileChecker->check(*task.file, fileContent->second);
+                    } else {
+                        // Read file from a file
+                        resultOfCheck = fileChecker->check(*task.file);
+                    }
+                }
+            } catch (const std::exception &e) {
+                reportInternalError(task, e.what());
+                fileChecker = createFileChecker();
+            } catch (...) {
+                reportInternalError(task, "unknown exception");
+                fileChecker = createFileChecker();
+            }
+            --busyThreads;
+            result += resultOfCheck;
+
+            std::lock_guard<std::mutex> lock(mReportSync);
+            mFileCount++;
+            if (!task.fileSettings)
+                processedsize += task.size;
+            if (!mSettings.quiet)
+                CppCheckExecutor::reportStatus(mFileCount, totalFiles, processedsize, totalfilesize);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < threadCount; ++i)
+        threads.emplace_back(threadProc, i);
+    for (std::thread &t : threads)
+        t.join();
+
+    return result;
+}
+
+unsigned int ThreadExecutor::checkProcesses()
+{
+    mFileCount = 0;
+    mPipeData.clear();
     unsigned int result = 0;
 
     std::size_t totalfilesize = 0;
@@ -213,8 +497,22 @@ unsigned int ThreadExecutor::check()
                 close(pipes[0]);
                 mWpipe = pipes[1];
 
+                // The messages are written to the pipe when the child is
+                // terminated by a signal. SIGKILL can not be handled, the
+                // messages in the buffer are lost then.
+                mPipeBuffer.reserve(2 * 65536);
+                installChildSignalHandlers(mWpipe);
+
+                // No addon servers are started in the child, the addons are
+                // run with executeCommand. The child checks a single file and
+                // ends with std::exit(), which would not stop the servers.
                 CppCheck fileChecker(*this, false, CppCheckExecutor::executeCommand);
                 fileChecker.settings() = mSettings;
+                if (mSettings.buildDir.empty()) {
+                    fileChecker.setFileInfoCallback([this](const AnalyzerInformation::TranslationUnitInfo &fileInfo) {
+                        writeToPipe(REPORT_FILEINFO, fileInfo.toString());
+                    });
+                }
                 unsigned int resultOfCheck = 0;
 
                 if (iFileSettings != mSettings.project.fileSettings.end()) {
@@ -226,6 +524,7 @@ unsigned int ThreadExecutor::check()
                     // Read file from a file
                     resultOfCheck = fileChecker.check(iFile->first);
                 }
+                flushPipe();
 
                 std::ostringstream oss;
                 oss << resultOfCheck;
@@ -324,39 +623,127 @@ unsigned int ThreadExecutor::check()
 
 void ThreadExecutor::writeToPipe(PipeSignal type, const std::string &data)
 {
-    unsigned int len = static_cast<unsigned int>(data.length() + 1);
-    char *out = new char[ len + 1 + sizeof(len)];
-    out[0] = static_cast<char>(type);
-    std::memcpy(&(out[1]), &len, sizeof(len));
-    std::memcpy(&(out[1+sizeof(len)]), data.c_str(), len);
-    if (write(mWpipe, out, len + 1 + sizeof(len)) <= 0) {
-        delete [] out;
-        out = nullptr;
-        std::cerr << "#### ThreadExecutor::writeToPipe, Failed to write to pipe" << std::endl;
-        std::exit(0);
+    const unsigned int len = static_cast<unsigned int>(data.length());
+    // The signal handler reads the buffer, so it is flushed instead of reallocated
+    if (mPipeBuffer.size() + 1 + sizeof(len) + data.size() > mPipeBuffer.capacity())
+        flushPipe();
+    mPipeBuffer += static_cast<char>(type);
+    mPipeBuffer.append(reinterpret_cast<const char *>(&len), sizeof(len));
+    mPipeBuffer += data;
+    pipeBufferData = mPipeBuffer.data();
+    pipeBufferEnd = mPipeBuffer.size();
+
+    if (mPipeBuffer.size() >= 65536 || (type != REPORT_ERROR && type != REPORT_INFO && type != REPORT_FILENAME))
+        flushPipe();
+}
+
+void ThreadExecutor::writeToPipe(PipeSignal type, const ErrorMessage &msg)
+{
+    AnalyzerInfoWriter writer;
+    msg.serialize(writer, [this](const std::string &fileName) {
+        const std::unordered_map<std::string, long long>::const_iterator it = mFileNameIndex.find(fileName);
+        if (it != mFileNameIndex.end())
+            return it->second;
+        const long long index = static_cast<long long>(mFileNameIndex.size());
+        mFileNameIndex.emplace(fileName, index);
+        writeToPipe(REPORT_FILENAME, fileName);
+        return index;
+    });
+    writeToPipe(type, writer.str());
+}
+
+void ThreadExecutor::flushPipe()
+{
+    // The signal handler must not write what is written here a second time
+    sigset_t asyncSignals;
+    sigset_t oldMask;
+    sigemptyset(&asyncSignals);
+    sigaddset(&asyncSignals, SIGINT);
+    sigaddset(&asyncSignals, SIGQUIT);
+    sigaddset(&asyncSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &asyncSignals, &oldMask);
+
+    const char *out = mPipeBuffer.data() + pipeBufferWritten;
+    std::size_t len = mPipeBuffer.size() - pipeBufferWritten;
+    while (len > 0) {
+        const ssize_t n = write(mWpipe, out, len);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR)
+                continue;
+            std::cerr << "#### ThreadExecutor::writeToPipe, Failed to write to pipe" << std::endl;
+            std::exit(0);
+        }
+        out += n;
+        len -= n;
+        pipeBufferWritten += n;
     }
+    pipeBufferEnd = 0;
+    pipeBufferWritten = 0;
+    mPipeBuffer.clear();
 
-    delete [] out;
+    pthread_sigmask(SIG_SETMASK, &oldMask, nullptr);
 }
 
 void ThreadExecutor::reportOut(const std::string &outmsg)
 {
-    writeToPipe(REPORT_OUT, outmsg);
+    if (mSettings.executor == Settings::ExecutorType::Process) {
+        writeToPipe(REPORT_OUT, outmsg);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mReportSync);
+    mErrorLogger.reportOut(outmsg);
 }
 
 void ThreadExecutor::reportErr(const ErrorMessage &msg)
 {
-    writeToPipe(REPORT_ERROR, msg.serialize());
+    if (mSettings.executor == Settings::ExecutorType::Process)
+        writeToPipe(REPORT_ERROR, msg);
+    else
+        report(msg, MessageType::REPORT_ERROR);
 }
 
 void ThreadExecutor::reportInfo(const ErrorMessage &msg)
 {
-    writeToPipe(REPORT_INFO, msg.serialize());
+    if (mSettings.executor == Settings::ExecutorType::Process)
+        writeToPipe(REPORT_INFO, msg);
+    else
+        report(msg, MessageType::REPORT_INFO);
 }
 
 void ThreadExecutor::bughuntingReport(const std::string &str)
 {
-    writeToPipe(REPORT_VERIFICATION, str.c_str());
+    if (mSettings.executor == Settings::ExecutorType::Process) {
+        writeToPipe(REPORT_VERIFICATION, str);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mReportSync);
+    mErrorLogger.bughuntingReport(str);
+}
+
+void ThreadExecutor::report(const ErrorMessage &msg, MessageType msgType)
+{
+    {
+        // the suppressions are updated when they are matched
+        std::lock_guard<std::mutex> lock(mErrorSync);
+        if (mSettings.nomsg.isSuppressed(msg.toSuppressionsErrorMessage()))
+            return;
+    }
+
+    // Alert only about unique errors
+    if (!mReportedErrors.insert(msg.fingerprint(mSettings.verbose)))
+        return;
+
+    std::lock_guard<std::mutex> lock(mReportSync);
+    switch (msgType) {
+    case MessageType::REPORT_ERROR:
+        mErrorLogger.reportErr(msg);
+        break;
+    case MessageType::REPORT_INFO:
+        mErrorLogger.reportInfo(msg);
+        break;
+    }
 }
 
 #elif defined(THREADING_MODEL_WIN)
@@ -370,6 +757,8 @@ unsigned int ThreadExecutor::check()
 {
     HANDLE *threadHandles = new HANDLE[mSettings.jobs];
 
+    mFileInfo.clear();
+
     mItNextFile = mFiles.begin();
     mItNextFileSettings = mSettings.project.fileSettings.begin();
 
@@ -384,6 +773,7 @@ unsigned int ThreadExecutor::check()
     InitializeCriticalSection(&mFileSync);
     InitializeCriticalSection(&mErrorSync);
     InitializeCriticalSection(&mReportSync);
+    InitializeCriticalSection(&mFileInfoSync);
 
     for (unsigned int i = 0; i < mSettings.jobs; ++i) {
         threadHandles[i] = (HANDLE)_beginthreadex(nullptr, 0, threadProc, this, 0, nullptr);
@@ -424,9 +814,12 @@ unsigned int ThreadExecutor::check()
     DeleteCriticalSection(&mFileSync);
     DeleteCriticalSection(&mErrorSync);
     DeleteCriticalSection(&mReportSync);
+    DeleteCriticalSection(&mFileInfoSync);
 
     delete[] threadHandles;
 
+    sortFileInfo();
+
     return result;
 }
 
@@ -443,6 +836,13 @@ unsigned int __stdcall ThreadExecutor::threadProc(void *args)
 
     CppCheck fileChecker(*threadExecutor, false, CppCheckExecutor::executeCommand);
     fileChecker.settings() = threadExecutor->mSettings;
+    if (threadExecutor->mSettings.buildDir.empty()) {
+        fileChecker.setFileInfoCallback([threadExecutor](const AnalyzerInformation::TranslationUnitInfo &fileInfo) {
+            EnterCriticalSection(&threadExecutor->mFileInfoSync);
+            threadExecutor->mFileInfo.push_back(fileInfo);
+            LeaveCriticalSection(&threadExecutor->mFileInfoSync);
+        });
+    }
 
     for (;;) {
         if (itFile == threadExecutor->mFiles.end() && itFileSettings == threadExecutor->mSettings.project.fileSettings.end()) {
@@ -513,19 +913,15 @@ void ThreadExecutor::bughuntingReport(const std::string  &/*str*/)
 
 void ThreadExecutor::report(const ErrorMessage &msg, MessageType msgType)
 {
-    if (mSettings.nomsg.isSuppressed(msg.toSuppressionsErrorMessage()))
+    // the suppressions are updated when they are matched
+    EnterCriticalSection(&mErrorSync);
+    const bool suppressed = mSettings.nomsg.isSuppressed(msg.toSuppressionsErrorMessage());
+    LeaveCriticalSection(&mErrorSync);
+    if (suppressed)
         return;
 
     // Alert only about unique errors
-    bool reportError = false;
-    const std::string errmsg = msg.toString(mSettings.verbose);
-
-    EnterCriticalSection(&mErrorSync);
-    if (std::find(mErrorList.begin(), mErrorList.end(), errmsg) == mErrorList.end()) {
-        mErrorList.emplace_back(errmsg);
-        reportError = true;
-    }
-    LeaveCriticalSection(&mErrorSync);
+    const bool reportError = mReportedErrors.insert(msg.fingerprint(mSettings.verbose));
 
     if (reportError) {
         EnterCriticalSection(&mReportSync);
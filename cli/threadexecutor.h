@@ -19,6 +19,7 @@
 #ifndef THREADEXECUTOR_H
 #define THREADEXECUTOR_H
 
+#include "analyzerinfo.h"
 #include "config.h"
 #include "errorlogger.h"
 
@@ -26,9 +27,12 @@
 #include <list>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #if (defined(__GNUC__) || defined(__sun)) && !defined(__MINGW32__) && !defined(__CYGWIN__)
 #define THREADING_MODEL_FORK
+#include <mutex>
 #elif defined(_WIN32)
 #define THREADING_MODEL_WIN
 #include <windows.h>
@@ -43,7 +47,8 @@ class Settings;
 
 /**
  * This class will take a list of filenames and settings and check then
- * all files using threads.
+ * all files using threads. On platforms that support fork() the files
+ * can also be checked in child processes (--executor=process).
  */
 class ThreadExecutor : public ErrorLogger {
 public:
@@ -67,32 +72,82 @@ public:
      */
     void addFileContent(const std::string &path, const std::string &content);
 
+    /**
+     * @brief The data for whole program analysis of the checked files, sorted
+     * by file name. It is only collected when there is no build dir.
+     */
+    const std::list<AnalyzerInformation::TranslationUnitInfo> &getFileInfo() const {
+        return mFileInfo;
+    }
+
 private:
     const std::map<std::string, std::size_t> &mFiles;
     Settings &mSettings;
     ErrorLogger &mErrorLogger;
     unsigned int mFileCount;
+    std::list<AnalyzerInformation::TranslationUnitInfo> mFileInfo;
+
+    /** @brief Used to report each error only once */
+    ReportedErrors mReportedErrors;
+
+    /** @brief Sort the collected file info so the results don't depend on the order the files were checked in */
+    void sortFileInfo();
 
 #if defined(THREADING_MODEL_FORK)
 
     /** @brief Key is file name, and value is the content of the file */
     std::map<std::string, std::string> mFileContents;
 private:
-    enum PipeSignal {REPORT_OUT='1',REPORT_ERROR='2', REPORT_INFO='3', REPORT_VERIFICATION='4', CHILD_END='5'};
+    enum PipeSignal {REPORT_OUT='1',REPORT_ERROR='2', REPORT_INFO='3', REPORT_VERIFICATION='4', CHILD_END='5', REPORT_FILEINFO='6', REPORT_FILENAME='7'};
+
+    /** @brief Data read from a child that is not handled yet, and the file names that the child has sent */
+    struct PipeData {
+        std::string buffer;
+        std::vector<std::string> fileNames;
+    };
+
+    /** @brief Key is the read end of the pipe of a child */
+    std::map<int, PipeData> mPipeData;
+
+    /** @brief The error messages from the children are decoded into this object, it is reused to avoid allocations */
+    ErrorMessage mPipeMessage;
 
     /**
      * Read from the pipe, parse and handle what ever is in there.
-     *@return -1 in case of error
+     *@return -1 in case of error or when the child has ended
      *         0 if there is nothing in the pipe to be read
      *         1 if we did read something
      */
     int handleRead(int rpipe, unsigned int &result);
+
+    /**
+     * Handle a message from a child.
+     * @return false if the child has ended
+     */
+    bool handleMessage(PipeData &pipeData, char type, const char *data, std::size_t len, unsigned int &result);
+
+    /**
+     * Write a message to the pipe. The error messages are collected and
+     * written in batches, the other messages are written at once.
+     */
     void writeToPipe(PipeSignal type, const std::string &data);
+
+    /** @brief Write an error message to the pipe, the file names are sent once and then referred to by number */
+    void writeToPipe(PipeSignal type, const ErrorMessage &msg);
+
+    /** @brief Write the collected messages to the pipe */
+    void flushPipe();
+
+    /** @brief Messages that are not written to the pipe yet. Not used in master process. */
+    std::string mPipeBuffer;
+
+    /** @brief Numbers of the file names that have been sent to the master process. Not used in master process. */
+    std::unordered_map<std::string, long long> mFileNameIndex;
+
     /**
      * Write end of status pipe, different for each child.
      * Not used in master process.
      */
-    std::list<std::string> mErrorList;
     int mWpipe;
 
     /**
@@ -102,6 +157,26 @@ private:
      */
     bool checkLoadAverage(size_t nchildren);
 
+    /** @brief Check the files in threads of this process (--executor=thread) */
+    unsigned int checkThreads();
+
+    /** @brief Check each file in a child process (--executor=process) */
+    unsigned int checkProcesses();
+
+    enum class MessageType {REPORT_ERROR, REPORT_INFO};
+
+    /** @brief Report error or information from a checking thread */
+    void report(const ErrorMessage &msg, MessageType msgType);
+
+    /** @brief Guards the suppressions when threads are used */
+    std::mutex mErrorSync;
+
+    /** @brief Guards mErrorLogger and the status when threads are used */
+    std::mutex mReportSync;
+
+    /** @brief Guards mFileInfo when threads are used */
+    std::mutex mFileInfoSync;
+
 public:
     /**
      * @return true if support for threads exist.
@@ -124,11 +199,12 @@ private:
     std::size_t mTotalFileSize;
     CRITICAL_SECTION mFileSync;
 
-    std::list<std::string> mErrorList;
     CRITICAL_SECTION mErrorSync;
 
     CRITICAL_SECTION mReportSync;
 
+    CRITICAL_SECTION mFileInfoSync;
+
     void report(const ErrorMessage &msg, MessageType msgType);
 
     static unsigned __stdcall threadProc(void*);
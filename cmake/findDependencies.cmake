@@ -6,6 +6,8 @@ if (BUILD_GUI)
     endif()
 endif()
 
+find_package(Threads REQUIRED)
+
 if (HAVE_RULES)
     find_library(PCRE_LIBRARY pcre)
     if (NOT PCRE_LIBRARY)
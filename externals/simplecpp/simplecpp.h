@@ -298,7 +298,27 @@ namespace simplecpp {
         std::list<std::string> includes;
     };
 
-    SIMPLECPP_LIB std::map<std::string, TokenList*> load(const TokenList &rawtokens, std::vector<std::string> &filenames, const DUI &dui, OutputList *outputList = NULL);
+    /**
+     * Creates the TokenList of a file that is loaded by simplecpp::load().
+     * Can be overridden to reuse the tokens of files that are included by
+     * several translation units.
+     */
+    class SIMPLECPP_LIB FileReader {
+    public:
+        virtual ~FileReader() {}
+
+        /**
+         * @param istr the opened file
+         * @param filenames internal data of simplecpp
+         * @param filename name of the file
+         * @param outputList output: list that will receive output messages
+         */
+        virtual TokenList *read(std::istream &istr, std::vector<std::string> &filenames, const std::string &filename, OutputList *outputList) {
+            return new TokenList(istr, filenames, filename, outputList);
+        }
+    };
+
+    SIMPLECPP_LIB std::map<std::string, TokenList*> load(const TokenList &rawtokens, std::vector<std::string> &filenames, const DUI &dui, OutputList *outputList = NULL, FileReader *fileReader = NULL);
 
     /**
      * Preprocess
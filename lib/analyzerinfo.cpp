@@ -22,10 +22,18 @@
 #include "path.h"
 #include "utils.h"
 
-#include <tinyxml2.h>
+#include <algorithm>
 #include <cstring>
+#include <ctime>
+#include <istream>
+#include <iterator>
 #include <map>
-#include <sstream>
+#include <mutex>
+#include <set>
+#include <utility>
+
+#include <sys/stat.h>
+#include <sys/types.h>
 
 AnalyzerInformation::~AnalyzerInformation()
 {
@@ -44,6 +52,66 @@ static std::string getFilename(const std::string &fullpath)
     return fullpath.substr(pos1,pos2);
 }
 
+static std::string getManifestKey(const std::string &sourcefile, const std::string &cfg)
+{
+    return cfg + ':' + sourcefile;
+}
+
+const AnalyzerInformation::FileEntry *AnalyzerInformation::Manifest::find(const std::string &sourcefile, const std::string &cfg) const
+{
+    const std::unordered_map<std::string, std::size_t>::const_iterator it = mIndex.find(getManifestKey(sourcefile, cfg));
+    return (it != mIndex.end()) ? &files[it->second] : nullptr;
+}
+
+namespace {
+    struct CachedManifest {
+        std::time_t mtime;
+        long long size;
+        std::shared_ptr<const AnalyzerInformation::Manifest> manifest;
+    };
+}
+
+static std::mutex manifestMutex;
+static std::map<std::string, CachedManifest> manifests;
+
+std::shared_ptr<const AnalyzerInformation::Manifest> AnalyzerInformation::getManifest(const std::string &buildDir)
+{
+    const std::string filesTxt(buildDir + "/files.txt");
+    struct stat statBuf;
+    if (stat(filesTxt.c_str(), &statBuf) != 0)
+        return std::make_shared<const Manifest>();
+
+    {
+        std::lock_guard<std::mutex> lock(manifestMutex);
+        const std::map<std::string, CachedManifest>::const_iterator it = manifests.find(buildDir);
+        if (it != manifests.end() && it->second.mtime == statBuf.st_mtime && it->second.size == statBuf.st_size)
+            return it->second.manifest;
+    }
+
+    std::shared_ptr<Manifest> manifest = std::make_shared<Manifest>();
+    std::ifstream fin(filesTxt);
+    std::string line;
+    while (std::getline(fin, line)) {
+        const std::string::size_type firstColon = line.find(':');
+        if (firstColon == std::string::npos || firstColon == 0)
+            continue;
+        const std::string::size_type secondColon = line.find(':', firstColon + 1);
+        if (secondColon == std::string::npos || secondColon + 1 == line.size())
+            continue;
+        FileEntry entry;
+        entry.analyzerInfoFile = line.substr(0, firstColon);
+        entry.cfg = line.substr(firstColon + 1, secondColon - firstColon - 1);
+        entry.sourcefile = line.substr(secondColon + 1);
+        // When a file is listed several times the first entry is found
+        manifest->mIndex.emplace(line.substr(firstColon + 1), manifest->files.size());
+        manifest->files.push_back(std::move(entry));
+    }
+
+    std::lock_guard<std::mutex> lock(manifestMutex);
+    manifests[buildDir] = CachedManifest{statBuf.st_mtime, statBuf.st_size, manifest};
+    return manifest;
+}
+
 void AnalyzerInformation::writeFilesTxt(const std::string &buildDir, const std::list<std::string> &sourcefiles, const std::list<ImportProject::FileSettings> &fileSettings)
 {
     std::map<std::string, unsigned int> fileCount;
@@ -59,57 +127,342 @@ void AnalyzerInformation::writeFilesTxt(const std::string &buildDir, const std::
         const std::string afile = getFilename(fs.filename);
         fout << afile << ".a" << (++fileCount[afile]) << ":" << fs.cfg << ":" << Path::simplifyPath(Path::fromNativeSeparators(fs.filename)) << std::endl;
     }
+    fout.close();
+
+    // The file might be rewritten within the resolution of the modification time
+    std::lock_guard<std::mutex> lock(manifestMutex);
+    manifests.erase(buildDir);
+}
+
+// The analyzer information file starts with a fixed size header so the
+// checksum can be compared without reading the whole file:
+//   "CPPCHKAI", format version (4 bytes), checksum (8 bytes)
+// It is followed by records that are written with the AnalyzerInfoWriter:
+//   record type, record data
+static const char FILE_MAGIC[] = "CPPCHKAI";
+static const unsigned int FILE_VERSION = 1;
+static const std::size_t MAGIC_SIZE = sizeof(FILE_MAGIC) - 1;
+static const std::size_t HEADER_SIZE = MAGIC_SIZE + 4 + 8;
+
+enum RecordType { RECORD_END, RECORD_ERROR, RECORD_FILEINFO, RECORD_DEPENDENCIES };
+
+void AnalyzerInfoWriter::writeInt(long long value)
+{
+    // zigzag encoding so small negative values are small, then 7 bits per byte
+    unsigned long long v = (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63);
+    while (v >= 0x80) {
+        mData += static_cast<char>((v & 0x7f) | 0x80);
+        v >>= 7;
+    }
+    mData += static_cast<char>(v);
+}
+
+void AnalyzerInfoWriter::writeString(const std::string &str)
+{
+    writeInt(static_cast<long long>(str.size()));
+    mData += str;
+}
+
+long long AnalyzerInfoReader::readInt()
+{
+    unsigned long long v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (mPos == mEnd) {
+            mError = true;
+            return 0;
+        }
+        const unsigned char c = static_cast<unsigned char>(*mPos++);
+        v |= static_cast<unsigned long long>(c & 0x7f) << shift;
+        if ((c & 0x80) == 0)
+            return static_cast<long long>(v >> 1) ^ -static_cast<long long>(v & 1);
+    }
+    mError = true;
+    return 0;
+}
+
+std::string AnalyzerInfoReader::readString()
+{
+    std::string str;
+    readString(str);
+    return str;
+}
+
+void AnalyzerInfoReader::readString(std::string &str)
+{
+    const long long size = readInt();
+    if (mError || size < 0 || size > mEnd - mPos) {
+        mError = true;
+        mPos = mEnd;
+        str.clear();
+        return;
+    }
+    str.assign(mPos, static_cast<std::size_t>(size));
+    mPos += size;
+}
+
+static void writeRecord(std::ostream &ostr, RecordType type, const std::string &data)
+{
+    AnalyzerInfoWriter writer;
+    writer.writeInt(type);
+    writer.writeString(data);
+    ostr << writer.str();
 }
 
 void AnalyzerInformation::close()
 {
     mAnalyzerInfoFile.clear();
     if (mOutputStream.is_open()) {
-        mOutputStream << "</analyzerinfo>\n";
+        writeRecord(mOutputStream, RECORD_END, std::string());
         mOutputStream.close();
     }
 }
 
+// Read the header of an analyzer information file
+static bool readHeader(std::istream &istr, unsigned long long *checksum, char *header = nullptr)
+{
+    char buf[HEADER_SIZE];
+    if (!header)
+        header = buf;
+    if (!istr.read(header, HEADER_SIZE) || std::memcmp(header, FILE_MAGIC, MAGIC_SIZE) != 0)
+        return false;
+    unsigned int version = 0;
+    for (int i = 3; i >= 0; --i)
+        version = (version << 8) | static_cast<unsigned char>(header[MAGIC_SIZE + i]);
+    if (version != FILE_VERSION)
+        return false;
+    *checksum = 0;
+    for (int i = 7; i >= 0; --i)
+        *checksum = (*checksum << 8) | static_cast<unsigned char>(header[MAGIC_SIZE + 4 + i]);
+    return true;
+}
+
+// Read the records of an analyzer information file. The records are only
+// used if the file is complete.
+static bool readRecords(std::istream &istr, std::list<std::pair<int, std::string>> *records)
+{
+    const std::string data((std::istreambuf_iterator<char>(istr)), std::istreambuf_iterator<char>());
+    AnalyzerInfoReader reader(data);
+    while (!reader.atEnd()) {
+        const int type = static_cast<int>(reader.readInt());
+        std::string recordData = reader.readString();
+        if (reader.error())
+            return false;
+        if (type == RECORD_END)
+            return true;
+        records->emplace_back(type, std::move(recordData));
+    }
+    return false;
+}
+
+static bool loadErrors(const std::list<std::pair<int, std::string>> &records, std::list<ErrorMessage> *errors)
+{
+    std::list<ErrorMessage> fileErrors;
+    for (const std::pair<int, std::string> &record : records) {
+        if (record.first != RECORD_ERROR)
+            continue;
+        fileErrors.emplace_back();
+        try {
+            if (!fileErrors.back().deserialize(record.second))
+                return false;
+        } catch (const InternalError &) {
+            return false;
+        }
+    }
+
+    errors->splice(errors->end(), fileErrors);
+    return true;
+}
+
 static bool skipAnalysis(const std::string &analyzerInfoFile, unsigned long long checksum, std::list<ErrorMessage> *errors)
 {
-    tinyxml2::XMLDocument doc;
-    const tinyxml2::XMLError error = doc.LoadFile(analyzerInfoFile.c_str());
-    if (error != tinyxml2::XML_SUCCESS)
+    std::ifstream fin(analyzerInfoFile, std::ios::binary);
+    unsigned long long fileChecksum = 0;
+    if (!readHeader(fin, &fileChecksum) || fileChecksum != checksum)
+        return false;
+
+    std::list<std::pair<int, std::string>> records;
+    return readRecords(fin, &records) && loadErrors(records, errors);
+}
+
+namespace {
+    struct FileStat {
+        long long size;
+        long long mtime;
+        long long inode;
+    };
+}
+
+static bool getFileStat(const std::string &filename, FileStat *fileStat)
+{
+    struct stat statBuf;
+    if (stat(filename.c_str(), &statBuf) != 0)
+        return false;
+    fileStat->size = statBuf.st_size;
+    fileStat->mtime = statBuf.st_mtime;
+    fileStat->inode = statBuf.st_ino;
+    return true;
+}
+
+void AnalyzerInformation::setDependencies(unsigned long long settingsChecksum, const std::vector<std::string> &files, const std::set<std::string> &missedFiles, std::time_t analysisStart)
+{
+    if (mAnalyzerInfoFile.empty())
+        return;
+
+    AnalyzerInfoWriter writer;
+    writer.writeInt(static_cast<long long>(settingsChecksum));
+    writer.writeInt(static_cast<long long>(files.size()));
+    for (const std::string &f : files) {
+        FileStat fileStat;
+        // A file that is modified in the same second as it is read might be
+        // changed again without changing the modification time
+        if (!getFileStat(f, &fileStat) || fileStat.mtime >= analysisStart)
+            return;
+        writer.writeString(f);
+        writer.writeInt(fileStat.size);
+        writer.writeInt(fileStat.mtime);
+        writer.writeInt(fileStat.inode);
+    }
+    writer.writeInt(static_cast<long long>(missedFiles.size()));
+    for (const std::string &f : missedFiles) {
+        // The file has been created after it was looked for
+        if (Path::fileExists(f))
+            return;
+        writer.writeString(f);
+    }
+
+    if (mOutputStream.is_open()) {
+        writeRecord(mOutputStream, RECORD_DEPENDENCIES, writer.str());
+        return;
+    }
+
+    // The analysis was skipped, update the saved files
+    std::ifstream fin(mAnalyzerInfoFile, std::ios::binary);
+    char header[HEADER_SIZE];
+    unsigned long long checksum = 0;
+    std::list<std::pair<int, std::string>> records;
+    if (!readHeader(fin, &checksum, header) || !readRecords(fin, &records))
+        return;
+    fin.close();
+    const std::list<std::pair<int, std::string>>::iterator it = std::find_if(records.begin(), records.end(), [](const std::pair<int, std::string> &record) {
+        return record.first == RECORD_DEPENDENCIES;
+    });
+    if (it == records.end() || it->second == writer.str())
+        return;
+    it->second = writer.str();
+
+    std::ofstream fout(mAnalyzerInfoFile, std::ios::binary);
+    fout.write(header, HEADER_SIZE);
+    for (const std::pair<int, std::string> &record : records)
+        writeRecord(fout, static_cast<RecordType>(record.first), record.second);
+    writeRecord(fout, RECORD_END, std::string());
+}
+
+bool AnalyzerInformation::isUnchanged(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg, unsigned long long settingsChecksum, std::list<ErrorMessage> *errors)
+{
+    if (buildDir.empty() || sourcefile.empty())
         return false;
 
-    const tinyxml2::XMLElement * const rootNode = doc.FirstChildElement();
-    if (rootNode == nullptr)
+    std::ifstream fin(getAnalyzerInfoFile(buildDir, sourcefile, cfg), std::ios::binary);
+    unsigned long long checksum = 0;
+    std::list<std::pair<int, std::string>> records;
+    if (!readHeader(fin, &checksum) || !readRecords(fin, &records))
         return false;
 
-    const char *attr = rootNode->Attribute("checksum");
-    if (!attr || attr != std::to_string(checksum))
+    const std::list<std::pair<int, std::string>>::const_iterator it = std::find_if(records.cbegin(), records.cend(), [](const std::pair<int, std::string> &record) {
+        return record.first == RECORD_DEPENDENCIES;
+    });
+    if (it == records.cend())
         return false;
 
-    for (const tinyxml2::XMLElement *e = rootNode->FirstChildElement(); e; e = e->NextSiblingElement()) {
-        if (std::strcmp(e->Name(), "error") == 0)
-            errors->emplace_back(e);
+    AnalyzerInfoReader reader(it->second);
+    if (static_cast<unsigned long long>(reader.readInt()) != settingsChecksum)
+        return false;
+    for (long long count = reader.readInt(); count > 0; --count) {
+        const std::string filename = reader.readString();
+        FileStat fileStat;
+        if (reader.error() || !getFileStat(filename, &fileStat))
+            return false;
+        if (reader.readInt() != fileStat.size || reader.readInt() != fileStat.mtime || reader.readInt() != fileStat.inode)
+            return false;
+    }
+    // A new file could be included instead of a saved file
+    for (long long count = reader.readInt(); count > 0; --count) {
+        const std::string filename = reader.readString();
+        if (reader.error() || Path::fileExists(filename))
+            return false;
     }
 
+    return !reader.error() && loadErrors(records, errors);
+}
+
+bool AnalyzerInformation::loadFileInfo(const std::string &analyzerInfoFile, std::list<std::pair<std::string, std::string>> *fileInfo)
+{
+    std::ifstream fin(analyzerInfoFile, std::ios::binary);
+    unsigned long long checksum = 0;
+    std::list<std::pair<int, std::string>> records;
+    if (!readHeader(fin, &checksum) || !readRecords(fin, &records))
+        return false;
+
+    for (const std::pair<int, std::string> &record : records) {
+        if (record.first != RECORD_FILEINFO)
+            continue;
+        AnalyzerInfoReader reader(record.second);
+        std::string check = reader.readString();
+        std::string data = reader.readString();
+        if (!reader.error())
+            fileInfo->emplace_back(std::move(check), std::move(data));
+    }
     return true;
 }
 
-std::string AnalyzerInformation::getAnalyzerInfoFile(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg)
+std::string AnalyzerInformation::TranslationUnitInfo::toString() const
 {
-    const std::string files(buildDir + "/files.txt");
-    std::ifstream fin(files);
-    if (fin.is_open()) {
-        std::string line;
-        const std::string end(':' + cfg + ':' + sourcefile);
-        while (std::getline(fin,line)) {
-            if (line.size() <= end.size() + 2U)
-                continue;
-            if (!endsWith(line, end.c_str(), end.size()))
-                continue;
-            std::ostringstream ostr;
-            ostr << buildDir << '/' << line.substr(0,line.find(':'));
-            return ostr.str();
-        }
+    AnalyzerInfoWriter writer;
+    writer.writeString(sourcefile);
+    writer.writeString(cfg);
+    writer.writeInt(fileInfo.size());
+    for (const std::pair<std::string, std::string> &fi : fileInfo) {
+        writer.writeString(fi.first);
+        writer.writeString(fi.second);
     }
+    return writer.str();
+}
+
+bool AnalyzerInformation::TranslationUnitInfo::loadFromString(const std::string &data)
+{
+    AnalyzerInfoReader reader(data);
+    sourcefile = reader.readString();
+    cfg = reader.readString();
+    fileInfo.clear();
+    for (long long count = reader.readInt(); count > 0 && !reader.error(); --count) {
+        std::string check = reader.readString();
+        std::string info = reader.readString();
+        fileInfo.emplace_back(std::move(check), std::move(info));
+    }
+    return !reader.error() && reader.atEnd();
+}
+
+std::list<AnalyzerInformation::TranslationUnitInfo> AnalyzerInformation::loadAllFileInfo(const std::string &buildDir)
+{
+    std::list<TranslationUnitInfo> result;
+    const std::shared_ptr<const Manifest> manifest = getManifest(buildDir);
+    for (const FileEntry &entry : manifest->files) {
+        TranslationUnitInfo tu;
+        if (!loadFileInfo(buildDir + '/' + entry.analyzerInfoFile, &tu.fileInfo))
+            continue;
+        tu.sourcefile = entry.sourcefile;
+        tu.cfg = entry.cfg;
+        result.push_back(std::move(tu));
+    }
+    return result;
+}
+
+std::string AnalyzerInformation::getAnalyzerInfoFile(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg)
+{
+    const std::shared_ptr<const Manifest> manifest = getManifest(buildDir);
+    const FileEntry *entry = manifest->find(sourcefile, cfg);
+    if (entry)
+        return buildDir + '/' + entry->analyzerInfoFile;
 
     std::string filename = Path::fromNativeSeparators(buildDir);
     if (!endsWith(filename, '/'))
@@ -134,10 +487,15 @@ bool AnalyzerInformation::analyzeFile(const std::string &buildDir, const std::st
     if (skipAnalysis(mAnalyzerInfoFile, checksum, errors))
         return false;
 
-    mOutputStream.open(mAnalyzerInfoFile);
+    mOutputStream.open(mAnalyzerInfoFile, std::ios::binary);
     if (mOutputStream.is_open()) {
-        mOutputStream << "<?xml version=\"1.0\"?>\n";
-        mOutputStream << "<analyzerinfo checksum=\"" << checksum << "\">\n";
+        char header[HEADER_SIZE];
+        std::memcpy(header, FILE_MAGIC, MAGIC_SIZE);
+        for (int i = 0; i < 4; ++i)
+            header[MAGIC_SIZE + i] = static_cast<char>((FILE_VERSION >> (8 * i)) & 0xff);
+        for (int i = 0; i < 8; ++i)
+            header[MAGIC_SIZE + 4 + i] = static_cast<char>((checksum >> (8 * i)) & 0xff);
+        mOutputStream.write(header, HEADER_SIZE);
     } else {
         mAnalyzerInfoFile.clear();
     }
@@ -148,11 +506,15 @@ bool AnalyzerInformation::analyzeFile(const std::string &buildDir, const std::st
 void AnalyzerInformation::reportErr(const ErrorMessage &msg, bool /*verbose*/)
 {
     if (mOutputStream.is_open())
-        mOutputStream << msg.toXML() << '\n';
+        writeRecord(mOutputStream, RECORD_ERROR, msg.serialize());
 }
 
 void AnalyzerInformation::setFileInfo(const std::string &check, const std::string &fileInfo)
 {
-    if (mOutputStream.is_open() && !fileInfo.empty())
-        mOutputStream << "  <FileInfo check=\"" << check << "\">\n" << fileInfo << "  </FileInfo>\n";
+    if (mOutputStream.is_open() && !fileInfo.empty()) {
+        AnalyzerInfoWriter writer;
+        writer.writeString(check);
+        writer.writeString(fileInfo);
+        writeRecord(mOutputStream, RECORD_FILEINFO, writer.str());
+    }
 }
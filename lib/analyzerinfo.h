@@ -24,15 +24,64 @@
 #include "config.h"
 #include "importproject.h"
 
+#include <cstddef>
+#include <ctime>
 #include <fstream>
 #include <list>
+#include <memory>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 class ErrorMessage;
 
 /// @addtogroup Core
 /// @{
 
+/** @brief Writes values in the binary format of the analyzer information files */
+class CPPCHECKLIB AnalyzerInfoWriter {
+public:
+    /** Write an integer, small values are written in a single byte */
+    void writeInt(long long value);
+    void writeString(const std::string &str);
+
+    const std::string &str() const {
+        return mData;
+    }
+
+private:
+    std::string mData;
+};
+
+/** @brief Reads values that are written by the AnalyzerInfoWriter. The data is not copied. */
+class CPPCHECKLIB AnalyzerInfoReader {
+public:
+    AnalyzerInfoReader(const char *data, std::size_t size) : mPos(data), mEnd(data + size), mError(false) {}
+    explicit AnalyzerInfoReader(const std::string &data) : AnalyzerInfoReader(data.data(), data.size()) {}
+
+    long long readInt();
+    std::string readString();
+    /** Read a string into @p str, the memory of @p str is reused */
+    void readString(std::string &str);
+
+    /** All data has been read */
+    bool atEnd() const {
+        return mPos == mEnd;
+    }
+
+    /** Data was missing, the values that are read after the error are 0 and empty strings */
+    bool error() const {
+        return mError;
+    }
+
+private:
+    const char *mPos;
+    const char *mEnd;
+    bool mError;
+};
+
 /**
 * @brief Analyzer information
 *
@@ -50,6 +99,31 @@ class CPPCHECKLIB AnalyzerInformation {
 public:
     ~AnalyzerInformation();
 
+    /** Entry in the build dir manifest (files.txt) */
+    struct FileEntry {
+        std::string analyzerInfoFile;  ///< name of the analyzer info file in the build dir
+        std::string cfg;
+        std::string sourcefile;
+    };
+
+    /** The build dir manifest (files.txt) */
+    struct Manifest {
+        std::vector<FileEntry> files;
+
+        /** Find the entry of a source file, returns nullptr if it is not found */
+        const FileEntry *find(const std::string &sourcefile, const std::string &cfg) const;
+
+    private:
+        friend class AnalyzerInformation;
+        std::unordered_map<std::string, std::size_t> mIndex;
+    };
+
+    /**
+     * Get the manifest of the build dir. It is read and indexed once and shared
+     * by all threads, it is read again when files.txt has been changed.
+     */
+    static std::shared_ptr<const Manifest> getManifest(const std::string &buildDir);
+
     static void writeFilesTxt(const std::string &buildDir, const std::list<std::string> &sourcefiles, const std::list<ImportProject::FileSettings> &fileSettings);
 
     /** Close current TU.analyzerinfo file */
@@ -57,6 +131,53 @@ public:
     bool analyzeFile(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg, unsigned long long checksum, std::list<ErrorMessage> *errors);
     void reportErr(const ErrorMessage &msg, bool verbose);
     void setFileInfo(const std::string &check, const std::string &fileInfo);
+
+    /**
+     * Save the files that the results of the current TU depend on, so the TU
+     * can be skipped with isUnchanged() without preprocessing it. Nothing is
+     * saved if a file has been modified, or a missed file has been created,
+     * after the analysis started. If the
+     * analysis was skipped by analyzeFile(), the saved files are updated if
+     * there were saved files before.
+     * @param settingsChecksum checksum of the settings that affect the results
+     * @param files the source file and all included files
+     * @param missedFiles the paths that were tried before the included files were found
+     * @param analysisStart time when the files were read
+     */
+    void setDependencies(unsigned long long settingsChecksum, const std::vector<std::string> &files, const std::set<std::string> &missedFiles, std::time_t analysisStart);
+
+    /**
+     * Check if a TU is unchanged since it was analyzed. It is unchanged if
+     * the settings checksum is the same, the size, modification time and
+     * inode of all files saved by setDependencies() are the same and none of
+     * the missed files exists.
+     * @return true if the TU is unchanged, then the errors of the last analysis are added to errors
+     */
+    static bool isUnchanged(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg, unsigned long long settingsChecksum, std::list<ErrorMessage> *errors);
+
+    /**
+     * Load the data that was written with setFileInfo() for whole program analysis.
+     * @param analyzerInfoFile analyzer information file
+     * @param fileInfo the check names and file info data are added here
+     * @return false if the file can't be read or is incomplete
+     */
+    static bool loadFileInfo(const std::string &analyzerInfoFile, std::list<std::pair<std::string, std::string>> *fileInfo);
+
+    /** The data for whole program analysis of one TU, see setFileInfo() */
+    struct TranslationUnitInfo {
+        std::string sourcefile;
+        std::string cfg;
+        /** check names and file info data */
+        std::list<std::pair<std::string, std::string>> fileInfo;
+
+        /** Binary encoding that is used to pass the data between processes */
+        std::string toString() const;
+        bool loadFromString(const std::string &data);
+    };
+
+    /** Load the data for whole program analysis of all TUs in the build dir */
+    static std::list<TranslationUnitInfo> loadAllFileInfo(const std::string &buildDir);
+
     static std::string getAnalyzerInfoFile(const std::string &buildDir, const std::string &sourcefile, const std::string &cfg);
 private:
     std::ofstream mOutputStream;
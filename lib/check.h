@@ -27,10 +27,6 @@
 #include <list>
 #include <string>
 
-namespace tinyxml2 {
-    class XMLElement;
-}
-
 namespace CTU {
     class FileInfo;
 }
@@ -99,6 +95,7 @@ public:
     public:
         FileInfo() {}
         virtual ~FileInfo() {}
+        /** Data that is saved in the analyzer information file, it is loaded with Check::loadFileInfo() */
         virtual std::string toString() const {
             return std::string();
         }
@@ -110,8 +107,8 @@ public:
         return nullptr;
     }
 
-    virtual FileInfo * loadFileInfoFromXml(const tinyxml2::XMLElement *xmlElement) const {
-        (void)xmlElement;
+    virtual FileInfo * loadFileInfo(const std::string &data) const {
+        (void)data;
         return nullptr;
     }
 
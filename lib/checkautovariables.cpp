@@ -662,7 +662,7 @@ void CheckAutoVariables::checkVarLifetime()
 void CheckAutoVariables::errorReturnDanglingLifetime(const Token *tok, const ValueFlow::Value *val)
 {
     const bool inconclusive = val ? val->isInconclusive() : false;
-    ErrorPath errorPath = val ? val->errorPath : ErrorPath();
+    ErrorPath errorPath = val ? ErrorPath(val->errorPath) : ErrorPath();
     std::string msg = "Returning " + lifetimeMessage(tok, val, errorPath);
     errorPath.emplace_back(tok, "");
     reportError(errorPath, Severity::error, "returnDanglingLifetime", msg + " that will be invalid when returning.", CWE562, inconclusive);
@@ -671,7 +671,7 @@ void CheckAutoVariables::errorReturnDanglingLifetime(const Token *tok, const Val
 void CheckAutoVariables::errorInvalidLifetime(const Token *tok, const ValueFlow::Value* val)
 {
     const bool inconclusive = val ? val->isInconclusive() : false;
-    ErrorPath errorPath = val ? val->errorPath : ErrorPath();
+    ErrorPath errorPath = val ? ErrorPath(val->errorPath) : ErrorPath();
     std::string msg = "Using " + lifetimeMessage(tok, val, errorPath);
     errorPath.emplace_back(tok, "");
     reportError(errorPath, Severity::error, "invalidLifetime", msg + " that is out of scope.", CWE562, inconclusive);
@@ -680,7 +680,7 @@ void CheckAutoVariables::errorInvalidLifetime(const Token *tok, const ValueFlow:
 void CheckAutoVariables::errorDanglingTemporaryLifetime(const Token* tok, const ValueFlow::Value* val)
 {
     const bool inconclusive = val ? val->isInconclusive() : false;
-    ErrorPath errorPath = val ? val->errorPath : ErrorPath();
+    ErrorPath errorPath = val ? ErrorPath(val->errorPath) : ErrorPath();
     std::string msg = "Using " + lifetimeMessage(tok, val, errorPath);
     errorPath.emplace_back(tok, "");
     reportError(errorPath, Severity::error, "danglingTemporaryLifetime", msg + " to temporary.", CWE562, inconclusive);
@@ -689,7 +689,7 @@ void CheckAutoVariables::errorDanglingTemporaryLifetime(const Token* tok, const
 void CheckAutoVariables::errorDanglngLifetime(const Token *tok, const ValueFlow::Value *val)
 {
     const bool inconclusive = val ? val->isInconclusive() : false;
-    ErrorPath errorPath = val ? val->errorPath : ErrorPath();
+    ErrorPath errorPath = val ? ErrorPath(val->errorPath) : ErrorPath();
     std::string tokName = tok ? tok->expressionString() : "x";
     std::string msg = "Non-local variable '" + tokName + "' will use " + lifetimeMessage(tok, val, errorPath);
     errorPath.emplace_back(tok, "");
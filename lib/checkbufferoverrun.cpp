@@ -22,6 +22,7 @@
 
 #include "checkbufferoverrun.h"
 
+#include "analyzerinfo.h"
 #include "astutils.h"
 #include "errorlogger.h"
 #include "library.h"
@@ -33,11 +34,12 @@
 #include "utils.h"
 #include "valueflow.h"
 
-#include <tinyxml2.h>
 #include <algorithm>
 #include <cstdlib>
 #include <numeric> // std::accumulate
 #include <sstream>
+#include <utility>
+#include <vector>
 
 //---------------------------------------------------------------------------
 
@@ -745,12 +747,10 @@ void CheckBufferOverrun::bufferNotZeroTerminatedError(const Token *tok, const st
 
 std::string CheckBufferOverrun::MyFileInfo::toString() const
 {
-    std::string xml;
-    if (!unsafeArrayIndex.empty())
-        xml = "    <array-index>\n" + CTU::toString(unsafeArrayIndex) + "    </array-index>\n";
-    if (!unsafePointerArith.empty())
-        xml += "    <pointer-arith>\n" + CTU::toString(unsafePointerArith) + "    </pointer-arith>\n";
-    return xml;
+    AnalyzerInfoWriter writer;
+    writer.writeString(CTU::toString(unsafeArrayIndex));
+    writer.writeString(CTU::toString(unsafePointerArith));
+    return writer.str();
 }
 
 bool CheckBufferOverrun::isCtuUnsafeBufferUsage(const Check *check, const Token *argtok, MathLib::bigint *offset, int type)
@@ -801,18 +801,12 @@ Check::FileInfo *CheckBufferOverrun::getFileInfo(const Tokenizer *tokenizer, con
     return fileInfo;
 }
 
-Check::FileInfo * CheckBufferOverrun::loadFileInfoFromXml(const tinyxml2::XMLElement *xmlElement) const
+Check::FileInfo * CheckBufferOverrun::loadFileInfo(const std::string &data) const
 {
-    const std::string arrayIndex("array-index");
-    const std::string pointerArith("pointer-arith");
-
+    AnalyzerInfoReader reader(data);
     MyFileInfo *fileInfo = new MyFileInfo;
-    for (const tinyxml2::XMLElement *e = xmlElement->FirstChildElement(); e; e = e->NextSiblingElement()) {
-        if (e->Name() == arrayIndex)
-            fileInfo->unsafeArrayIndex = CTU::loadUnsafeUsageListFromXml(e);
-        else if (e->Name() == pointerArith)
-            fileInfo->unsafePointerArith = CTU::loadUnsafeUsageListFromXml(e);
-    }
+    fileInfo->unsafeArrayIndex = CTU::loadUnsafeUsageList(reader.readString());
+    fileInfo->unsafePointerArith = CTU::loadUnsafeUsageList(reader.readString());
 
     if (fileInfo->unsafeArrayIndex.empty() && fileInfo->unsafePointerArith.empty()) {
         delete fileInfo;
@@ -828,23 +822,35 @@ bool CheckBufferOverrun::analyseWholeProgram(const CTU::FileInfo *ctu, const std
     if (!ctu)
         return false;
     bool foundErrors = false;
-    (void)settings; // This argument is unused
 
-    const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> callsMap = ctu->getCallsMap();
+    const CTU::FileInfo::CallsMap &callsMap = ctu->getCallsMap();
 
+    std::vector<std::pair<const CTU::FileInfo::UnsafeUsage *, int>> unsafeUsages;
     for (Check::FileInfo *fi1 : fileInfo) {
         const MyFileInfo *fi = dynamic_cast<MyFileInfo*>(fi1);
         if (!fi)
             continue;
         for (const CTU::FileInfo::UnsafeUsage &unsafeUsage : fi->unsafeArrayIndex)
-            foundErrors |= analyseWholeProgram1(ctu, callsMap, unsafeUsage, 1, errorLogger);
+            unsafeUsages.emplace_back(&unsafeUsage, 1);
         for (const CTU::FileInfo::UnsafeUsage &unsafeUsage : fi->unsafePointerArith)
-            foundErrors |= analyseWholeProgram1(ctu, callsMap, unsafeUsage, 2, errorLogger);
+            unsafeUsages.emplace_back(&unsafeUsage, 2);
+    }
+
+    std::vector<std::unique_ptr<ErrorMessage>> errorMessages(unsafeUsages.size());
+    CTU::forEachIndex(unsafeUsages.size(), settings.jobs, [&](std::size_t i) {
+        errorMessages[i] = analyseWholeProgram1(ctu, callsMap, *unsafeUsages[i].first, unsafeUsages[i].second);
+    });
+
+    for (const std::unique_ptr<ErrorMessage> &errorMessage : errorMessages) {
+        if (errorMessage) {
+            errorLogger.reportErr(*errorMessage);
+            foundErrors = true;
+        }
     }
     return foundErrors;
 }
 
-bool CheckBufferOverrun::analyseWholeProgram1(const CTU::FileInfo *ctu, const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> &callsMap, const CTU::FileInfo::UnsafeUsage &unsafeUsage, int type, ErrorLogger &errorLogger)
+std::unique_ptr<ErrorMessage> CheckBufferOverrun::analyseWholeProgram1(const CTU::FileInfo *ctu, const CTU::FileInfo::CallsMap &callsMap, const CTU::FileInfo::UnsafeUsage &unsafeUsage, int type)
 {
     const CTU::FileInfo::FunctionCall *functionCall = nullptr;
 
@@ -856,7 +862,7 @@ bool CheckBufferOverrun::analyseWholeProgram1(const CTU::FileInfo *ctu, const st
                           &functionCall,
                           false);
     if (locationList.empty())
-        return false;
+        return nullptr;
 
     const char *errorId = nullptr;
     std::string errmsg;
@@ -875,15 +881,12 @@ bool CheckBufferOverrun::analyseWholeProgram1(const CTU::FileInfo *ctu, const st
         cwe = CWE_POINTER_ARITHMETIC_OVERFLOW;
     }
 
-    const ErrorMessage errorMessage(locationList,
-                                    emptyString,
-                                    Severity::error,
-                                    errmsg,
-                                    errorId,
-                                    cwe, false);
-    errorLogger.reportErr(errorMessage);
-
-    return true;
+    return std::unique_ptr<ErrorMessage>(new ErrorMessage(locationList,
+                                         emptyString,
+                                         Severity::error,
+                                         errmsg,
+                                         errorId,
+                                         cwe, false));
 }
 
 void CheckBufferOverrun::objectIndex()
@@ -32,13 +32,10 @@
 #include <cstddef>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
-namespace tinyxml2 {
-    class XMLElement;
-}
-
 class ErrorLogger;
 class Settings;
 class Token;
@@ -129,7 +126,7 @@ private:
         /** unsafe pointer arithmetics */
         std::list<CTU::FileInfo::UnsafeUsage> unsafePointerArith;
 
-        /** Convert MyFileInfo data into xml string */
+        /** Convert MyFileInfo data into a string for the analyzer information file */
         std::string toString() const OVERRIDE;
     };
 
@@ -137,8 +134,9 @@ private:
     static bool isCtuUnsafeArrayIndex(const Check *check, const Token *argtok, MathLib::bigint *offset);
     static bool isCtuUnsafePointerArith(const Check *check, const Token *argtok, MathLib::bigint *offset);
 
-    Check::FileInfo * loadFileInfoFromXml(const tinyxml2::XMLElement *xmlElement) const OVERRIDE;
-    bool analyseWholeProgram1(const CTU::FileInfo *ctu, const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> &callsMap, const CTU::FileInfo::UnsafeUsage &unsafeUsage, int type, ErrorLogger &errorLogger);
+    Check::FileInfo * loadFileInfo(const std::string &data) const OVERRIDE;
+    /** @brief Get the error for an unsafe usage, nullptr if there is no error */
+    static std::unique_ptr<ErrorMessage> analyseWholeProgram1(const CTU::FileInfo *ctu, const CTU::FileInfo::CallsMap &callsMap, const CTU::FileInfo::UnsafeUsage &unsafeUsage, int type);
 
 
     static std::string myName() {
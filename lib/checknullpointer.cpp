@@ -32,7 +32,9 @@
 #include <algorithm>
 #include <cctype>
 #include <cstddef>
+#include <list>
 #include <set>
+#include <vector>
 //---------------------------------------------------------------------------
 
 // Register this check class (by creating a static instance of it)
@@ -559,9 +561,9 @@ Check::FileInfo *CheckNullPointer::getFileInfo(const Tokenizer *tokenizer, const
     return fileInfo;
 }
 
-Check::FileInfo * CheckNullPointer::loadFileInfoFromXml(const tinyxml2::XMLElement *xmlElement) const
+Check::FileInfo * CheckNullPointer::loadFileInfo(const std::string &data) const
 {
-    const std::list<CTU::FileInfo::UnsafeUsage> &unsafeUsage = CTU::loadUnsafeUsageListFromXml(xmlElement);
+    const std::list<CTU::FileInfo::UnsafeUsage> &unsafeUsage = CTU::loadUnsafeUsageList(data);
     if (unsafeUsage.empty())
         return nullptr;
 
@@ -575,41 +577,53 @@ bool CheckNullPointer::analyseWholeProgram(const CTU::FileInfo *ctu, const std::
     if (!ctu)
         return false;
     bool foundErrors = false;
-    (void)settings; // This argument is unused
 
-    const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> callsMap = ctu->getCallsMap();
+    const CTU::FileInfo::CallsMap &callsMap = ctu->getCallsMap();
 
+    std::vector<const CTU::FileInfo::UnsafeUsage *> unsafeUsages;
     for (Check::FileInfo *fi1 : fileInfo) {
         const MyFileInfo *fi = dynamic_cast<MyFileInfo*>(fi1);
         if (!fi)
             continue;
-        for (const CTU::FileInfo::UnsafeUsage &unsafeUsage : fi->unsafeUsage) {
-            for (int warning = 0; warning <= 1; warning++) {
-                if (warning == 1 && !settings.isEnabled(Settings::WARNING))
-                    break;
+        for (const CTU::FileInfo::UnsafeUsage &unsafeUsage : fi->unsafeUsage)
+            unsafeUsages.push_back(&unsafeUsage);
+    }
 
-                const std::list<ErrorMessage::FileLocation> &locationList =
-                    ctu->getErrorPath(CTU::FileInfo::InvalidValueType::null,
-                                      unsafeUsage,
+    struct Result {
+        std::list<ErrorMessage::FileLocation> locationList;
+        bool warning;
+    };
+    std::vector<Result> results(unsafeUsages.size());
+    CTU::forEachIndex(unsafeUsages.size(), settings.jobs, [&](std::size_t i) {
+        for (int warning = 0; warning <= 1; warning++) {
+            if (warning == 1 && !settings.isEnabled(Settings::WARNING))
+                break;
+
+            results[i].locationList = ctu->getErrorPath(CTU::FileInfo::InvalidValueType::null,
+                                      *unsafeUsages[i],
                                       callsMap,
                                       "Dereferencing argument ARG that is null",
                                       nullptr,
                                       warning);
-                if (locationList.empty())
-                    continue;
-
-                const ErrorMessage errmsg(locationList,
-                                          emptyString,
-                                          warning ? Severity::warning : Severity::error,
-                                          "Null pointer dereference: " + unsafeUsage.myArgumentName,
-                                          "ctunullpointer",
-                                          CWE_NULL_POINTER_DEREFERENCE, false);
-                errorLogger.reportErr(errmsg);
-
-                foundErrors = true;
+            results[i].warning = (warning == 1);
+            if (!results[i].locationList.empty())
                 break;
-            }
         }
+    });
+
+    for (std::size_t i = 0; i < unsafeUsages.size(); ++i) {
+        if (results[i].locationList.empty())
+            continue;
+
+        const ErrorMessage errmsg(results[i].locationList,
+                                  emptyString,
+                                  results[i].warning ? Severity::warning : Severity::error,
+                                  "Null pointer dereference: " + unsafeUsages[i]->myArgumentName,
+                                  "ctunullpointer",
+                                  CWE_NULL_POINTER_DEREFERENCE, false);
+        errorLogger.reportErr(errmsg);
+
+        foundErrors = true;
     }
 
     return foundErrors;
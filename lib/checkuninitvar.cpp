@@ -37,11 +37,7 @@
 #include <map>
 #include <stack>
 #include <utility>
-
-
-namespace tinyxml2 {
-    class XMLElement;
-}
+#include <vector>
 
 //---------------------------------------------------------------------------
 
@@ -1418,9 +1414,9 @@ Check::FileInfo *CheckUninitVar::getFileInfo() const
     return fileInfo;
 }
 
-Check::FileInfo * CheckUninitVar::loadFileInfoFromXml(const tinyxml2::XMLElement *xmlElement) const
+Check::FileInfo * CheckUninitVar::loadFileInfo(const std::string &data) const
 {
-    const std::list<CTU::FileInfo::UnsafeUsage> &unsafeUsage = CTU::loadUnsafeUsageListFromXml(xmlElement);
+    const std::list<CTU::FileInfo::UnsafeUsage> &unsafeUsage = CTU::loadUnsafeUsageList(data);
     if (unsafeUsage.empty())
         return nullptr;
 
@@ -1434,38 +1430,47 @@ bool CheckUninitVar::analyseWholeProgram(const CTU::FileInfo *ctu, const std::li
     if (!ctu)
         return false;
     bool foundErrors = false;
-    (void)settings; // This argument is unused
 
-    const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> callsMap = ctu->getCallsMap();
+    const CTU::FileInfo::CallsMap &callsMap = ctu->getCallsMap();
 
+    std::vector<const CTU::FileInfo::UnsafeUsage *> unsafeUsages;
     for (Check::FileInfo *fi1 : fileInfo) {
         const MyFileInfo *fi = dynamic_cast<MyFileInfo*>(fi1);
         if (!fi)
             continue;
-        for (const CTU::FileInfo::UnsafeUsage &unsafeUsage : fi->unsafeUsage) {
-            const CTU::FileInfo::FunctionCall *functionCall = nullptr;
+        for (const CTU::FileInfo::UnsafeUsage &unsafeUsage : fi->unsafeUsage)
+            unsafeUsages.push_back(&unsafeUsage);
+    }
 
-            const std::list<ErrorMessage::FileLocation> &locationList =
-                ctu->getErrorPath(CTU::FileInfo::InvalidValueType::uninit,
-                                  unsafeUsage,
+    struct Result {
+        std::list<ErrorMessage::FileLocation> locationList;
+        const CTU::FileInfo::FunctionCall *functionCall;
+    };
+    std::vector<Result> results(unsafeUsages.size());
+    CTU::forEachIndex(unsafeUsages.size(), settings.jobs, [&](std::size_t i) {
+        results[i].functionCall = nullptr;
+        results[i].locationList = ctu->getErrorPath(CTU::FileInfo::InvalidValueType::uninit,
+                                  *unsafeUsages[i],
                                   callsMap,
                                   "Using argument ARG",
-                                  &functionCall,
+                                  &results[i].functionCall,
                                   false);
-            if (locationList.empty())
-                continue;
+    });
 
-            const ErrorMessage errmsg(locationList,
-                                      emptyString,
-                                      Severity::error,
-                                      "Using argument " + unsafeUsage.myArgumentName + " that points at uninitialized variable " + functionCall->callArgumentExpression,
-                                      "ctuuninitvar",
-                                      CWE_USE_OF_UNINITIALIZED_VARIABLE,
-                                      false);
-            errorLogger.reportErr(errmsg);
+    for (std::size_t i = 0; i < unsafeUsages.size(); ++i) {
+        if (results[i].locationList.empty())
+            continue;
 
-            foundErrors = true;
-        }
+        const ErrorMessage errmsg(results[i].locationList,
+                                  emptyString,
+                                  Severity::error,
+                                  "Using argument " + unsafeUsages[i]->myArgumentName + " that points at uninitialized variable " + results[i].functionCall->callArgumentExpression,
+                                  "ctuuninitvar",
+                                  CWE_USE_OF_UNINITIALIZED_VARIABLE,
+                                  false);
+        errorLogger.reportErr(errmsg);
+
+        foundErrors = true;
     }
     return foundErrors;
 }
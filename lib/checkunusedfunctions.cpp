@@ -20,6 +20,7 @@
 //---------------------------------------------------------------------------
 #include "checkunusedfunctions.h"
 
+#include "analyzerinfo.h"
 #include "astutils.h"
 #include "errorlogger.h"
 #include "library.h"
@@ -29,11 +30,10 @@
 #include "tokenize.h"
 #include "tokenlist.h"
 
-#include <tinyxml2.h>
 #include <algorithm>
-#include <cstdlib>
-#include <cstring>
 #include <istream>
+#include <list>
+#include <memory>
 #include <utility>
 //---------------------------------------------------------------------------
 
@@ -366,16 +366,16 @@ CheckUnusedFunctions::FunctionDecl::FunctionDecl(const Function *f)
 
 std::string CheckUnusedFunctions::analyzerInfo() const
 {
-    std::ostringstream ret;
+    AnalyzerInfoWriter writer;
+    writer.writeInt(mFunctionDecl.size());
     for (const FunctionDecl &functionDecl : mFunctionDecl) {
-        ret << "    <functiondecl"
-            << " functionName=\"" << ErrorLogger::toxml(functionDecl.functionName) << '\"'
-            << " lineNumber=\"" << functionDecl.lineNumber << "\"/>\n";
+        writer.writeString(functionDecl.functionName);
+        writer.writeInt(functionDecl.lineNumber);
     }
-    for (const std::string &fc : mFunctionCalls) {
-        ret << "    <functioncall functionName=\"" << ErrorLogger::toxml(fc) << "\"/>\n";
-    }
-    return ret.str();
+    writer.writeInt(mFunctionCalls.size());
+    for (const std::string &fc : mFunctionCalls)
+        writer.writeString(fc);
+    return writer.str();
 }
 
 namespace {
@@ -387,55 +387,31 @@ namespace {
     };
 }
 
-void CheckUnusedFunctions::analyseWholeProgram(ErrorLogger * const errorLogger, const std::string &buildDir)
+bool CheckUnusedFunctions::analyseWholeProgram(ErrorLogger * const errorLogger, const std::list<AnalyzerInformation::TranslationUnitInfo> &fileInfo)
 {
     std::map<std::string, Location> decls;
     std::set<std::string> calls;
 
-    const std::string filesTxt(buildDir + "/files.txt");
-    std::ifstream fin(filesTxt.c_str());
-    std::string filesTxtLine;
-    while (std::getline(fin, filesTxtLine)) {
-        const std::string::size_type firstColon = filesTxtLine.find(':');
-        if (firstColon == std::string::npos)
-            continue;
-        const std::string::size_type secondColon = filesTxtLine.find(':', firstColon+1);
-        if (secondColon == std::string::npos)
-            continue;
-        const std::string xmlfile = buildDir + '/' + filesTxtLine.substr(0,firstColon);
-        const std::string sourcefile = filesTxtLine.substr(secondColon+1);
-
-        tinyxml2::XMLDocument doc;
-        const tinyxml2::XMLError error = doc.LoadFile(xmlfile.c_str());
-        if (error != tinyxml2::XML_SUCCESS)
-            continue;
-
-        const tinyxml2::XMLElement * const rootNode = doc.FirstChildElement();
-        if (rootNode == nullptr)
-            continue;
-
-        for (const tinyxml2::XMLElement *e = rootNode->FirstChildElement(); e; e = e->NextSiblingElement()) {
-            if (std::strcmp(e->Name(), "FileInfo") != 0)
-                continue;
-            const char *checkattr = e->Attribute("check");
-            if (checkattr == nullptr || std::strcmp(checkattr,"CheckUnusedFunctions") != 0)
+    for (const AnalyzerInformation::TranslationUnitInfo &tu : fileInfo) {
+        for (const std::pair<std::string, std::string> &fi : tu.fileInfo) {
+            if (fi.first != "CheckUnusedFunctions")
                 continue;
-            for (const tinyxml2::XMLElement *e2 = e->FirstChildElement(); e2; e2 = e2->NextSiblingElement()) {
-                const char* functionName = e2->Attribute("functionName");
-                if (functionName == nullptr)
-                    continue;
-                if (std::strcmp(e2->Name(),"functioncall") == 0) {
+            AnalyzerInfoReader reader(fi.second);
+            for (long long count = reader.readInt(); count > 0 && !reader.error(); --count) {
+                const std::string functionName = reader.readString();
+                const int lineNumber = static_cast<int>(reader.readInt());
+                if (!reader.error())
+                    decls[functionName] = Location(tu.sourcefile, lineNumber);
+            }
+            for (long long count = reader.readInt(); count > 0 && !reader.error(); --count) {
+                const std::string functionName = reader.readString();
+                if (!reader.error())
                     calls.insert(functionName);
-                    continue;
-                } else if (std::strcmp(e2->Name(),"functiondecl") == 0) {
-                    const char* lineNumber = e2->Attribute("lineNumber");
-                    if (lineNumber)
-                        decls[functionName] = Location(sourcefile, std::atoi(lineNumber));
-                }
             }
         }
     }
 
+    bool errors = false;
     for (std::map<std::string, Location>::const_iterator decl = decls.begin(); decl != decls.end(); ++decl) {
         const std::string &functionName = decl->first;
 
@@ -446,6 +422,8 @@ void CheckUnusedFunctions::analyseWholeProgram(ErrorLogger * const errorLogger,
         if (calls.find(functionName) == calls.end() && !isOperatorFunction(functionName)) {
             const Location &loc = decl->second;
             unusedFunctionError(errorLogger, loc.fileName, loc.lineNumber, functionName);
+            errors = true;
         }
     }
+    return errors;
 }
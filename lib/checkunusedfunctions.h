@@ -22,6 +22,7 @@
 #define checkunusedfunctionsH
 //---------------------------------------------------------------------------
 
+#include "analyzerinfo.h"
 #include "check.h"
 #include "config.h"
 
@@ -73,8 +74,11 @@ public:
 
     std::string analyzerInfo() const;
 
-    /** @brief Combine and analyze all analyzerInfos for all TUs */
-    static void analyseWholeProgram(ErrorLogger * const errorLogger, const std::string &buildDir);
+    /**
+     * @brief Combine and analyze all analyzerInfos for all TUs
+     * @return true if an error is reported
+     */
+    static bool analyseWholeProgram(ErrorLogger * const errorLogger, const std::list<AnalyzerInformation::TranslationUnitInfo> &fileInfo);
 
 private:
 
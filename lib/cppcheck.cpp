@@ -30,6 +30,7 @@
 #include "timer.h"
 #include "tokenize.h" // Tokenizer
 #include "tokenlist.h"
+#include "utils.h"
 #include "version.h"
 
 #include "exprengine.h"
@@ -37,12 +38,18 @@
 #define PICOJSON_USE_INT64
 #include <picojson.h>
 #include <simplecpp.h>
-#include <tinyxml2.h>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <ctime>
+#include <exception>
+#include <mutex>
 #include <new>
 #include <set>
 #include <stdexcept>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <iostream> // <- TEMPORARY
@@ -187,47 +194,69 @@ static std::vector<std::string> split(const std::string &str, const std::string
     return ret;
 }
 
-static std::string executeAddon(const AddonInfo &addonInfo,
-                                const std::string &defaultPythonExe,
-                                const std::string &dumpFile,
-                                std::function<bool(std::string,std::vector<std::string>,std::string,std::string*)> executeCommand)
+std::string CppCheck::getPythonExe(const std::string &addonPython)
 {
-    const std::string redirect = "2>&1";
+    if (!addonPython.empty())
+        return addonPython;
+    if (!mSettings.addonPython.empty())
+        return mSettings.addonPython;
+    if (!mPythonExe.empty())
+        return mPythonExe;
 
-    std::string pythonExe;
-
-    if (!addonInfo.python.empty())
-        pythonExe = cmdFileName(addonInfo.python);
-    else if (!defaultPythonExe.empty())
-        pythonExe = cmdFileName(defaultPythonExe);
-    else {
 #ifdef _WIN32
-        const char *py_exes[] = { "python3.exe", "python.exe" };
+    const char *py_exes[] = { "python3.exe", "python.exe" };
 #else
-        const char *py_exes[] = { "python3", "python" };
+    const char *py_exes[] = { "python3", "python" };
 #endif
-        for (const char* py_exe : py_exes) {
-            std::string out;
-            if (executeCommand(py_exe, split("--version"), redirect, &out) && out.compare(0, 7, "Python ") == 0 && std::isdigit(out[7])) {
-                pythonExe = py_exe;
-                break;
-            }
+    for (const char* py_exe : py_exes) {
+        std::string out;
+        if (mExecuteCommand(py_exe, split("--version"), "2>&1", &out) && out.compare(0, 7, "Python ") == 0 && std::isdigit(out[7])) {
+            mPythonExe = py_exe;
+            return mPythonExe;
         }
-        if (pythonExe.empty())
-            throw InternalError(nullptr, "Failed to auto detect python");
     }
+    throw InternalError(nullptr, "Failed to auto detect python");
+}
 
-    const std::string args = cmdFileName(addonInfo.scriptFile) + " --cli" + addonInfo.args + " " + cmdFileName(dumpFile);
+std::string CppCheck::executeAddon(const std::string &pythonExe,
+                                   const std::string &scriptFile,
+                                   const std::string &args,
+                                   const std::string &dumpFile)
+{
+    const std::string cmdArgs = cmdFileName(scriptFile) + " --cli" + args + " " + cmdFileName(dumpFile);
     std::string result;
-    if (!executeCommand(pythonExe, split(args), redirect, &result))
-        throw InternalError(nullptr, "Failed to execute addon (command: '" + pythonExe + " " + args + "')");
+    bool executed = false;
+
+    if (mStartAddonServer) {
+        // Start the server at the first file, the addon is executed for the remaining files without loading python again
+        const std::string key = pythonExe + '\n' + scriptFile + '\n' + args;
+        std::map<std::string, std::unique_ptr<AddonServer>>::iterator server = mAddonServers.find(key);
+        if (server == mAddonServers.end()) {
+            const std::string serverScript = AddonInfo::getFullPath("addonserver.py", mSettings.exename);
+            std::unique_ptr<AddonServer> addonServer;
+            if (!serverScript.empty())
+                addonServer = mStartAddonServer(pythonExe, split(cmdFileName(serverScript) + " " + cmdFileName(scriptFile) + " --cli" + args));
+            server = mAddonServers.emplace(key, std::move(addonServer)).first;
+        }
+        if (server->second) {
+            executed = server->second->execute(dumpFile, &result);
+            // The server has failed, the addon is executed for each file from now on
+            if (!executed) {
+                server->second.reset();
+                result.clear();
+            }
+        }
+    }
+
+    if (!executed && !mExecuteCommand(cmdFileName(pythonExe), split(cmdArgs), "2>&1", &result))
+        throw InternalError(nullptr, "Failed to execute addon (command: '" + cmdFileName(pythonExe) + " " + cmdArgs + "')");
 
     // Validate output..
     std::istringstream istr(result);
     std::string line;
     while (std::getline(istr, line)) {
         if (line.compare(0,9,"Checking ", 0, 9) != 0 && !line.empty() && line[0] != '{')
-            throw InternalError(nullptr, "Failed to execute '" + pythonExe + " " + args + "'. " + result);
+            throw InternalError(nullptr, "Failed to execute '" + cmdFileName(pythonExe) + " " + cmdArgs + "'. " + result);
     }
 
     // Valid results
@@ -242,6 +271,46 @@ static std::string getDefinesFlags(const std::string &semicolonSeparatedString)
     return flags;
 }
 
+/** The user defines followed by the defines of the configuration that are not given by the user */
+static std::string getCurrentConfig(const std::string &userDefines, const std::string &cfg)
+{
+    if (userDefines.empty())
+        return cfg;
+
+    std::string currentConfig = userDefines;
+    const std::vector<std::string> v1(split(userDefines, ";"));
+    for (const std::string &d: split(cfg, ";")) {
+        if (std::find(v1.begin(), v1.end(), d) == v1.end())
+            currentConfig += ";" + d;
+    }
+    return currentConfig;
+}
+
+static std::string getConfigurationError(const std::string &currentConfig, const simplecpp::Output &o)
+{
+    return (currentConfig.empty() ? "\'\'" : currentConfig) + " : [" + o.location.file() + ':' + MathLib::toString(o.location.line) + "] " + o.msg;
+}
+
+static ErrorMessage getInternalErrorMessage(const InternalError &e, const Tokenizer &tokenizer, const std::string &filename)
+{
+    std::list<ErrorMessage::FileLocation> locationList;
+    if (e.token) {
+        ErrorMessage::FileLocation loc(e.token, &tokenizer.list);
+        locationList.push_back(loc);
+    } else {
+        ErrorMessage::FileLocation loc(tokenizer.list.getSourceFilePath(), 0, 0);
+        ErrorMessage::FileLocation loc2(filename, 0, 0);
+        locationList.push_back(loc2);
+        locationList.push_back(loc);
+    }
+    return ErrorMessage(locationList,
+                        tokenizer.list.getSourceFilePath(),
+                        Severity::error,
+                        e.errorMessage,
+                        e.id,
+                        false);
+}
+
 CppCheck::CppCheck(ErrorLogger &errorLogger,
                    bool useGlobalSuppressions,
                    std::function<bool(std::string,std::vector<std::string>,std::string,std::string*)> executeCommand)
@@ -261,7 +330,6 @@ CppCheck::~CppCheck()
         delete mFileInfo.back();
         mFileInfo.pop_back();
     }
-    s_timerResults.showResults(mSettings.showtime);
 }
 
 const char * CppCheck::version()
@@ -388,19 +456,24 @@ unsigned int CppCheck::check(const std::string &path)
     }
 
     std::ifstream fin(path);
-    return checkFile(Path::simplifyPath(path), emptyString, fin);
+    return checkFile(Path::simplifyPath(path), emptyString, fin, true);
 }
 
 unsigned int CppCheck::check(const std::string &path, const std::string &content)
 {
     std::istringstream iss(content);
-    return checkFile(Path::simplifyPath(path), emptyString, iss);
+    return checkFile(Path::simplifyPath(path), emptyString, iss, false);
 }
 
 unsigned int CppCheck::check(const ImportProject::FileSettings &fs)
 {
     CppCheck temp(mErrorLogger, mUseGlobalSuppressions, mExecuteCommand);
     temp.mSettings = mSettings;
+    temp.mFileInfoCallback = mFileInfoCallback;
+    // The addon servers are borrowed so they are not started again for each file
+    temp.mStartAddonServer = mStartAddonServer;
+    temp.mAddonServers.swap(mAddonServers);
+    temp.mPythonExe = mPythonExe;
     if (!temp.mSettings.userDefines.empty())
         temp.mSettings.userDefines += ';';
     if (mSettings.clang)
@@ -420,10 +493,73 @@ unsigned int CppCheck::check(const ImportProject::FileSettings &fs)
         temp.check(Path::simplifyPath(fs.filename));
     }
     std::ifstream fin(fs.filename);
-    return temp.checkFile(Path::simplifyPath(fs.filename), fs.cfg, fin);
+    const unsigned int returnValue = temp.checkFile(Path::simplifyPath(fs.filename), fs.cfg, fin, true);
+    mAddonServers.swap(temp.mAddonServers);
+    mPythonExe = temp.mPythonExe;
+    return returnValue;
+}
+
+static std::string getToolInfo(const Settings &settings)
+{
+    std::ostringstream toolinfo;
+    toolinfo << CPPCHECK_VERSION_STRING;
+    toolinfo << (settings.isEnabled(Settings::WARNING) ? 'w' : ' ');
+    toolinfo << (settings.isEnabled(Settings::STYLE) ? 's' : ' ');
+    toolinfo << (settings.isEnabled(Settings::PERFORMANCE) ? 'p' : ' ');
+    toolinfo << (settings.isEnabled(Settings::PORTABILITY) ? 'p' : ' ');
+    toolinfo << (settings.isEnabled(Settings::INFORMATION) ? 'i' : ' ');
+    toolinfo << settings.userDefines;
+    settings.nomsg.dump(toolinfo);
+    return toolinfo.str();
+}
+
+// Checksum of the settings that affect the results of a file. Unlike the
+// checksum of the preprocessed code it must also cover the settings that
+// decide which files are included.
+static unsigned long long getSettingsChecksum(const Settings &settings, const std::string &cfgname)
+{
+    Hash64 hash;
+    hash.update(getToolInfo(settings));
+    hash.update(cfgname);
+    for (const std::string &includePath : settings.includePaths)
+        hash.update("-I" + includePath);
+    for (const std::string &undef : settings.userUndefs)
+        hash.update("-U" + undef);
+    for (const std::string &include : settings.userIncludes)
+        hash.update("--include=" + include);
+    for (const std::string &library : settings.libraries)
+        hash.update("--library=" + library);
+    // The content of the loaded cfg files, they can change without changing the library names
+    hash.update(settings.library.checksum());
+    for (const Settings::Rule &rule : settings.rules)
+        hash.update("--rule=" + rule.tokenlist + '\n' + rule.pattern + '\n' + rule.id + '\n' + rule.summary + '\n' + Severity::toString(rule.severity));
+    hash.update(settings.platformString());
+    const int values[] = {
+        settings.sizeof_bool, settings.sizeof_short, settings.sizeof_int, settings.sizeof_long, settings.sizeof_long_long,
+        settings.sizeof_float, settings.sizeof_double, settings.sizeof_long_double, settings.sizeof_wchar_t,
+        settings.sizeof_size_t, settings.sizeof_pointer, settings.char_bit, settings.defaultSign,
+        settings.standards.c, settings.standards.cpp,
+        settings.inconclusive, settings.force, settings.checkAllConfigurations, settings.maxConfigs,
+        settings.checkHeaders, settings.checkUnusedTemplates, settings.debugwarnings, settings.experimental
+    };
+    for (int value : values)
+        hash.update(static_cast<unsigned long long>(value));
+    return hash.digest();
+}
+
+// The results of unchanged files can be reused without preprocessing the files
+// unless something else than the errors is written for each file
+static bool canSkipUnchangedFiles(const Settings &settings)
+{
+    return !settings.buildDir.empty() &&
+           !settings.inlineSuppressions &&
+           !settings.dump &&
+           settings.addons.empty() &&
+           settings.plistOutput.empty() &&
+           !settings.checkConfiguration;
 }
 
-unsigned int CppCheck::checkFile(const std::string& filename, const std::string &cfgname, std::istream& fileStream)
+unsigned int CppCheck::checkFile(const std::string& filename, const std::string &cfgname, std::istream& fileStream, bool fileOnDisk)
 {
     mExitCode = 0;
     mSuppressInternalErrorFound = false;
@@ -462,6 +598,24 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
         plistFile.close();
     }
 
+    // The files that the results depend on, they are saved for the next analysis
+    const bool saveDependencies = fileOnDisk && canSkipUnchangedFiles(mSettings);
+    const unsigned long long settingsChecksum = saveDependencies ? getSettingsChecksum(mSettings, cfgname) : 0;
+    const std::time_t analysisStart = std::time(nullptr);
+    std::vector<std::string> dependencies;
+    std::set<std::string> missedFiles;
+
+    if (saveDependencies) {
+        std::list<ErrorMessage> errors;
+        if (AnalyzerInformation::isUnchanged(mSettings.buildDir, filename, cfgname, settingsChecksum, &errors)) {
+            while (!errors.empty()) {
+                reportErr(errors.front());
+                errors.pop_front();
+            }
+            return mExitCode;  // unchanged files => no need to reanalyze file
+        }
+    }
+
     CheckUnusedFunctions checkUnusedFunctions(nullptr, nullptr, nullptr);
 
     try {
@@ -520,6 +674,7 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
         }
 
         // write dump file xml prolog
+        std::vector<char> dumpBuffer;
         std::ofstream fdump;
         std::string dumpFile;
         if (mSettings.dump || !mSettings.addons.empty()) {
@@ -530,10 +685,14 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             else
                 dumpFile = filename + ".dump";
 
+            // The dump is written in many small pieces, a large buffer saves many writes
+            dumpBuffer.resize(1024 * 1024);
+            fdump.rdbuf()->pubsetbuf(dumpBuffer.data(), dumpBuffer.size());
             fdump.open(dumpFile);
             if (fdump.is_open()) {
-                fdump << "<?xml version=\"1.0\"?>" << std::endl;
-                fdump << "<dumps>" << std::endl;
+                Timer t("CppCheck::dump", mSettings.showtime, &s_timerResults);
+                fdump << "<?xml version=\"1.0\"?>\n";
+                fdump << "<dumps>\n";
                 fdump << "  <platform"
                       << " name=\"" << mSettings.platformString() << '\"'
                       << " char_bit=\"" << mSettings.char_bit << '\"'
@@ -543,45 +702,37 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
                       << " long_long_bit=\"" << mSettings.long_long_bit << '\"'
                       << " pointer_bit=\"" << (mSettings.sizeof_pointer * mSettings.char_bit) << '\"'
                       << "/>\n";
-                fdump << "  <rawtokens>" << std::endl;
+                fdump << "  <rawtokens>\n";
                 for (unsigned int i = 0; i < files.size(); ++i)
-                    fdump << "    <file index=\"" << i << "\" name=\"" << ErrorLogger::toxml(files[i]) << "\"/>" << std::endl;
+                    fdump << "    <file index=\"" << i << "\" name=\"" << ErrorLogger::toxml(files[i]) << "\"/>\n";
                 for (const simplecpp::Token *tok = tokens1.cfront(); tok; tok = tok->next) {
                     fdump << "    <tok "
                           << "fileIndex=\"" << tok->location.fileIndex << "\" "
                           << "linenr=\"" << tok->location.line << "\" "
                           << "column=\"" << tok->location.col << "\" "
                           << "str=\"" << ErrorLogger::toxml(tok->str()) << "\""
-                          << "/>" << std::endl;
+                          << "/>\n";
                 }
-                fdump << "  </rawtokens>" << std::endl;
+                fdump << "  </rawtokens>\n";
             }
         }
 
         // Parse comments and then remove them
         preprocessor.inlineSuppressions(tokens1);
         if ((mSettings.dump || !mSettings.addons.empty()) && fdump.is_open()) {
+            Timer t("CppCheck::dump", mSettings.showtime, &s_timerResults);
             mSettings.nomsg.dump(fdump);
         }
         tokens1.removeComments();
         preprocessor.removeComments();
 
         if (!mSettings.buildDir.empty()) {
-            // Get toolinfo
-            std::ostringstream toolinfo;
-            toolinfo << CPPCHECK_VERSION_STRING;
-            toolinfo << (mSettings.isEnabled(Settings::WARNING) ? 'w' : ' ');
-            toolinfo << (mSettings.isEnabled(Settings::STYLE) ? 's' : ' ');
-            toolinfo << (mSettings.isEnabled(Settings::PERFORMANCE) ? 'p' : ' ');
-            toolinfo << (mSettings.isEnabled(Settings::PORTABILITY) ? 'p' : ' ');
-            toolinfo << (mSettings.isEnabled(Settings::INFORMATION) ? 'i' : ' ');
-            toolinfo << mSettings.userDefines;
-            mSettings.nomsg.dump(toolinfo);
-
             // Calculate checksum so it can be compared with old checksum / future checksums
-            const unsigned int checksum = preprocessor.calculateChecksum(tokens1, toolinfo.str());
+            const unsigned long long checksum = preprocessor.calculateChecksum(tokens1, getToolInfo(mSettings));
             std::list<ErrorMessage> errors;
             if (!mAnalyzerInformation.analyzeFile(mSettings.buildDir, filename, cfgname, checksum, &errors)) {
+                if (saveDependencies && preprocessor.getMissedIncludeFiles(tokens1, &missedFiles))
+                    mAnalyzerInformation.setDependencies(settingsChecksum, files, missedFiles, analysisStart);
                 while (!errors.empty()) {
                     reportErr(errors.front());
                     errors.pop_front();
@@ -625,7 +776,7 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             Tokenizer tokenizer2(&mSettings, this);
             std::istringstream istr2(code);
             tokenizer2.list.createTokens(istr2);
-            executeRules("define", tokenizer2);
+            executeRules("define", tokenizer2, *this);
             break;
         }
 
@@ -637,161 +788,161 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             }
         }
 
-        std::set<unsigned long long> checksums;
-        unsigned int checkCount = 0;
         bool hasValidConfig = false;
         std::list<std::string> configurationError;
-        for (const std::string &currCfg : configurations) {
-            // bail out if terminated
-            if (Settings::terminated())
-                break;
+        if (mSettings.configJobs > 1 && configurations.size() > 1 &&
+            !mSettings.preprocessOnly && !mSettings.dump && mSettings.addons.empty() &&
+            !mSettings.bugHunting && !mSettings.clang && !mSettings.debugnormal && mSettings.rules.empty()) {
+            checkConfigurations(filename, preprocessor, tokens1, files, configurations, checkUnusedFunctions, hasValidConfig, configurationError);
+        } else {
+            std::set<unsigned long long> checksums;
+            // Hashes of the token lists that have been simplified, a configuration
+            // with the same tokens would be simplified into a duplicate
+            std::set<unsigned long long> simplifiedHashes;
+            const bool skipSimplifiedDuplicates = (mSettings.force || mSettings.maxConfigs > 1) &&
+                                                  !mSettings.dump && mSettings.addons.empty() && !mSettings.debugnormal;
+            unsigned int checkCount = 0;
+            for (const std::string &currCfg : configurations) {
+                // bail out if terminated
+                if (Settings::terminated())
+                    break;
 
-            // Check only a few configurations (default 12), after that bail out, unless --force
-            // was used.
-            if (!mSettings.force && ++checkCount > mSettings.maxConfigs)
-                break;
+                // Check only a few configurations (default 12), after that bail out, unless --force
+                // was used.
+                if (!mSettings.force && ++checkCount > mSettings.maxConfigs)
+                    break;
 
-            if (!mSettings.userDefines.empty()) {
-                mCurrentConfig = mSettings.userDefines;
-                const std::vector<std::string> v1(split(mSettings.userDefines, ";"));
-                for (const std::string &cfg: split(currCfg, ";")) {
-                    if (std::find(v1.begin(), v1.end(), cfg) == v1.end()) {
-                        mCurrentConfig += ";" + cfg;
-                    }
+                mCurrentConfig = getCurrentConfig(mSettings.userDefines, currCfg);
+
+                if (mSettings.preprocessOnly) {
+                    Timer t("Preprocessor::getcode", mSettings.showtime, &s_timerResults);
+                    std::string codeWithoutCfg = preprocessor.getcode(tokens1, mCurrentConfig, files, true);
+                    t.stop();
+
+                    if (codeWithoutCfg.compare(0,5,"#file") == 0)
+                        codeWithoutCfg.insert(0U, "//");
+                    std::string::size_type pos = 0;
+                    while ((pos = codeWithoutCfg.find("\n#file",pos)) != std::string::npos)
+                        codeWithoutCfg.insert(pos+1U, "//");
+                    pos = 0;
+                    while ((pos = codeWithoutCfg.find("\n#endfile",pos)) != std::string::npos)
+                        codeWithoutCfg.insert(pos+1U, "//");
+                    pos = 0;
+                    while ((pos = codeWithoutCfg.find(Preprocessor::macroChar,pos)) != std::string::npos)
+                        codeWithoutCfg[pos] = ' ';
+                    reportOut(codeWithoutCfg);
+                    continue;
                 }
-            } else {
-                mCurrentConfig = currCfg;
-            }
-
-            if (mSettings.preprocessOnly) {
-                Timer t("Preprocessor::getcode", mSettings.showtime, &s_timerResults);
-                std::string codeWithoutCfg = preprocessor.getcode(tokens1, mCurrentConfig, files, true);
-                t.stop();
-
-                if (codeWithoutCfg.compare(0,5,"#file") == 0)
-                    codeWithoutCfg.insert(0U, "//");
-                std::string::size_type pos = 0;
-                while ((pos = codeWithoutCfg.find("\n#file",pos)) != std::string::npos)
-                    codeWithoutCfg.insert(pos+1U, "//");
-                pos = 0;
-                while ((pos = codeWithoutCfg.find("\n#endfile",pos)) != std::string::npos)
-                    codeWithoutCfg.insert(pos+1U, "//");
-                pos = 0;
-                while ((pos = codeWithoutCfg.find(Preprocessor::macroChar,pos)) != std::string::npos)
-                    codeWithoutCfg[pos] = ' ';
-                reportOut(codeWithoutCfg);
-                continue;
-            }
 
-            Tokenizer tokenizer(&mSettings, this);
-            tokenizer.setPreprocessor(&preprocessor);
-            if (mSettings.showtime != SHOWTIME_MODES::SHOWTIME_NONE)
-                tokenizer.setTimerResults(&s_timerResults);
+                Tokenizer tokenizer(&mSettings, this);
+                tokenizer.setPreprocessor(&preprocessor);
+                if (mSettings.showtime != SHOWTIME_MODES::SHOWTIME_NONE)
+                    tokenizer.setTimerResults(&s_timerResults);
+
+                try {
+                    // Create tokens, skip rest of iteration if failed
+                    {
+                        Timer timer("Tokenizer::createTokens", mSettings.showtime, &s_timerResults);
+                        simplecpp::TokenList tokensP = preprocessor.preprocess(tokens1, mCurrentConfig, files, true);
+                        tokenizer.createTokens(std::move(tokensP));
+                    }
+                    hasValidConfig = true;
 
-            try {
-                // Create tokens, skip rest of iteration if failed
-                {
-                    Timer timer("Tokenizer::createTokens", mSettings.showtime, &s_timerResults);
-                    simplecpp::TokenList tokensP = preprocessor.preprocess(tokens1, mCurrentConfig, files, true);
-                    tokenizer.createTokens(std::move(tokensP));
-                }
-                hasValidConfig = true;
+                    // If only errors are printed, print filename after the check
+                    if (!mSettings.quiet && (!mCurrentConfig.empty() || checkCount > 1)) {
+                        std::string fixedpath = Path::simplifyPath(filename);
+                        fixedpath = Path::toNativeSeparators(fixedpath);
+                        mErrorLogger.reportOut("Checking " + fixedpath + ": " + mCurrentConfig + "...");
+                    }
 
-                // If only errors are printed, print filename after the check
-                if (!mSettings.quiet && (!mCurrentConfig.empty() || checkCount > 1)) {
-                    std::string fixedpath = Path::simplifyPath(filename);
-                    fixedpath = Path::toNativeSeparators(fixedpath);
-                    mErrorLogger.reportOut("Checking " + fixedpath + ": " + mCurrentConfig + "...");
-                }
+                    if (!tokenizer.tokens())
+                        continue;
 
-                if (!tokenizer.tokens())
-                    continue;
+                    // skip rest of iteration if just checking configuration
+                    if (mSettings.checkConfiguration)
+                        continue;
 
-                // skip rest of iteration if just checking configuration
-                if (mSettings.checkConfiguration)
-                    continue;
+                    // Skip if an earlier configuration had the same tokens, the templates
+                    // etc would be expanded into the same simplified token list
+                    unsigned long long hash = 0;
+                    if (skipSimplifiedDuplicates) {
+                        hash = tokenizer.list.calculateHash();
+                        if (simplifiedHashes.find(hash) != simplifiedHashes.end()) {
+                            if (mSettings.debugwarnings)
+                                purgedConfigurationMessage(filename, mCurrentConfig);
+                            continue;
+                        }
+                    }
 
-                // Check raw tokens
-                checkRawTokens(tokenizer);
+                    // Check raw tokens
+                    checkRawTokens(tokenizer);
 
-                // Simplify tokens into normal form, skip rest of iteration if failed
-                Timer timer2("Tokenizer::simplifyTokens1", mSettings.showtime, &s_timerResults);
-                bool result = tokenizer.simplifyTokens1(mCurrentConfig);
-                timer2.stop();
-                if (!result)
-                    continue;
+                    // Simplify tokens into normal form, skip rest of iteration if failed
+                    Timer timer2("Tokenizer::simplifyTokens1", mSettings.showtime, &s_timerResults);
+                    bool result = tokenizer.simplifyTokens1(mCurrentConfig);
+                    timer2.stop();
+                    if (!result)
+                        continue;
 
-                // dump xml if --dump
-                if ((mSettings.dump || !mSettings.addons.empty()) && fdump.is_open()) {
-                    fdump << "<dump cfg=\"" << ErrorLogger::toxml(mCurrentConfig) << "\">" << std::endl;
-                    fdump << "  <standards>" << std::endl;
-                    fdump << "    <c version=\"" << mSettings.standards.getC() << "\"/>" << std::endl;
-                    fdump << "    <cpp version=\"" << mSettings.standards.getCPP() << "\"/>" << std::endl;
-                    fdump << "  </standards>" << std::endl;
-                    preprocessor.dump(fdump);
-                    tokenizer.dump(fdump);
-                    fdump << "</dump>" << std::endl;
-                }
+                    // dump xml if --dump
+                    if ((mSettings.dump || !mSettings.addons.empty()) && fdump.is_open()) {
+                        Timer t("CppCheck::dump", mSettings.showtime, &s_timerResults);
+                        fdump << "<dump cfg=\"" << ErrorLogger::toxml(mCurrentConfig) << "\">\n";
+                        fdump << "  <standards>\n";
+                        fdump << "    <c version=\"" << mSettings.standards.getC() << "\"/>\n";
+                        fdump << "    <cpp version=\"" << mSettings.standards.getCPP() << "\"/>\n";
+                        fdump << "  </standards>\n";
+                        preprocessor.dump(fdump);
+                        tokenizer.dump(fdump);
+                        fdump << "</dump>\n";
+                    }
 
-                // Skip if we already met the same simplified token list
-                if (mSettings.force || mSettings.maxConfigs > 1) {
-                    const unsigned long long checksum = tokenizer.list.calculateChecksum();
-                    if (checksums.find(checksum) != checksums.end()) {
-                        if (mSettings.debugwarnings)
-                            purgedConfigurationMessage(filename, mCurrentConfig);
-                        continue;
+                    // Skip if we already met the same simplified token list
+                    if (mSettings.force || mSettings.maxConfigs > 1) {
+                        if (skipSimplifiedDuplicates)
+                            simplifiedHashes.insert(hash);
+                        const unsigned long long checksum = tokenizer.list.calculateChecksum();
+                        if (checksums.find(checksum) != checksums.end()) {
+                            if (mSettings.debugwarnings)
+                                purgedConfigurationMessage(filename, mCurrentConfig);
+                            continue;
+                        }
+                        checksums.insert(checksum);
                     }
-                    checksums.insert(checksum);
-                }
 
-                // Check normal tokens
-                checkNormalTokens(tokenizer);
+                    // Check normal tokens
+                    checkNormalTokens(tokenizer);
 
-                // Analyze info..
-                if (!mSettings.buildDir.empty())
-                    checkUnusedFunctions.parseTokens(tokenizer, filename.c_str(), &mSettings);
+                    // Analyze info..
+                    if (!mSettings.buildDir.empty() || mFileInfoCallback)
+                        checkUnusedFunctions.parseTokens(tokenizer, filename.c_str(), &mSettings);
 
-                // simplify more if required, skip rest of iteration if failed
-                if (mSimplify && hasRule("simple")) {
-                    std::cout << "Handling of \"simple\" rules is deprecated and will be removed in Cppcheck 2.5." << std::endl;
+                    // simplify more if required, skip rest of iteration if failed
+                    if (mSimplify && hasRule("simple")) {
+                        std::cout << "Handling of \"simple\" rules is deprecated and will be removed in Cppcheck 2.5." << std::endl;
 
-                    // if further simplification fails then skip rest of iteration
-                    Timer timer3("Tokenizer::simplifyTokenList2", mSettings.showtime, &s_timerResults);
-                    result = tokenizer.simplifyTokenList2();
-                    timer3.stop();
-                    if (!result)
-                        continue;
+                        // if further simplification fails then skip rest of iteration
+                        Timer timer3("Tokenizer::simplifyTokenList2", mSettings.showtime, &s_timerResults);
+                        result = tokenizer.simplifyTokenList2();
+                        timer3.stop();
+                        if (!result)
+                            continue;
 
-                    if (!Settings::terminated())
-                        executeRules("simple", tokenizer);
-                }
+                        if (!Settings::terminated())
+                            executeRules("simple", tokenizer, *this);
+                    }
 
-            } catch (const simplecpp::Output &o) {
-                // #error etc during preprocessing
-                configurationError.push_back((mCurrentConfig.empty() ? "\'\'" : mCurrentConfig) + " : [" + o.location.file() + ':' + MathLib::toString(o.location.line) + "] " + o.msg);
-                --checkCount; // don't count invalid configurations
-                continue;
+                } catch (const simplecpp::Output &o) {
+                    // #error etc during preprocessing
+                    configurationError.push_back(getConfigurationError(mCurrentConfig, o));
+                    --checkCount; // don't count invalid configurations
+                    continue;
 
-            } catch (const InternalError &e) {
-                std::list<ErrorMessage::FileLocation> locationList;
-                if (e.token) {
-                    ErrorMessage::FileLocation loc(e.token, &tokenizer.list);
-                    locationList.push_back(loc);
-                } else {
-                    ErrorMessage::FileLocation loc(tokenizer.list.getSourceFilePath(), 0, 0);
-                    ErrorMessage::FileLocation loc2(filename, 0, 0);
-                    locationList.push_back(loc2);
-                    locationList.push_back(loc);
+                } catch (const InternalError &e) {
+                    const ErrorMessage errmsg = getInternalErrorMessage(e, tokenizer, filename);
+                    if (errmsg.severity == Severity::error || mSettings.isEnabled(errmsg.severity))
+                        reportErr(errmsg);
                 }
-                ErrorMessage errmsg(locationList,
-                                    tokenizer.list.getSourceFilePath(),
-                                    Severity::error,
-                                    e.errorMessage,
-                                    e.id,
-                                    false);
-
-                if (errmsg.severity == Severity::error || mSettings.isEnabled(errmsg.severity))
-                    reportErr(errmsg);
             }
         }
 
@@ -816,12 +967,13 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
         }
 
         // dumped all configs, close root </dumps> element now
-        if ((mSettings.dump || !mSettings.addons.empty()) && fdump.is_open())
-            fdump << "</dumps>" << std::endl;
-
-        if (!mSettings.addons.empty()) {
+        if ((mSettings.dump || !mSettings.addons.empty()) && fdump.is_open()) {
+            Timer t("CppCheck::dump", mSettings.showtime, &s_timerResults);
+            fdump << "</dumps>\n";
             fdump.close();
+        }
 
+        if (!mSettings.addons.empty()) {
             for (const std::string &addon : mSettings.addons) {
                 struct AddonInfo addonInfo;
                 const std::string &failedToGetAddonInfo = addonInfo.getAddonInfo(addon, mSettings.exename);
@@ -831,7 +983,7 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
                     continue;
                 }
                 const std::string results =
-                    executeAddon(addonInfo, mSettings.addonPython, dumpFile, mExecuteCommand);
+                    executeAddon(getPythonExe(addonInfo.python), addonInfo.scriptFile, addonInfo.args, dumpFile);
                 std::istringstream istr(results);
                 std::string line;
 
@@ -870,6 +1022,9 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
             std::remove(dumpFile.c_str());
         }
 
+        if (saveDependencies && !preprocessor.hasMissingIncludes() && preprocessor.getMissedIncludeFiles(tokens1, &missedFiles))
+            dependencies = files;
+
     } catch (const std::runtime_error &e) {
         internalError(filename, e.what());
     } catch (const std::bad_alloc &e) {
@@ -879,20 +1034,359 @@ unsigned int CppCheck::checkFile(const std::string& filename, const std::string
         mExitCode=1; // e.g. reflect a syntax error
     }
 
-    mAnalyzerInformation.setFileInfo("CheckUnusedFunctions", checkUnusedFunctions.analyzerInfo());
+    const std::string unusedFunctionsInfo = checkUnusedFunctions.analyzerInfo();
+    mAnalyzerInformation.setFileInfo("CheckUnusedFunctions", unusedFunctionsInfo);
+    if (mFileInfoCallback) {
+        mTranslationUnitInfo.sourcefile = filename;
+        mTranslationUnitInfo.cfg = cfgname;
+        mTranslationUnitInfo.fileInfo.emplace_back("CheckUnusedFunctions", unusedFunctionsInfo);
+        mFileInfoCallback(mTranslationUnitInfo);
+        mTranslationUnitInfo.fileInfo.clear();
+    }
+    if (!dependencies.empty())
+        mAnalyzerInformation.setDependencies(settingsChecksum, dependencies, missedFiles, analysisStart);
     mAnalyzerInformation.close();
 
     // In jointSuppressionReport mode, unmatched suppressions are
     // collected after all files are processed
     if (!mSettings.jointSuppressionReport && (mSettings.isEnabled(Settings::INFORMATION) || mSettings.checkConfiguration)) {
-        reportUnmatchedSuppressions(mSettings.nomsg.getUnmatchedLocalSuppressions(filename, isUnusedFunctionCheckEnabled()));
+        // Unused functions are only known after the whole program analysis
+        reportUnmatchedSuppressions(mSettings.nomsg.getUnmatchedLocalSuppressions(filename, mSettings.jobs == 1 && isUnusedFunctionCheckEnabled()));
     }
 
-    mErrorList.clear();
+    mReportedErrors.clear();
 
     return mExitCode;
 }
 
+namespace {
+    /** Buffers everything that is reported while a configuration or a whole program check is run in a worker thread */
+    class ConfigurationLogger : public ErrorLogger {
+    public:
+        void reportOut(const std::string &outmsg) OVERRIDE {
+            mReports.emplace_back(Report::Type::OUT, outmsg, ErrorMessage());
+        }
+
+        void reportErr(const ErrorMessage &msg) OVERRIDE {
+            mReports.emplace_back(Report::Type::ERR, emptyString, msg);
+        }
+
+        void reportInfo(const ErrorMessage &msg) OVERRIDE {
+            mReports.emplace_back(Report::Type::INFO, emptyString, msg);
+        }
+
+        void bughuntingReport(const std::string & /*str*/) OVERRIDE {
+            // bug hunting is not done in parallel
+        }
+
+        std::size_t size() const {
+            return mReports.size();
+        }
+
+        /** Report the first @p count buffered reports to @p errorLogger */
+        void replay(ErrorLogger &errorLogger, std::size_t count) const {
+            for (const Report &report : mReports) {
+                if (count-- == 0)
+                    break;
+                switch (report.type) {
+                case Report::Type::OUT:
+                    errorLogger.reportOut(report.outmsg);
+                    break;
+                case Report::Type::ERR:
+                    errorLogger.reportErr(report.msg);
+                    break;
+                case Report::Type::INFO:
+                    errorLogger.reportInfo(report.msg);
+                    break;
+                }
+            }
+        }
+
+    private:
+        struct Report {
+            enum class Type { OUT, ERR, INFO };
+            Report(Type t, const std::string &o, const ErrorMessage &m) : type(t), outmsg(o), msg(m) {}
+            Type type;
+            std::string outmsg;
+            ErrorMessage msg;
+        };
+        std::list<Report> mReports;
+    };
+
+    /** Result of checking one configuration in a worker thread */
+    struct ConfigurationResult {
+        explicit ConfigurationResult(const std::string &cfg)
+            : currentConfig(cfg)
+            , done(false)
+            , valid(false)
+            , hasChecksum(false)
+            , checksum(0)
+            , reportsBeforeChecksum(0) {
+        }
+
+        const std::string currentConfig;
+        ConfigurationLogger logger;
+
+        /**
+         * The checked tokens. The file info is collected from them when the results are
+         * merged, so nothing is collected for the configurations that are purged.
+         */
+        std::unique_ptr<Tokenizer> tokenizer;
+
+        /** The worker thread has finished this configuration */
+        bool done;
+
+        /** The configuration could be preprocessed */
+        bool valid;
+
+        /** Preprocessor error if the configuration is invalid */
+        std::string configurationError;
+
+        /** Checksum of the simplified token list, used to skip duplicate configurations */
+        bool hasChecksum;
+        unsigned long long checksum;
+        std::size_t reportsBeforeChecksum;
+
+        /** Unexpected exception, it is rethrown when the results are merged */
+        std::exception_ptr exception;
+    };
+}
+
+void CppCheck::checkConfigurations(const std::string &filename,
+                                   Preprocessor &preprocessor,
+                                   const simplecpp::TokenList &tokens1,
+                                   std::vector<std::string> &files,
+                                   const std::set<std::string> &configurations,
+                                   CheckUnusedFunctions &checkUnusedFunctions,
+                                   bool &hasValidConfig,
+                                   std::list<std::string> &configurationError)
+{
+    std::vector<std::unique_ptr<ConfigurationResult>> results;
+    for (const std::string &currCfg : configurations)
+        results.emplace_back(new ConfigurationResult(getCurrentConfig(mSettings.userDefines, currCfg)));
+
+    // The preprocessor and the loaded files are shared by all threads
+    std::mutex preprocessorSync;
+    // The finished configurations are merged in order while the workers check the next ones
+    std::mutex doneSync;
+    std::condition_variable doneChanged;
+    std::size_t activeWorkers = 0;
+    std::atomic<bool> stopWorkers(false);
+    // The first configuration that has a given checksum
+    std::mutex checksumSync;
+    std::map<unsigned long long, std::size_t> checksumOwner;
+    // The first configuration that has a given token list before the simplification
+    std::map<unsigned long long, std::size_t> hashOwner;
+    const bool skipSimplifiedDuplicates = mSettings.force || mSettings.maxConfigs > 1;
+
+    std::atomic<std::size_t> nextConfiguration(0);
+    std::atomic<int> validConfigurations(0);
+
+    const auto checkConfiguration = [&](std::size_t index) {
+        ConfigurationResult &result = *results[index];
+
+        result.tokenizer.reset(new Tokenizer(&mSettings, &result.logger));
+        Tokenizer &tokenizer = *result.tokenizer;
+        tokenizer.setPreprocessor(&preprocessor);
+        if (mSettings.showtime != SHOWTIME_MODES::SHOWTIME_NONE)
+            tokenizer.setTimerResults(&s_timerResults);
+
+        try {
+            // Create tokens, skip rest of configuration if failed
+            {
+                std::lock_guard<std::mutex> lock(preprocessorSync);
+                preprocessor.setErrorLogger(&result.logger);
+                try {
+                    Timer timer("Tokenizer::createTokens", mSettings.showtime, &s_timerResults);
+                    simplecpp::TokenList tokensP = preprocessor.preprocess(tokens1, result.currentConfig, files, true);
+                    tokenizer.createTokens(std::move(tokensP));
+                } catch (...) {
+                    preprocessor.setErrorLogger(this);
+                    throw;
+                }
+                preprocessor.setErrorLogger(this);
+            }
+            result.valid = true;
+            ++validConfigurations;
+
+            if (!tokenizer.tokens()) {
+                result.tokenizer.reset();
+                return;
+            }
+
+            // Skip if an earlier configuration with the same tokens has been simplified, the
+            // templates etc would be expanded into the same simplified token list
+            if (skipSimplifiedDuplicates) {
+                const unsigned long long hash = tokenizer.list.calculateHash();
+                std::lock_guard<std::mutex> lock(checksumSync);
+                const std::map<unsigned long long, std::size_t>::iterator owner = hashOwner.find(hash);
+                if (owner == hashOwner.end())
+                    hashOwner[hash] = index;
+                else if (owner->second < index) {
+                    const ConfigurationResult &ownerResult = *results[owner->second];
+                    if (ownerResult.hasChecksum) {
+                        result.checksum = ownerResult.checksum;
+                        result.hasChecksum = true;
+                        result.reportsBeforeChecksum = result.logger.size();
+                        result.tokenizer.reset();
+                        return;
+                    }
+                } else
+                    owner->second = index;
+            }
+
+            // Check raw tokens
+            executeRules("raw", tokenizer, result.logger);
+
+            // Simplify tokens into normal form, skip rest of configuration if failed
+            Timer timer2("Tokenizer::simplifyTokens1", mSettings.showtime, &s_timerResults);
+            const bool simplified = tokenizer.simplifyTokens1(result.currentConfig);
+            timer2.stop();
+            if (!simplified) {
+                result.tokenizer.reset();
+                return;
+            }
+
+            // Skip if an earlier configuration has the same simplified token list.
+            // Which configurations are purged is decided when the results are merged.
+            if (mSettings.force || mSettings.maxConfigs > 1) {
+                const unsigned long long checksum = tokenizer.list.calculateChecksum();
+
+                std::lock_guard<std::mutex> lock(checksumSync);
+                result.checksum = checksum;
+                result.hasChecksum = true;
+                result.reportsBeforeChecksum = result.logger.size();
+                const std::map<unsigned long long, std::size_t>::const_iterator owner = checksumOwner.find(result.checksum);
+                if (owner != checksumOwner.end() && owner->second < index) {
+                    result.tokenizer.reset();
+                    return;
+                }
+                checksumOwner[result.checksum] = index;
+            }
+
+            // Check normal tokens
+            runChecks(tokenizer, result.logger);
+            if (Settings::terminated() || Tokenizer::isMaxTime()) {
+                result.tokenizer.reset();
+                return;
+            }
+
+            executeRules("normal", tokenizer, result.logger);
+        } catch (const simplecpp::Output &o) {
+            // #error etc during preprocessing
+            result.configurationError = getConfigurationError(result.currentConfig, o);
+            result.tokenizer.reset();
+        } catch (const InternalError &e) {
+            const ErrorMessage errmsg = getInternalErrorMessage(e, tokenizer, filename);
+            if (errmsg.severity == Severity::error || mSettings.isEnabled(errmsg.severity))
+                result.logger.reportErr(errmsg);
+            result.tokenizer.reset();
+        } catch (...) {
+            result.exception = std::current_exception();
+            result.tokenizer.reset();
+        }
+    };
+
+    const auto worker = [&]() {
+        for (;;) {
+            // Configurations after the first maxConfigs valid ones are not checked
+            const bool limitReached = !mSettings.force && validConfigurations >= mSettings.maxConfigs;
+            const std::size_t index = nextConfiguration++;
+            if (limitReached || stopWorkers || index >= results.size() || Settings::terminated())
+                break;
+            checkConfiguration(index);
+            std::lock_guard<std::mutex> lock(doneSync);
+            results[index]->done = true;
+            doneChanged.notify_all();
+        }
+        std::lock_guard<std::mutex> lock(doneSync);
+        --activeWorkers;
+        doneChanged.notify_all();
+    };
+
+    std::vector<std::thread> threads;
+    const std::size_t threadCount = std::min<std::size_t>(mSettings.configJobs, results.size());
+    activeWorkers = threadCount;
+    for (std::size_t i = 0; i < threadCount; ++i)
+        threads.emplace_back(worker);
+
+    // Report the results in the same order as when the configurations are checked one after another.
+    // A result is merged as soon as it and all configurations before it are finished.
+    std::exception_ptr exception;
+    std::set<unsigned long long> checksums;
+    unsigned int checkCount = 0;
+    for (const std::unique_ptr<ConfigurationResult> &result : results) {
+        {
+            std::unique_lock<std::mutex> lock(doneSync);
+            doneChanged.wait(lock, [&]() {
+                return result->done || activeWorkers == 0;
+            });
+        }
+
+        // bail out if terminated
+        if (Settings::terminated() || !result->done)
+            break;
+
+        // Check only a few configurations (default 12), after that bail out, unless --force
+        // was used.
+        if (!mSettings.force && ++checkCount > mSettings.maxConfigs)
+            break;
+
+        if (!result->configurationError.empty()) {
+            configurationError.push_back(result->configurationError);
+            --checkCount; // don't count invalid configurations
+            continue;
+        }
+
+        mCurrentConfig = result->currentConfig;
+
+        if (result->valid) {
+            hasValidConfig = true;
+
+            // If only errors are printed, print filename after the check
+            if (!mSettings.quiet && (!mCurrentConfig.empty() || checkCount > 1)) {
+                std::string fixedpath = Path::simplifyPath(filename);
+                fixedpath = Path::toNativeSeparators(fixedpath);
+                mErrorLogger.reportOut("Checking " + fixedpath + ": " + mCurrentConfig + "...");
+            }
+        }
+
+        const bool purged = result->hasChecksum && !checksums.insert(result->checksum).second;
+        result->logger.replay(*this, purged ? result->reportsBeforeChecksum : result->logger.size());
+        if (purged) {
+            if (mSettings.debugwarnings)
+                purgedConfigurationMessage(filename, mCurrentConfig);
+            result->tokenizer.reset();
+            continue;
+        }
+
+        if (result->exception) {
+            exception = result->exception;
+            break;
+        }
+
+        if (result->tokenizer) {
+            // Analyse the tokens..
+            std::list<std::pair<std::string, Check::FileInfo *>> fileInfo;
+            getFileInfo(*result->tokenizer, fileInfo);
+            addFileInfo(fileInfo);
+
+            // Analyze info..
+            if (!mSettings.buildDir.empty() || mFileInfoCallback)
+                checkUnusedFunctions.parseTokens(*result->tokenizer, filename.c_str(), &mSettings);
+
+            result->tokenizer.reset();
+        }
+    }
+
+    stopWorkers = true;
+    for (std::thread &t : threads)
+        t.join();
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
 void CppCheck::internalError(const std::string &filename, const std::string &msg)
 {
     const std::string fixedpath = Path::toNativeSeparators(filename);
@@ -916,13 +1410,18 @@ void CppCheck::internalError(const std::string &filename, const std::string &msg
     }
 }
 
+void CppCheck::printTimerResults(SHOWTIME_MODES mode)
+{
+    s_timerResults.showResults(mode);
+}
+
 //---------------------------------------------------------------------------
 // CppCheck - A function that checks a raw token list
 //---------------------------------------------------------------------------
 void CppCheck::checkRawTokens(const Tokenizer &tokenizer)
 {
     // Execute rules for "raw" code
-    executeRules("raw", tokenizer);
+    executeRules("raw", tokenizer, *this);
 }
 
 //---------------------------------------------------------------------------
@@ -934,39 +1433,62 @@ void CppCheck::checkNormalTokens(const Tokenizer &tokenizer)
     if (mSettings.bugHunting)
         ExprEngine::runChecks(this, &tokenizer, &mSettings);
     else {
-        // call all "runChecks" in all registered Check classes
-        for (Check *check : Check::instances()) {
-            if (Settings::terminated())
-                return;
-
-            if (Tokenizer::isMaxTime())
-                return;
-
-            Timer timerRunChecks(check->name() + "::runChecks", mSettings.showtime, &s_timerResults);
-            check->runChecks(&tokenizer, &mSettings, this);
-        }
+        runChecks(tokenizer, *this);
+        if (Settings::terminated() || Tokenizer::isMaxTime())
+            return;
 
         if (mSettings.clang)
             // TODO: Use CTU for Clang analysis
             return;
 
         // Analyse the tokens..
+        std::list<std::pair<std::string, Check::FileInfo *>> fileInfo;
+        getFileInfo(tokenizer, fileInfo);
+        addFileInfo(fileInfo);
 
-        CTU::FileInfo *fi1 = CTU::getFileInfo(&tokenizer);
-        if (fi1) {
-            mFileInfo.push_back(fi1);
-            mAnalyzerInformation.setFileInfo("ctu", fi1->toString());
-        }
+        executeRules("normal", tokenizer, *this);
+    }
+}
 
-        for (const Check *check : Check::instances()) {
-            Check::FileInfo *fi = check->getFileInfo(&tokenizer, &mSettings);
-            if (fi != nullptr) {
-                mFileInfo.push_back(fi);
-                mAnalyzerInformation.setFileInfo(check->name(), fi->toString());
-            }
-        }
+void CppCheck::runChecks(const Tokenizer &tokenizer, ErrorLogger &errorLogger)
+{
+    // call all "runChecks" in all registered Check classes
+    for (Check *check : Check::instances()) {
+        if (Settings::terminated())
+            return;
+
+        if (Tokenizer::isMaxTime())
+            return;
 
-        executeRules("normal", tokenizer);
+        Timer timerRunChecks(check->name() + "::runChecks", mSettings.showtime, &s_timerResults);
+        check->runChecks(&tokenizer, &mSettings, &errorLogger);
+    }
+}
+
+void CppCheck::getFileInfo(const Tokenizer &tokenizer, std::list<std::pair<std::string, Check::FileInfo *>> &fileInfo) const
+{
+    CTU::FileInfo *fi1 = CTU::getFileInfo(&tokenizer);
+    if (fi1)
+        fileInfo.emplace_back("ctu", fi1);
+
+    for (const Check *check : Check::instances()) {
+        Check::FileInfo *fi = check->getFileInfo(&tokenizer, &mSettings);
+        if (fi != nullptr)
+            fileInfo.emplace_back(check->name(), fi);
+    }
+}
+
+void CppCheck::addFileInfo(const std::list<std::pair<std::string, Check::FileInfo *>> &fileInfo)
+{
+    for (const std::pair<std::string, Check::FileInfo *> &fi : fileInfo) {
+        const std::string data = fi.second->toString();
+        mAnalyzerInformation.setFileInfo(fi.first, data);
+        if (mFileInfoCallback) {
+            mTranslationUnitInfo.fileInfo.emplace_back(fi.first, data);
+            delete fi.second;
+        } else {
+            mFileInfo.push_back(fi.second);
+        }
     }
 }
 
@@ -1117,13 +1639,81 @@ static const char * pcreErrorCodeToString(const int pcreExecRet)
     return "";
 }
 
+namespace {
+    /** A rule pattern compiled by pcre. It is shared by all files and threads. */
+    class CompiledRule {
+    public:
+        explicit CompiledRule(const std::string &pattern) : re(nullptr), extra(nullptr) {
+            const char *pcreCompileErrorStr = nullptr;
+            int erroffset = 0;
+            re = pcre_compile(pattern.c_str(),0,&pcreCompileErrorStr,&erroffset,nullptr);
+            if (!re) {
+                if (pcreCompileErrorStr) {
+                    errorId = "pcre_compile";
+                    errorMessage = "pcre_compile failed: " + std::string(pcreCompileErrorStr);
+                }
+                return;
+            }
+
+            // Optimize the regex, but only if PCRE_CONFIG_JIT is available
+#ifdef PCRE_CONFIG_JIT
+            const char *pcreStudyErrorStr = nullptr;
+            extra = pcre_study(re, PCRE_STUDY_JIT_COMPILE, &pcreStudyErrorStr);
+            // pcre_study() returns NULL for both errors and when it can not optimize the regex.
+            // The last argument is how one checks for errors.
+            // It is NULL if everything works, and points to an error string otherwise.
+            if (pcreStudyErrorStr) {
+                errorId = "pcre_study";
+                errorMessage = "pcre_study failed: " + std::string(pcreStudyErrorStr);
+                // pcre_compile() worked, but pcre_study() returned an error. Free the resources allocated by pcre_compile().
+                pcre_free(re);
+                re = nullptr;
+            }
+#endif
+        }
+
+        ~CompiledRule() {
+            if (re)
+                pcre_free(re);
+#ifdef PCRE_CONFIG_JIT
+            // Free up the EXTRA PCRE value (may be NULL at this point)
+            if (extra)
+                pcre_free_study(extra);
+#endif
+        }
+
+        CompiledRule(const CompiledRule &) = delete;
+        CompiledRule &operator=(const CompiledRule &) = delete;
+
+        pcre *re;
+        pcre_extra *extra;
+
+        // Compilation error that is reported for each file the rule is used for
+        std::string errorId;
+        std::string errorMessage;
+    };
+}
+
+/** Compile the rule pattern the first time it is used in the process */
+static std::shared_ptr<const CompiledRule> getCompiledRule(const std::string &pattern)
+{
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_ptr<const CompiledRule>> compiledRules;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<const CompiledRule> &compiledRule = compiledRules[pattern];
+    if (!compiledRule)
+        compiledRule = std::make_shared<const CompiledRule>(pattern);
+    return compiledRule;
+}
+
 #endif // HAVE_RULES
 
 
-void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &tokenizer)
+void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &tokenizer, ErrorLogger &errorLogger)
 {
     (void)tokenlist;
     (void)tokenizer;
+    (void)errorLogger;
 
 #ifdef HAVE_RULES
     // There is no rule to execute
@@ -1131,62 +1721,40 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
         return;
 
     // Write all tokens in a string that can be parsed by pcre
-    std::ostringstream ostr;
-    for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next())
-        ostr << " " << tok->str();
-    const std::string str(ostr.str());
+    std::string str;
+    for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
+        str += ' ';
+        str += tok->str();
+    }
+
+    // End position of each token in the string, to determine the location of a match.
+    // It is created when the first match is found and used for all the rules.
+    std::vector<std::size_t> tokenEnds;
+    std::vector<const Token *> tokens;
 
     for (const Settings::Rule &rule : mSettings.rules) {
         if (rule.pattern.empty() || rule.id.empty() || rule.severity == Severity::none || rule.tokenlist != tokenlist)
             continue;
 
-        const char *pcreCompileErrorStr = nullptr;
-        int erroffset = 0;
-        pcre * const re = pcre_compile(rule.pattern.c_str(),0,&pcreCompileErrorStr,&erroffset,nullptr);
-        if (!re) {
-            if (pcreCompileErrorStr) {
-                const std::string msg = "pcre_compile failed: " + std::string(pcreCompileErrorStr);
+        const std::shared_ptr<const CompiledRule> compiledRule = getCompiledRule(rule.pattern);
+        if (!compiledRule->re) {
+            if (!compiledRule->errorMessage.empty()) {
                 const ErrorMessage errmsg(std::list<ErrorMessage::FileLocation>(),
                                           emptyString,
                                           Severity::error,
-                                          msg,
-                                          "pcre_compile",
+                                          compiledRule->errorMessage,
+                                          compiledRule->errorId,
                                           false);
 
-                reportErr(errmsg);
+                errorLogger.reportErr(errmsg);
             }
             continue;
         }
 
-        // Optimize the regex, but only if PCRE_CONFIG_JIT is available
-#ifdef PCRE_CONFIG_JIT
-        const char *pcreStudyErrorStr = nullptr;
-        pcre_extra * const pcreExtra = pcre_study(re, PCRE_STUDY_JIT_COMPILE, &pcreStudyErrorStr);
-        // pcre_study() returns NULL for both errors and when it can not optimize the regex.
-        // The last argument is how one checks for errors.
-        // It is NULL if everything works, and points to an error string otherwise.
-        if (pcreStudyErrorStr) {
-            const std::string msg = "pcre_study failed: " + std::string(pcreStudyErrorStr);
-            const ErrorMessage errmsg(std::list<ErrorMessage::FileLocation>(),
-                                      emptyString,
-                                      Severity::error,
-                                      msg,
-                                      "pcre_study",
-                                      false);
-
-            reportErr(errmsg);
-            // pcre_compile() worked, but pcre_study() returned an error. Free the resources allocated by pcre_compile().
-            pcre_free(re);
-            continue;
-        }
-#else
-        const pcre_extra * const pcreExtra = nullptr;
-#endif
-
         int pos = 0;
         int ovector[30]= {0};
         while (pos < (int)str.size()) {
-            const int pcreExecRet = pcre_exec(re, pcreExtra, str.c_str(), (int)str.size(), pos, 0, ovector, 30);
+            const int pcreExecRet = pcre_exec(compiledRule->re, compiledRule->extra, str.c_str(), (int)str.size(), pos, 0, ovector, 30);
             if (pcreExecRet < 0) {
                 const std::string errorMessage = pcreErrorCodeToString(pcreExecRet);
                 if (!errorMessage.empty()) {
@@ -1197,7 +1765,7 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
                                               "pcre_exec",
                                               false);
 
-                    reportErr(errmsg);
+                    errorLogger.reportErr(errmsg);
                 }
                 break;
             }
@@ -1212,15 +1780,20 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
             loc.setfile(tokenizer.list.getSourceFilePath());
             loc.line = 0;
 
-            std::size_t len = 0;
-            for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
-                len = len + 1U + tok->str().size();
-                if (len > pos1) {
-                    loc.setfile(tokenizer.list.getFiles().at(tok->fileIndex()));
-                    loc.line = tok->linenr();
-                    break;
+            if (tokens.empty()) {
+                std::size_t len = 0;
+                for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
+                    len = len + 1U + tok->str().size();
+                    tokenEnds.push_back(len);
+                    tokens.push_back(tok);
                 }
             }
+            const std::vector<std::size_t>::const_iterator it = std::upper_bound(tokenEnds.cbegin(), tokenEnds.cend(), (std::size_t)pos1);
+            if (it != tokenEnds.cend()) {
+                const Token *tok = tokens[it - tokenEnds.cbegin()];
+                loc.setfile(tokenizer.list.getFiles().at(tok->fileIndex()));
+                loc.line = tok->linenr();
+            }
 
             const std::list<ErrorMessage::FileLocation> callStack(1, loc);
 
@@ -1233,16 +1806,8 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
             const ErrorMessage errmsg(callStack, tokenizer.list.getSourceFilePath(), rule.severity, summary, rule.id, false);
 
             // Report error
-            reportErr(errmsg);
+            errorLogger.reportErr(errmsg);
         }
-
-        pcre_free(re);
-#ifdef PCRE_CONFIG_JIT
-        // Free up the EXTRA PCRE value (may be NULL at this point)
-        if (pcreExtra) {
-            pcre_free_study(pcreExtra);
-        }
-#endif
     }
 #endif
 }
@@ -1326,12 +1891,13 @@ void CppCheck::reportErr(const ErrorMessage &msg)
     if (!mSettings.library.reportErrors(msg.file0))
         return;
 
-    const std::string errmsg = msg.toString(mSettings.verbose);
-    if (errmsg.empty())
+    // Empty messages are not reported
+    if (msg.callStack.empty() && msg.severity == Severity::none && (mSettings.verbose ? msg.verboseMessage() : msg.shortMessage()).empty())
         return;
 
     // Alert only about unique errors
-    if (std::find(mErrorList.begin(), mErrorList.end(), errmsg) != mErrorList.end())
+    const unsigned long long fingerprint = msg.fingerprint(mSettings.verbose);
+    if (mReportedErrors.contains(fingerprint))
         return;
 
     const Suppressions::ErrorMessage errorMessage = msg.toSuppressionsErrorMessage();
@@ -1352,7 +1918,7 @@ void CppCheck::reportErr(const ErrorMessage &msg)
         mExitCode = 1;
     }
 
-    mErrorList.push_back(errmsg);
+    mReportedErrors.insert(fingerprint);
 
     mErrorLogger.reportErr(msg);
     mAnalyzerInformation.reportErr(msg, mSettings.verbose);
@@ -1501,8 +2067,7 @@ bool CppCheck::analyseWholeProgram()
             ctu.nestedCalls.insert(ctu.nestedCalls.end(), fi2->nestedCalls.begin(), fi2->nestedCalls.end());
         }
     }
-    for (Check *check : Check::instances())
-        errors |= check->analyseWholeProgram(&ctu, mFileInfo, mSettings, *this);  // TODO: ctu
+    errors |= runWholeProgramChecks(ctu, mFileInfo);
     return errors && (mExitCode > 0);
 }
 
@@ -1511,63 +2076,79 @@ void CppCheck::analyseWholeProgram(const std::string &buildDir, const std::map<s
     (void)files;
     if (buildDir.empty())
         return;
+    analyseWholeProgram(AnalyzerInformation::loadAllFileInfo(buildDir));
+}
+
+bool CppCheck::analyseWholeProgram(const std::list<AnalyzerInformation::TranslationUnitInfo> &fileInfo)
+{
+    bool errors = false;
     if (mSettings.isEnabled(Settings::UNUSED_FUNCTION))
-        CheckUnusedFunctions::analyseWholeProgram(this, buildDir);
+        errors |= CheckUnusedFunctions::analyseWholeProgram(this, fileInfo);
     std::list<Check::FileInfo*> fileInfoList;
     CTU::FileInfo ctuFileInfo;
 
-    // Load all analyzer info data..
-    const std::string filesTxt(buildDir + "/files.txt");
-    std::ifstream fin(filesTxt);
-    std::string filesTxtLine;
-    while (std::getline(fin, filesTxtLine)) {
-        const std::string::size_type firstColon = filesTxtLine.find(':');
-        if (firstColon == std::string::npos)
-            continue;
-        const std::string::size_type lastColon = filesTxtLine.rfind(':');
-        if (firstColon == lastColon)
-            continue;
-        const std::string xmlfile = buildDir + '/' + filesTxtLine.substr(0,firstColon);
-        //const std::string sourcefile = filesTxtLine.substr(lastColon+1);
-
-        tinyxml2::XMLDocument doc;
-        const tinyxml2::XMLError error = doc.LoadFile(xmlfile.c_str());
-        if (error != tinyxml2::XML_SUCCESS)
-            continue;
-
-        const tinyxml2::XMLElement * const rootNode = doc.FirstChildElement();
-        if (rootNode == nullptr)
-            continue;
+    std::unordered_map<std::string, const Check *> checks;
+    for (const Check *check : Check::instances())
+        checks.emplace(check->name(), check);
 
-        for (const tinyxml2::XMLElement *e = rootNode->FirstChildElement(); e; e = e->NextSiblingElement()) {
-            if (std::strcmp(e->Name(), "FileInfo") != 0)
-                continue;
-            const char *checkClassAttr = e->Attribute("check");
-            if (!checkClassAttr)
-                continue;
-            if (std::strcmp(checkClassAttr, "ctu") == 0) {
-                ctuFileInfo.loadFromXml(e);
+    // Load all analyzer info data..
+    for (const AnalyzerInformation::TranslationUnitInfo &tu : fileInfo) {
+        for (const std::pair<std::string, std::string> &fi : tu.fileInfo) {
+            if (fi.first == "ctu") {
+                ctuFileInfo.loadFromString(fi.second);
                 continue;
             }
-            for (Check *check : Check::instances()) {
-                if (checkClassAttr == check->name())
-                    fileInfoList.push_back(check->loadFileInfoFromXml(e));
-            }
+            const std::unordered_map<std::string, const Check *>::const_iterator check = checks.find(fi.first);
+            if (check != checks.end())
+                fileInfoList.push_back(check->second->loadFileInfo(fi.second));
         }
     }
 
     // Set CTU max depth
     CTU::maxCtuDepth = mSettings.maxCtuDepth;
 
-    // Analyse the tokens
-    for (Check *check : Check::instances())
-        check->analyseWholeProgram(&ctuFileInfo, fileInfoList, mSettings, *this);
+    // Analyse the tokens. The unused functions were reported above from
+    // the analyzer info, the global instance only holds the functions of
+    // the files that were checked in this process.
+    errors |= runWholeProgramChecks(ctuFileInfo, fileInfoList, &CheckUnusedFunctions::instance);
 
     for (Check::FileInfo *fi : fileInfoList)
         delete fi;
+
+    return errors && (mExitCode > 0);
+}
+
+bool CppCheck::runWholeProgramChecks(const CTU::FileInfo &ctu, const std::list<Check::FileInfo*> &fileInfo, const Check *skip)
+{
+    std::vector<Check *> checks;
+    for (Check *check : Check::instances()) {
+        if (check != skip)
+            checks.push_back(check);
+    }
+    if (mSettings.jobs <= 1) {
+        bool errors = false;
+        for (Check *check : checks)
+            errors |= check->analyseWholeProgram(&ctu, fileInfo, mSettings, *this);
+        return errors;
+    }
+
+    // Run the checks in parallel and report the errors in the same order as
+    // when the checks are run one after another
+    std::vector<ConfigurationLogger> loggers(checks.size());
+    std::vector<char> errors(checks.size(), 0);
+    CTU::forEachIndex(checks.size(), mSettings.jobs, [&](std::size_t i) {
+        errors[i] = checks[i]->analyseWholeProgram(&ctu, fileInfo, mSettings, loggers[i]);
+    });
+
+    bool ret = false;
+    for (std::size_t i = 0; i < checks.size(); ++i) {
+        loggers[i].replay(*this, loggers[i].size());
+        ret |= (errors[i] != 0);
+    }
+    return ret;
 }
 
 bool CppCheck::isUnusedFunctionCheckEnabled() const
 {
-    return (mSettings.jobs == 1 && mSettings.isEnabled(Settings::UNUSED_FUNCTION));
+    return mSettings.isEnabled(Settings::UNUSED_FUNCTION);
 }
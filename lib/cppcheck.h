@@ -33,13 +33,39 @@
 #include <istream>
 #include <list>
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
+class CheckUnusedFunctions;
+class Preprocessor;
 class Tokenizer;
+namespace simplecpp {
+    class TokenList;
+}
 
 /// @addtogroup Core
 /// @{
 
+/**
+ * @brief A long-lived process that runs an addon, see addons/addonserver.py.
+ * The addon script is loaded once and then executed for one dump file at a time.
+ */
+class CPPCHECKLIB AddonServer {
+public:
+    virtual ~AddonServer() {}
+
+    /**
+     * @brief Execute the addon for a dump file
+     * @param dumpFile the dump file
+     * @param output the output of the addon
+     * @return false if the server has failed, it can't be used after that
+     */
+    virtual bool execute(const std::string &dumpFile, std::string *output) = 0;
+};
+
 /**
  * @brief This is the base class which will use other classes to do
  * static code analysis for C and C++ code to find possible
@@ -125,6 +151,12 @@ public:
      */
     void getErrorMessages();
 
+    /**
+     * @brief Print the timer results of all the CppCheck instances of
+     * the process. The results are collected when --showtime is used.
+     */
+    static void printTimerResults(SHOWTIME_MODES mode);
+
     void tooManyConfigsError(const std::string &file, const std::size_t numberOfConfigurations);
     void purgedConfigurationMessage(const std::string &file, const std::string& configuration);
 
@@ -145,8 +177,33 @@ public:
     /** analyse whole program use .analyzeinfo files */
     void analyseWholeProgram(const std::string &buildDir, const std::map<std::string, std::size_t> &files);
 
-    /** Check if the user wants to check for unused functions
-     * and if it's possible at all */
+    /**
+     * Analyse whole program using the data that was collected from
+     * each TU, see setFileInfoCallback().
+     * Return true if an error is reported.
+     */
+    bool analyseWholeProgram(const std::list<AnalyzerInformation::TranslationUnitInfo> &fileInfo);
+
+    /**
+     * @brief Pass the data for whole program analysis of each checked TU
+     * to a callback instead of keeping it for analyseWholeProgram(). This
+     * is used when the files are checked in parallel.
+     */
+    void setFileInfoCallback(const std::function<void(const AnalyzerInformation::TranslationUnitInfo &)> &callback) {
+        mFileInfoCallback = callback;
+    }
+
+    /**
+     * @brief Run the addons in addon servers that are started by the callback
+     * (exe, args) and kept alive until this object is destroyed. If there
+     * is no callback or it returns nullptr the addon is executed for each
+     * file with the callback for executing a shell command.
+     */
+    void setAddonServerCallback(const std::function<std::unique_ptr<AddonServer>(const std::string &, const std::vector<std::string> &)> &startAddonServer) {
+        mStartAddonServer = startAddonServer;
+    }
+
+    /** Check if the user wants to check for unused functions */
     bool isUnusedFunctionCheckEnabled() const;
 
 private:
@@ -162,9 +219,32 @@ private:
      * @param filename file name
      * @param cfgname  cfg name
      * @param fileStream stream the file content can be read from
+     * @param fileOnDisk the stream reads the file, the results can be reused while the file is unchanged
      * @return number of errors found
      */
-    unsigned int checkFile(const std::string& filename, const std::string &cfgname, std::istream& fileStream);
+    unsigned int checkFile(const std::string& filename, const std::string &cfgname, std::istream& fileStream, bool fileOnDisk);
+
+    /**
+     * @brief Check the preprocessor configurations of a file in parallel (--config-jobs).
+     * The results are reported in the same order as if the configurations were
+     * checked one after another.
+     * @param filename file name
+     * @param preprocessor preprocessor that has loaded the included files
+     * @param tokens1 raw tokens of the file
+     * @param files files used by the raw tokens
+     * @param configurations configurations to check
+     * @param checkUnusedFunctions collects the analyzer info for unused functions
+     * @param hasValidConfig set if a configuration could be preprocessed
+     * @param configurationError preprocessor errors of the invalid configurations
+     */
+    void checkConfigurations(const std::string &filename,
+                             Preprocessor &preprocessor,
+                             const simplecpp::TokenList &tokens1,
+                             std::vector<std::string> &files,
+                             const std::set<std::string> &configurations,
+                             CheckUnusedFunctions &checkUnusedFunctions,
+                             bool &hasValidConfig,
+                             std::list<std::string> &configurationError);
 
     /**
      * @brief Check raw tokens
@@ -178,12 +258,58 @@ private:
      */
     void checkNormalTokens(const Tokenizer &tokenizer);
 
+    /**
+     * @brief Run checks of all registered Check classes
+     * @param tokenizer tokenizer instance
+     * @param errorLogger the errors are reported here
+     */
+    void runChecks(const Tokenizer &tokenizer, ErrorLogger &errorLogger);
+
+    /**
+     * @brief Get file info for whole program analysis
+     * @param tokenizer tokenizer instance
+     * @param fileInfo name and file info of each check that provides it
+     */
+    void getFileInfo(const Tokenizer &tokenizer, std::list<std::pair<std::string, Check::FileInfo *>> &fileInfo) const;
+
+    /**
+     * @brief Store file info for whole program analysis and in the analyzer info
+     * @param fileInfo the file info, ownership is taken over
+     */
+    void addFileInfo(const std::list<std::pair<std::string, Check::FileInfo *>> &fileInfo);
+
+    /**
+     * @brief Run the whole program analysis of all checks. The checks are
+     * run in parallel with -j, the errors are reported in the order of the checks.
+     * @param skip check that is not run, if any
+     * @return true if an error is reported
+     */
+    bool runWholeProgramChecks(const CTU::FileInfo &ctu, const std::list<Check::FileInfo*> &fileInfo, const Check *skip = nullptr);
+
     /**
      * @brief Execute rules, if any
      * @param tokenlist token list to use (normal / simple)
      * @param tokenizer tokenizer
+     * @param errorLogger the rule matches are reported here
      */
-    void executeRules(const std::string &tokenlist, const Tokenizer &tokenizer);
+    void executeRules(const std::string &tokenlist, const Tokenizer &tokenizer, ErrorLogger &errorLogger);
+
+    /**
+     * @brief Get the python executable for an addon. It is auto detected
+     * once if it is not given in the addon info or the settings.
+     * @param addonPython python executable of the addon info
+     */
+    std::string getPythonExe(const std::string &addonPython);
+
+    /**
+     * @brief Execute an addon for a dump file
+     * @param pythonExe python executable
+     * @param scriptFile addon script
+     * @param args extra arguments of the addon
+     * @param dumpFile dump file
+     * @return the output of the addon
+     */
+    std::string executeAddon(const std::string &pythonExe, const std::string &scriptFile, const std::string &args, const std::string &dumpFile);
 
     /**
      * @brief Errors and warnings are directed here.
@@ -203,7 +329,8 @@ private:
 
     void bughuntingReport(const std::string &str) OVERRIDE;
 
-    std::list<std::string> mErrorList;
+    /** @brief The errors of the current file, to report each error only once */
+    ReportedErrors mReportedErrors;
     Settings mSettings;
 
     void reportProgress(const std::string &filename, const char stage[], const std::size_t value) OVERRIDE;
@@ -233,10 +360,25 @@ private:
     /** File info used for whole program analysis */
     std::list<Check::FileInfo*> mFileInfo;
 
+    /** Receives the data for whole program analysis of each TU */
+    std::function<void(const AnalyzerInformation::TranslationUnitInfo &)> mFileInfoCallback;
+
+    /** Data for whole program analysis of the current TU when there is a callback */
+    AnalyzerInformation::TranslationUnitInfo mTranslationUnitInfo;
+
     AnalyzerInformation mAnalyzerInformation;
 
     /** Callback for executing a shell command (exe, args, output) */
     std::function<bool(std::string,std::vector<std::string>,std::string,std::string*)> mExecuteCommand;
+
+    /** Callback for starting an addon server (exe, args) */
+    std::function<std::unique_ptr<AddonServer>(const std::string &, const std::vector<std::string> &)> mStartAddonServer;
+
+    /** The addon servers, key is the command line of the addon. nullptr if the server could not be started. */
+    std::map<std::string, std::unique_ptr<AddonServer>> mAddonServers;
+
+    /** Auto detected python executable */
+    std::string mPythonExe;
 };
 
 /// @}
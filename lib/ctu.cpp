@@ -19,31 +19,20 @@
 
 //---------------------------------------------------------------------------
 #include "ctu.h"
+#include "analyzerinfo.h"
 #include "astutils.h"
 #include "settings.h"
 #include "symboldatabase.h"
 #include "tokenize.h"
 
-#include <tinyxml2.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <iterator>  // back_inserter
+#include <thread>
+#include <utility>
 //---------------------------------------------------------------------------
 
-static const char ATTR_CALL_ID[] = "call-id";
-static const char ATTR_CALL_FUNCNAME[] = "call-funcname";
-static const char ATTR_CALL_ARGNR[] = "call-argnr";
-static const char ATTR_CALL_ARGEXPR[] = "call-argexpr";
-static const char ATTR_CALL_ARGVALUETYPE[] = "call-argvaluetype";
-static const char ATTR_CALL_ARGVALUE[] = "call-argvalue";
-static const char ATTR_WARNING[] = "warning";
-static const char ATTR_LOC_FILENAME[] = "file";
-static const char ATTR_LOC_LINENR[] = "line";
-static const char ATTR_LOC_COLUMN[] = "col";
-static const char ATTR_INFO[] = "info";
-static const char ATTR_MY_ID[] = "my-id";
-static const char ATTR_MY_ARGNR[] = "my-argnr";
-static const char ATTR_MY_ARGNAME[] = "my-argname";
-static const char ATTR_VALUE[] = "value";
-
 int CTU::maxCtuDepth = 2;
 
 std::string CTU::getFunctionId(const Tokenizer *tokenizer, const Function *function)
@@ -60,90 +49,82 @@ CTU::FileInfo::Location::Location(const Tokenizer *tokenizer, const Token *tok)
 
 std::string CTU::FileInfo::toString() const
 {
-    std::ostringstream out;
+    AnalyzerInfoWriter writer;
 
     // Function calls..
-    for (const CTU::FileInfo::FunctionCall &functionCall : functionCalls) {
-        out << functionCall.toXmlString();
-    }
+    writer.writeInt(functionCalls.size());
+    for (const CTU::FileInfo::FunctionCall &functionCall : functionCalls)
+        functionCall.write(writer);
 
     // Nested calls..
-    for (const CTU::FileInfo::NestedCall &nestedCall : nestedCalls) {
-        out << nestedCall.toXmlString() << "\n";
-    }
+    writer.writeInt(nestedCalls.size());
+    for (const CTU::FileInfo::NestedCall &nestedCall : nestedCalls)
+        nestedCall.write(writer);
+
+    return writer.str();
+}
 
-    return out.str();
+static void writeLocation(AnalyzerInfoWriter &writer, const CTU::FileInfo::Location &location)
+{
+    writer.writeString(location.fileName);
+    writer.writeInt(location.lineNumber);
+    writer.writeInt(location.column);
 }
 
-std::string CTU::FileInfo::CallBase::toBaseXmlString() const
+static void readLocation(AnalyzerInfoReader &reader, CTU::FileInfo::Location &location)
 {
-    std::ostringstream out;
-    out << " " << ATTR_CALL_ID << "=\"" << callId << "\""
-        << " " << ATTR_CALL_FUNCNAME << "=\"" << callFunctionName << "\""
-        << " " << ATTR_CALL_ARGNR << "=\"" << callArgNr << "\""
-        << " " << ATTR_LOC_FILENAME << "=\"" << location.fileName << "\""
-        << " " << ATTR_LOC_LINENR << "=\"" << location.lineNumber << "\""
-        << " " << ATTR_LOC_COLUMN << "=\"" << location.column << "\"";
-    return out.str();
+    location.fileName = reader.readString();
+    location.lineNumber = static_cast<int>(reader.readInt());
+    location.column = static_cast<int>(reader.readInt());
 }
 
-std::string CTU::FileInfo::FunctionCall::toXmlString() const
+void CTU::FileInfo::CallBase::writeBase(AnalyzerInfoWriter &writer) const
 {
-    std::ostringstream out;
-    out << "<function-call"
-        << toBaseXmlString()
-        << " " << ATTR_CALL_ARGEXPR << "=\"" << callArgumentExpression << "\""
-        << " " << ATTR_CALL_ARGVALUETYPE << "=\"" << callValueType << "\""
-        << " " << ATTR_CALL_ARGVALUE << "=\"" << callArgValue << "\"";
-    if (warning)
-        out << " " << ATTR_WARNING << "=\"true\"";
-    if (callValuePath.empty())
-        out << "/>";
-    else {
-        out << ">\n";
-        for (const ErrorMessage::FileLocation &loc : callValuePath)
-            out << "  <path"
-                << " " << ATTR_LOC_FILENAME << "=\"" << loc.getfile() << "\""
-                << " " << ATTR_LOC_LINENR << "=\"" << loc.line << "\""
-                << " " << ATTR_LOC_COLUMN << "=\"" << loc.column << "\""
-                << " " << ATTR_INFO << "=\"" << loc.getinfo() << "\"/>\n";
-        out << "</function-call>";
+    writer.writeString(callId);
+    writer.writeString(callFunctionName);
+    writer.writeInt(callArgNr);
+    writeLocation(writer, location);
+}
+
+void CTU::FileInfo::FunctionCall::write(AnalyzerInfoWriter &writer) const
+{
+    writeBase(writer);
+    writer.writeString(callArgumentExpression);
+    writer.writeInt(static_cast<int>(callValueType));
+    writer.writeInt(callArgValue);
+    writer.writeInt(warning ? 1 : 0);
+    writer.writeInt(callValuePath.size());
+    for (const ErrorMessage::FileLocation &loc : callValuePath) {
+        writer.writeString(loc.getfile());
+        writer.writeInt(loc.line);
+        writer.writeInt(loc.column);
+        writer.writeString(loc.getinfo());
     }
-    return out.str();
 }
 
-std::string CTU::FileInfo::NestedCall::toXmlString() const
+void CTU::FileInfo::NestedCall::write(AnalyzerInfoWriter &writer) const
 {
-    std::ostringstream out;
-    out << "<function-call"
-        << toBaseXmlString()
-        << " " << ATTR_MY_ID << "=\"" << myId << "\""
-        << " " << ATTR_MY_ARGNR << "=\"" << myArgNr << "\""
-        << "/>";
-    return out.str();
+    writeBase(writer);
+    writer.writeString(myId);
+    writer.writeInt(myArgNr);
 }
 
-std::string CTU::FileInfo::UnsafeUsage::toString() const
+void CTU::FileInfo::UnsafeUsage::write(AnalyzerInfoWriter &writer) const
 {
-    std::ostringstream out;
-    out << "    <unsafe-usage"
-        << " " << ATTR_MY_ID << "=\"" << myId << '\"'
-        << " " << ATTR_MY_ARGNR << "=\"" << myArgNr << '\"'
-        << " " << ATTR_MY_ARGNAME << "=\"" << myArgumentName << '\"'
-        << " " << ATTR_LOC_FILENAME << "=\"" << location.fileName << '\"'
-        << " " << ATTR_LOC_LINENR << "=\"" << location.lineNumber << '\"'
-        << " " << ATTR_LOC_COLUMN << "=\"" << location.column << '\"'
-        << " " << ATTR_VALUE << "=\"" << value << "\""
-        << "/>\n";
-    return out.str();
+    writer.writeString(myId);
+    writer.writeInt(myArgNr);
+    writer.writeString(myArgumentName);
+    writeLocation(writer, location);
+    writer.writeInt(value);
 }
 
 std::string CTU::toString(const std::list<CTU::FileInfo::UnsafeUsage> &unsafeUsage)
 {
-    std::ostringstream ret;
+    AnalyzerInfoWriter writer;
+    writer.writeInt(unsafeUsage.size());
     for (const CTU::FileInfo::UnsafeUsage &u : unsafeUsage)
-        ret << u.toString();
-    return ret.str();
+        u.write(writer);
+    return writer.str();
 }
 
 CTU::FileInfo::CallBase::CallBase(const Tokenizer *tokenizer, const Token *callToken)
@@ -161,108 +142,109 @@ CTU::FileInfo::NestedCall::NestedCall(const Tokenizer *tokenizer, const Function
 {
 }
 
-static std::string readAttrString(const tinyxml2::XMLElement *e, const char *attr, bool *error)
+void CTU::FileInfo::CallBase::readBase(AnalyzerInfoReader &reader)
 {
-    const char *value = e->Attribute(attr);
-    if (!value && error)
-        *error = true;
-    return value ? value : "";
+    callId = reader.readString();
+    callFunctionName = reader.readString();
+    callArgNr = static_cast<int>(reader.readInt());
+    readLocation(reader, location);
 }
 
-static long long readAttrInt(const tinyxml2::XMLElement *e, const char *attr, bool *error)
+void CTU::FileInfo::FunctionCall::read(AnalyzerInfoReader &reader)
 {
-    const char *value = e->Attribute(attr);
-    if (!value && error)
-        *error = true;
-    return value ? std::atoi(value) : 0;
+    readBase(reader);
+    callArgumentExpression = reader.readString();
+    callValueType = (ValueFlow::Value::ValueType)reader.readInt();
+    callArgValue = reader.readInt();
+    warning = reader.readInt() != 0;
+    callValuePath.clear();
+    for (long long count = reader.readInt(); count > 0 && !reader.error(); --count) {
+        ErrorMessage::FileLocation loc;
+        loc.setfile(reader.readString());
+        loc.line = static_cast<int>(reader.readInt());
+        loc.column = static_cast<unsigned int>(reader.readInt());
+        loc.setinfo(reader.readString());
+        callValuePath.push_back(loc);
+    }
 }
 
-bool CTU::FileInfo::CallBase::loadBaseFromXml(const tinyxml2::XMLElement *xmlElement)
+void CTU::FileInfo::NestedCall::read(AnalyzerInfoReader &reader)
 {
-    bool error = false;
-    callId = readAttrString(xmlElement, ATTR_CALL_ID, &error);
-    callFunctionName = readAttrString(xmlElement, ATTR_CALL_FUNCNAME, &error);
-    callArgNr = readAttrInt(xmlElement, ATTR_CALL_ARGNR, &error);
-    location.fileName = readAttrString(xmlElement, ATTR_LOC_FILENAME, &error);
-    location.lineNumber = readAttrInt(xmlElement, ATTR_LOC_LINENR, &error);
-    location.column = readAttrInt(xmlElement, ATTR_LOC_COLUMN, &error);
-    return !error;
+    readBase(reader);
+    myId = reader.readString();
+    myArgNr = static_cast<int>(reader.readInt());
 }
 
-bool CTU::FileInfo::FunctionCall::loadFromXml(const tinyxml2::XMLElement *xmlElement)
+void CTU::FileInfo::UnsafeUsage::read(AnalyzerInfoReader &reader)
 {
-    if (!loadBaseFromXml(xmlElement))
-        return false;
-    bool error=false;
-    callArgumentExpression = readAttrString(xmlElement, ATTR_CALL_ARGEXPR, &error);
-    callValueType = (ValueFlow::Value::ValueType)readAttrInt(xmlElement, ATTR_CALL_ARGVALUETYPE, &error);
-    callArgValue = readAttrInt(xmlElement, ATTR_CALL_ARGVALUE, &error);
-    const char *w = xmlElement->Attribute(ATTR_WARNING);
-    warning = w && std::strcmp(w, "true") == 0;
-    for (const tinyxml2::XMLElement *e2 = xmlElement->FirstChildElement(); !error && e2; e2 = e2->NextSiblingElement()) {
-        if (std::strcmp(e2->Name(), "path") != 0)
-            continue;
-        ErrorMessage::FileLocation loc;
-        loc.setfile(readAttrString(e2, ATTR_LOC_FILENAME, &error));
-        loc.line = readAttrInt(e2, ATTR_LOC_LINENR, &error);
-        loc.column = readAttrInt(e2, ATTR_LOC_COLUMN, &error);
-        loc.setinfo(readAttrString(e2, ATTR_INFO, &error));
-    }
-    return !error;
+    myId = reader.readString();
+    myArgNr = static_cast<int>(reader.readInt());
+    myArgumentName = reader.readString();
+    readLocation(reader, location);
+    value = reader.readInt();
 }
 
-bool CTU::FileInfo::NestedCall::loadFromXml(const tinyxml2::XMLElement *xmlElement)
+void CTU::FileInfo::loadFromString(const std::string &data)
 {
-    if (!loadBaseFromXml(xmlElement))
-        return false;
-    bool error = false;
-    myId = readAttrString(xmlElement, ATTR_MY_ID, &error);
-    myArgNr = readAttrInt(xmlElement, ATTR_MY_ARGNR, &error);
-    return !error;
+    AnalyzerInfoReader reader(data);
+    for (long long count = reader.readInt(); count > 0 && !reader.error(); --count) {
+        FunctionCall functionCall;
+        functionCall.read(reader);
+        if (!reader.error())
+            functionCalls.push_back(functionCall);
+    }
+    for (long long count = reader.readInt(); count > 0 && !reader.error(); --count) {
+        NestedCall nestedCall;
+        nestedCall.read(reader);
+        if (!reader.error())
+            nestedCalls.push_back(nestedCall);
+    }
 }
 
-void CTU::FileInfo::loadFromXml(const tinyxml2::XMLElement *xmlElement)
+CTU::FileInfo::CallsMap::CallsMap(const FileInfo &fileInfo)
 {
-    for (const tinyxml2::XMLElement *e = xmlElement->FirstChildElement(); e; e = e->NextSiblingElement()) {
-        if (std::strcmp(e->Name(), "function-call") == 0) {
-            FunctionCall functionCall;
-            if (functionCall.loadFromXml(e))
-                functionCalls.push_back(functionCall);
-        } else if (std::strcmp(e->Name(), "nested-call") == 0) {
-            NestedCall nestedCall;
-            if (nestedCall.loadFromXml(e))
-                nestedCalls.push_back(nestedCall);
+    const auto intern = [this](const std::string &functionId) {
+        const std::pair<std::unordered_map<std::string, int>::iterator, bool> it = mIndex.emplace(functionId, static_cast<int>(mCalls.size()));
+        if (it.second)
+            mCalls.emplace_back();
+        return it.first->second;
+    };
+    for (const NestedCall &nc : fileInfo.nestedCalls)
+        mCalls[intern(nc.callId)].push_back({&nc, nullptr, &nc, -1});
+    for (const FunctionCall &fc : fileInfo.functionCalls)
+        mCalls[intern(fc.callId)].push_back({&fc, &fc, nullptr, -1});
+
+    // Link each nested call to the calls of the function it is made in
+    for (std::vector<Call> &calls : mCalls) {
+        for (Call &c : calls) {
+            if (c.nestedCall)
+                c.caller = getIndex(c.nestedCall->myId);
         }
     }
 }
 
-std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> CTU::FileInfo::getCallsMap() const
+int CTU::FileInfo::CallsMap::getIndex(const std::string &functionId) const
 {
-    std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> ret;
-    for (const CTU::FileInfo::NestedCall &nc : nestedCalls)
-        ret[nc.callId].push_back(&nc);
-    for (const CTU::FileInfo::FunctionCall &fc : functionCalls)
-        ret[fc.callId].push_back(&fc);
-    return ret;
+    const std::unordered_map<std::string, int>::const_iterator it = mIndex.find(functionId);
+    return (it == mIndex.end()) ? -1 : it->second;
 }
 
-std::list<CTU::FileInfo::UnsafeUsage> CTU::loadUnsafeUsageListFromXml(const tinyxml2::XMLElement *xmlElement)
+const CTU::FileInfo::CallsMap &CTU::FileInfo::getCallsMap() const
+{
+    std::lock_guard<std::mutex> lock(mCallsMapSync);
+    if (!mCallsMap)
+        mCallsMap.reset(new CallsMap(*this));
+    return *mCallsMap;
+}
+
+std::list<CTU::FileInfo::UnsafeUsage> CTU::loadUnsafeUsageList(const std::string &data)
 {
     std::list<CTU::FileInfo::UnsafeUsage> ret;
-    for (const tinyxml2::XMLElement *e = xmlElement->FirstChildElement(); e; e = e->NextSiblingElement()) {
-        if (std::strcmp(e->Name(), "unsafe-usage") != 0)
-            continue;
-        bool error = false;
+    AnalyzerInfoReader reader(data);
+    for (long long count = reader.readInt(); count > 0 && !reader.error(); --count) {
         FileInfo::UnsafeUsage unsafeUsage;
-        unsafeUsage.myId = readAttrString(e, ATTR_MY_ID, &error);
-        unsafeUsage.myArgNr = readAttrInt(e, ATTR_MY_ARGNR, &error);
-        unsafeUsage.myArgumentName = readAttrString(e, ATTR_MY_ARGNAME, &error);
-        unsafeUsage.location.fileName = readAttrString(e, ATTR_LOC_FILENAME, &error);
-        unsafeUsage.location.lineNumber = readAttrInt(e, ATTR_LOC_LINENR, &error);
-        unsafeUsage.location.column = readAttrInt(e, ATTR_LOC_COLUMN, &error);
-        unsafeUsage.value = readAttrInt(e, ATTR_VALUE, &error);
-
-        if (!error)
+        unsafeUsage.read(reader);
+        if (!reader.error())
             ret.push_back(unsafeUsage);
     }
     return ret;
@@ -470,11 +452,11 @@ std::list<CTU::FileInfo::UnsafeUsage> CTU::getUnsafeUsage(const Tokenizer *token
     return unsafeUsage;
 }
 
-static bool findPath(const std::string &callId,
+static bool findPath(int callIndex,
                      nonneg int callArgNr,
                      MathLib::bigint unsafeValue,
                      CTU::FileInfo::InvalidValueType invalidValue,
-                     const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> &callsMap,
+                     const CTU::FileInfo::CallsMap &callsMap,
                      const CTU::FileInfo::CallBase *path[10],
                      int index,
                      bool warning)
@@ -482,15 +464,14 @@ static bool findPath(const std::string &callId,
     if (index >= CTU::maxCtuDepth || index >= 10)
         return false;
 
-    const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>>::const_iterator it = callsMap.find(callId);
-    if (it == callsMap.end())
+    if (callIndex < 0)
         return false;
 
-    for (const CTU::FileInfo::CallBase *c : it->second) {
-        if (c->callArgNr != callArgNr)
+    for (const CTU::FileInfo::CallsMap::Call &c : callsMap.getCalls(callIndex)) {
+        if (c.call->callArgNr != callArgNr)
             continue;
 
-        const CTU::FileInfo::FunctionCall *functionCall = dynamic_cast<const CTU::FileInfo::FunctionCall *>(c);
+        const CTU::FileInfo::FunctionCall *functionCall = c.functionCall;
         if (functionCall) {
             if (!warning && functionCall->warning)
                 continue;
@@ -514,11 +495,11 @@ static bool findPath(const std::string &callId,
             return true;
         }
 
-        const CTU::FileInfo::NestedCall *nestedCall = dynamic_cast<const CTU::FileInfo::NestedCall *>(c);
+        const CTU::FileInfo::NestedCall *nestedCall = c.nestedCall;
         if (!nestedCall)
             continue;
 
-        if (findPath(nestedCall->myId, nestedCall->myArgNr, unsafeValue, invalidValue, callsMap, path, index + 1, warning)) {
+        if (findPath(c.caller, nestedCall->myArgNr, unsafeValue, invalidValue, callsMap, path, index + 1, warning)) {
             path[index] = nestedCall;
             return true;
         }
@@ -529,7 +510,7 @@ static bool findPath(const std::string &callId,
 
 std::list<ErrorMessage::FileLocation> CTU::FileInfo::getErrorPath(InvalidValueType invalidValue,
         const CTU::FileInfo::UnsafeUsage &unsafeUsage,
-        const std::map<std::string, std::list<const CTU::FileInfo::CallBase *>> &callsMap,
+        const CallsMap &callsMap,
         const char info[],
         const FunctionCall * * const functionCallPtr,
         bool warning) const
@@ -538,7 +519,7 @@ std::list<ErrorMessage::FileLocation> CTU::FileInfo::getErrorPath(InvalidValueTy
 
     const CTU::FileInfo::CallBase *path[10] = {nullptr};
 
-    if (!findPath(unsafeUsage.myId, unsafeUsage.myArgNr, unsafeUsage.value, invalidValue, callsMap, path, 0, warning))
+    if (!findPath(callsMap.getIndex(unsafeUsage.myId), unsafeUsage.myArgNr, unsafeUsage.value, invalidValue, callsMap, path, 0, warning))
         return locationList;
 
     const std::string value1 = (invalidValue == InvalidValueType::null) ? "null" : "uninitialized";
@@ -566,3 +547,47 @@ std::list<ErrorMessage::FileLocation> CTU::FileInfo::getErrorPath(InvalidValueTy
 
     return locationList;
 }
+
+// Set in the threads that run the calls of forEachIndex(), a nested
+// forEachIndex() then runs its calls serially so there are never more
+// than jobs threads.
+static thread_local bool insideForEachIndex = false;
+
+void CTU::forEachIndex(std::size_t count, unsigned int jobs, const std::function<void(std::size_t)> &f)
+{
+    const std::size_t threadCount = std::min<std::size_t>(jobs, count);
+    if (threadCount <= 1 || insideForEachIndex) {
+        for (std::size_t i = 0; i < count; ++i)
+            f(i);
+        return;
+    }
+
+    std::atomic<std::size_t> next(0);
+    std::exception_ptr exception;
+    std::mutex exceptionSync;
+
+    const auto worker = [&]() {
+        insideForEachIndex = true;
+        try {
+            for (std::size_t i = next++; i < count; i = next++)
+                f(i);
+        } catch (...) {
+            // Stop the other threads and rethrow the exception when all are done
+            next = count;
+            std::lock_guard<std::mutex> lock(exceptionSync);
+            if (!exception)
+                exception = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    worker();
+    insideForEachIndex = false;
+    for (std::thread &t : threads)
+        t.join();
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
@@ -26,8 +26,17 @@
 #include "errorlogger.h"
 #include "valueflow.h"
 
-#include <map>
-
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class AnalyzerInfoReader;
+class AnalyzerInfoWriter;
 class Function;
 
 /// @addtogroup Core
@@ -59,7 +68,8 @@ namespace CTU {
             std::string myArgumentName;
             Location location;
             MathLib::bigint value;
-            std::string toString() const;
+            void write(AnalyzerInfoWriter &writer) const;
+            void read(AnalyzerInfoReader &reader);
         };
 
         class CallBase {
@@ -75,8 +85,8 @@ namespace CTU {
             std::string callFunctionName;
             Location location;
         protected:
-            std::string toBaseXmlString() const;
-            bool loadBaseFromXml(const tinyxml2::XMLElement *xmlElement);
+            void writeBase(AnalyzerInfoWriter &writer) const;
+            void readBase(AnalyzerInfoReader &reader);
         };
 
         class FunctionCall : public CallBase {
@@ -87,8 +97,8 @@ namespace CTU {
             std::vector<ErrorMessage::FileLocation> callValuePath;
             bool warning;
 
-            std::string toXmlString() const;
-            bool loadFromXml(const tinyxml2::XMLElement *xmlElement);
+            void write(AnalyzerInfoWriter &writer) const;
+            void read(AnalyzerInfoReader &reader);
         };
 
         class NestedCall : public CallBase {
@@ -103,25 +113,61 @@ namespace CTU {
 
             NestedCall(const Tokenizer *tokenizer, const Function *myFunction, const Token *callToken);
 
-            std::string toXmlString() const;
-            bool loadFromXml(const tinyxml2::XMLElement *xmlElement);
+            void write(AnalyzerInfoWriter &writer) const;
+            void read(AnalyzerInfoReader &reader);
 
             std::string myId;
             nonneg int myArgNr;
         };
 
+        /** The calls of each function. The function ids are interned so the call graph can be walked without string lookups. */
+        class CPPCHECKLIB CallsMap {
+        public:
+            explicit CallsMap(const FileInfo &fileInfo);
+
+            /** A call of a function */
+            struct Call {
+                const CallBase *call;
+                /** the call with a value, nullptr for a nested call */
+                const FunctionCall *functionCall;
+                /** the nested call, nullptr for a function call */
+                const NestedCall *nestedCall;
+                /** index of the function that makes the nested call, -1 if nothing calls that function */
+                int caller;
+            };
+
+            /** Get the index of a function id, -1 if the function is not called */
+            int getIndex(const std::string &functionId) const;
+
+            /** The calls of a function, the nested calls come first */
+            const std::vector<Call> &getCalls(int index) const {
+                return mCalls[index];
+            }
+
+        private:
+            std::unordered_map<std::string, int> mIndex;
+            std::vector<std::vector<Call>> mCalls;
+        };
+
         std::list<FunctionCall> functionCalls;
         std::list<NestedCall> nestedCalls;
 
-        void loadFromXml(const tinyxml2::XMLElement *xmlElement);
-        std::map<std::string, std::list<const CallBase *>> getCallsMap() const;
+        /** Load data that was written by toString() */
+        void loadFromString(const std::string &data);
+
+        /** Get the calls map. It is built at the first call and shared by all checks, no calls may be added after that. */
+        const CallsMap &getCallsMap() const;
 
         std::list<ErrorMessage::FileLocation> getErrorPath(InvalidValueType invalidValue,
                 const UnsafeUsage &unsafeUsage,
-                const std::map<std::string, std::list<const CallBase *>> &callsMap,
+                const CallsMap &callsMap,
                 const char info[],
                 const FunctionCall * * const functionCallPtr,
                 bool warning) const;
+
+    private:
+        mutable std::unique_ptr<const CallsMap> mCallsMap;
+        mutable std::mutex mCallsMapSync;
     };
 
     extern int maxCtuDepth;
@@ -135,7 +181,16 @@ namespace CTU {
 
     CPPCHECKLIB std::list<FileInfo::UnsafeUsage> getUnsafeUsage(const Tokenizer *tokenizer, const Settings *settings, const Check *check, bool (*isUnsafeUsage)(const Check *check, const Token *argtok, MathLib::bigint *value));
 
-    CPPCHECKLIB std::list<FileInfo::UnsafeUsage> loadUnsafeUsageListFromXml(const tinyxml2::XMLElement *xmlElement);
+    CPPCHECKLIB std::list<FileInfo::UnsafeUsage> loadUnsafeUsageList(const std::string &data);
+
+    /**
+     * Call @p f for each index 0..count-1, the calls are split between @p jobs
+     * threads. This is used to search the error paths of the unsafe usages in
+     * parallel, @p f must only write the result of its own index so the results
+     * can be reported in order afterwards. When it is called from @p f of
+     * another forEachIndex() the calls are made in the calling thread.
+     */
+    CPPCHECKLIB void forEachIndex(std::size_t count, unsigned int jobs, const std::function<void(std::size_t)> &f);
 }
 
 /// @}
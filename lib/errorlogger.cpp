@@ -18,6 +18,7 @@
 
 #include "errorlogger.h"
 
+#include "analyzerinfo.h"
 #include "cppcheck.h"
 #include "mathlib.h"
 #include "path.h"
@@ -26,6 +27,7 @@
 #include "utils.h"
 
 #include <tinyxml2.h>
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cctype>
@@ -378,6 +380,122 @@ bool ErrorMessage::deserialize(const std::string &data)
     return true;
 }
 
+void ErrorMessage::serialize(AnalyzerInfoWriter &writer, const std::function<long long(const std::string &)> &getFileIndex) const
+{
+    writer.writeString(id);
+    writer.writeInt(severity);
+    writer.writeInt(cwe.id);
+    writer.writeInt(static_cast<long long>(hash));
+    writer.writeInt((inconclusive ? 1 : 0) | (incomplete ? 2 : 0));
+    writer.writeString(mShortMessage);
+    writer.writeString(mVerboseMessage);
+    writer.writeString(mSymbolNames);
+    writer.writeInt(getFileIndex(file0));
+    writer.writeString(function);
+    writer.writeInt(static_cast<long long>(callStack.size()));
+    for (const FileLocation &loc : callStack) {
+        writer.writeInt(getFileIndex(loc.mFileName));
+        writer.writeInt(getFileIndex(loc.mOrigFileName));
+        writer.writeInt(loc.fileIndex);
+        writer.writeInt(loc.line);
+        writer.writeInt(loc.column);
+        writer.writeString(loc.mInfo);
+    }
+}
+
+bool ErrorMessage::deserialize(AnalyzerInfoReader &reader, const std::function<const std::string *(long long)> &getFileName)
+{
+    const auto readFileName = [&](std::string &fileName) {
+        const std::string *name = getFileName(reader.readInt());
+        if (!name)
+            return false;
+        fileName = *name;
+        return true;
+    };
+
+    reader.readString(id);
+    severity = static_cast<Severity::SeverityType>(reader.readInt());
+    cwe.id = static_cast<unsigned short>(reader.readInt());
+    hash = static_cast<std::size_t>(reader.readInt());
+    const long long flags = reader.readInt();
+    inconclusive = (flags & 1) != 0;
+    incomplete = (flags & 2) != 0;
+    reader.readString(mShortMessage);
+    reader.readString(mVerboseMessage);
+    reader.readString(mSymbolNames);
+    if (!readFileName(file0))
+        return false;
+    reader.readString(function);
+    const long long stackSize = reader.readInt();
+    if (reader.error() || stackSize < 0)
+        return false;
+
+    callStack.resize(static_cast<std::size_t>(stackSize));
+    for (FileLocation &loc : callStack) {
+        if (!readFileName(loc.mFileName) || !readFileName(loc.mOrigFileName))
+            return false;
+        loc.fileIndex = static_cast<unsigned int>(reader.readInt());
+        loc.line = static_cast<int>(reader.readInt());
+        loc.column = static_cast<unsigned int>(reader.readInt());
+        reader.readString(loc.mInfo);
+        if (reader.error())
+            return false;
+    }
+    return !reader.error();
+}
+
+unsigned long long ErrorMessage::fingerprint(bool verbose) const
+{
+    // Hash what toString(verbose) writes. The path separators are converted
+    // to native separators in the text, so they are the same here.
+    Hash64 h;
+    h.update(callStack.size());
+    for (const FileLocation &loc : callStack) {
+        if (loc.mFileName.find('\\') == std::string::npos) {
+            h.update(loc.mFileName.size());
+            h.update(loc.mFileName);
+        } else {
+            const std::string fileName = Path::fromNativeSeparators(loc.mFileName);
+            h.update(fileName.size());
+            h.update(fileName);
+        }
+        h.update(static_cast<unsigned long long>(loc.line));
+    }
+    h.update(severity);
+    h.update(severity != Severity::none && inconclusive);
+    h.update(verbose ? mVerboseMessage : mShortMessage);
+    return h.digest();
+}
+
+bool ReportedErrors::insert(unsigned long long fingerprint)
+{
+    Shard &shard = mShards[fingerprint % mShards.size()];
+    std::lock_guard<std::mutex> lock(shard.sync);
+    return shard.fingerprints.insert(fingerprint).second;
+}
+
+bool ReportedErrors::insert(const std::string &errmsg)
+{
+    Hash64 h;
+    h.update(errmsg);
+    return insert(h.digest());
+}
+
+bool ReportedErrors::contains(unsigned long long fingerprint) const
+{
+    const Shard &shard = mShards[fingerprint % mShards.size()];
+    std::lock_guard<std::mutex> lock(shard.sync);
+    return shard.fingerprints.find(fingerprint) != shard.fingerprints.end();
+}
+
+void ReportedErrors::clear()
+{
+    for (Shard &shard : mShards) {
+        std::lock_guard<std::mutex> lock(shard.sync);
+        shard.fingerprints.clear();
+    }
+}
+
 std::string ErrorMessage::getXMLHeader()
 {
     tinyxml2::XMLPrinter printer;
@@ -673,36 +791,44 @@ std::string ErrorMessage::FileLocation::stringify() const
 
 std::string ErrorLogger::toxml(const std::string &str)
 {
-    std::ostringstream xml;
+    // Most strings don't need any escaping
+    const auto needsEscape = [](unsigned char c) {
+        return c < ' ' || c > 0x7f || c == '<' || c == '>' || c == '&' || c == '\"' || c == '\'';
+    };
+    if (std::none_of(str.begin(), str.end(), needsEscape))
+        return str;
+
+    std::string xml;
+    xml.reserve(str.size() + 16);
     for (unsigned char c : str) {
         switch (c) {
         case '<':
-            xml << "&lt;";
+            xml += "&lt;";
             break;
         case '>':
-            xml << "&gt;";
+            xml += "&gt;";
             break;
         case '&':
-            xml << "&amp;";
+            xml += "&amp;";
             break;
         case '\"':
-            xml << "&quot;";
+            xml += "&quot;";
             break;
         case '\'':
-            xml << "&apos;";
+            xml += "&apos;";
             break;
         case '\0':
-            xml << "\\0";
+            xml += "\\0";
             break;
         default:
             if (c >= ' ' && c <= 0x7f)
-                xml << c;
+                xml += static_cast<char>(c);
             else
-                xml << 'x';
+                xml += 'x';
             break;
         }
     }
-    return xml.str();
+    return xml;
 }
 
 std::string ErrorLogger::plistHeader(const std::string &version, const std::vector<std::string> &files)
@@ -25,10 +25,14 @@
 #include "errortypes.h"
 #include "suppressions.h"
 
+#include <array>
 #include <cstddef>
 #include <fstream>
+#include <functional>
 #include <list>
+#include <mutex>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -44,6 +48,8 @@ static const struct CWE CWE_INCORRECT_CALCULATION(682U);
 static const struct CWE CWE_EXPIRED_POINTER_DEREFERENCE(825U);
 
 
+class AnalyzerInfoReader;
+class AnalyzerInfoWriter;
 class Token;
 class TokenList;
 
@@ -118,6 +124,7 @@ public:
         }
 
     private:
+        friend class ErrorMessage;
         std::string mOrigFileName;
         std::string mFileName;
         std::string mInfo;
@@ -182,6 +189,22 @@ public:
     std::string serialize() const;
     bool deserialize(const std::string &data);
 
+    /**
+     * Write the message in binary form. The file names are not written, the
+     * number that @p getFileIndex returns for a file name is written instead.
+     */
+    void serialize(AnalyzerInfoWriter &writer, const std::function<long long(const std::string &)> &getFileIndex) const;
+
+    /**
+     * Read a message that was written by serialize(AnalyzerInfoWriter&, ...).
+     * The strings and call stack of this message are reused, reading many
+     * messages into the same object allocates little memory.
+     * @param reader the data
+     * @param getFileName the file name of a number, nullptr if the number is unknown
+     * @return false if the data is invalid
+     */
+    bool deserialize(AnalyzerInfoReader &reader, const std::function<const std::string *(long long)> &getFileName);
+
     std::list<FileLocation> callStack;
     std::string id;
 
@@ -219,6 +242,12 @@ public:
 
     Suppressions::ErrorMessage toSuppressionsErrorMessage() const;
 
+    /**
+     * 64 bit hash of the message. Messages have the same hash when
+     * toString(verbose) gives the same text, the text is not created.
+     */
+    unsigned long long fingerprint(bool verbose) const;
+
 private:
     /**
      * Replace all occurrences of searchFor with replaceWith in the
@@ -241,6 +270,37 @@ private:
     std::string mSymbolNames;
 };
 
+/**
+ * @brief The errors that have been reported, to report each error only once.
+ * The errors are stored as 64 bit fingerprints. The fingerprints are split
+ * between shards that have their own lock, so threads that report errors at
+ * the same time seldom wait for each other.
+ */
+class CPPCHECKLIB ReportedErrors {
+public:
+    /**
+     * Add an error.
+     * @param fingerprint fingerprint of the error, see ErrorMessage::fingerprint()
+     * @return false if the error has been added before
+     */
+    bool insert(unsigned long long fingerprint);
+
+    /** Add an error that is identified by its text */
+    bool insert(const std::string &errmsg);
+
+    /** Has the error been added */
+    bool contains(unsigned long long fingerprint) const;
+
+    void clear();
+
+private:
+    struct Shard {
+        mutable std::mutex sync;
+        std::unordered_set<unsigned long long> fingerprints;
+    };
+    std::array<Shard, 16> mShards;
+};
+
 /**
  * @brief This is an interface, which the class responsible of error logging
  * should implement.
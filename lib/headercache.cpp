@@ -0,0 +1,218 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2020 Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "headercache.h"
+
+#include "path.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+// Upper limit for the number of cached tokens so huge code bases do not use too much memory.
+// Files that are loaded when the cache is full are not cached.
+static const std::size_t MAX_TOKENS = 5000000;
+
+struct HeaderCache::Entry {
+    Entry(long long mtime_, long long size_) : mtime(mtime_), size(size_), tokens(files), tokenCount(0) {}
+
+    const long long mtime;
+    const long long size;
+    std::vector<std::string> files;
+    simplecpp::TokenList tokens;
+    simplecpp::OutputList outputs;
+    std::size_t tokenCount;
+};
+
+HeaderCache::HeaderCache()
+    : mTokenCount(0)
+    , mHits(0)
+    , mMisses(0)
+{
+}
+
+HeaderCache::~HeaderCache()
+{
+}
+
+HeaderCache &HeaderCache::instance()
+{
+    static HeaderCache headerCache;
+    return headerCache;
+}
+
+bool HeaderCache::getFileStamp(const std::string &path, long long *mtime, long long *size)
+{
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data))
+        return false;
+    // 100 nanosecond intervals
+    *mtime = (static_cast<long long>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+    *size = (static_cast<long long>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+#else
+    struct stat statBuf;
+    if (stat(path.c_str(), &statBuf) != 0)
+        return false;
+    // nanoseconds
+#ifdef __APPLE__
+    *mtime = static_cast<long long>(statBuf.st_mtimespec.tv_sec) * 1000000000LL + statBuf.st_mtimespec.tv_nsec;
+#else
+    *mtime = static_cast<long long>(statBuf.st_mtim.tv_sec) * 1000000000LL + statBuf.st_mtim.tv_nsec;
+#endif
+    *size = statBuf.st_size;
+#endif
+    return true;
+}
+
+static bool sameline(const simplecpp::Token *tok1, const simplecpp::Token *tok2)
+{
+    return tok1 && tok2 && tok1->location.sameline(tok2->location);
+}
+
+static std::string getRelativeFileName(const std::string &sourcefile, const std::string &header)
+{
+    if (sourcefile.find_first_of("\\/") != std::string::npos)
+        return simplecpp::simplifyPath(sourcefile.substr(0, sourcefile.find_last_of("\\/") + 1U) + header);
+    return simplecpp::simplifyPath(header);
+}
+
+static std::string getIncludePathFileName(const std::string &includePath, const std::string &header)
+{
+    std::string path = includePath;
+    if (!path.empty() && path[path.size()-1U]!='/' && path[path.size()-1U]!='\\')
+        path += '/';
+    return simplecpp::simplifyPath(path + header);
+}
+
+// The paths where a header is looked for, in the order they are tried by simplecpp
+static std::vector<std::string> getHeaderPaths(const simplecpp::DUI &dui, const std::string &sourcefile, const std::string &header, bool systemheader)
+{
+    std::vector<std::string> paths;
+    if (Path::isAbsolute(header)) {
+        paths.push_back(header);
+        return paths;
+    }
+    if (!systemheader)
+        paths.push_back(getRelativeFileName(sourcefile, header));
+    for (const std::string &includePath : dui.includePaths)
+        paths.push_back(getIncludePathFileName(includePath, header));
+    if (systemheader)
+        paths.push_back(getRelativeFileName(sourcefile, header));
+    return paths;
+}
+
+bool HeaderCache::getMissedFiles(const simplecpp::TokenList &tokens, const simplecpp::DUI &dui, std::set<std::string> *missedFiles)
+{
+    for (const simplecpp::Token *rawtok = tokens.cfront(); rawtok; rawtok = rawtok->next) {
+        if (rawtok->op != '#' || sameline(rawtok->previousSkipComments(), rawtok))
+            continue;
+        const simplecpp::Token *inctok = rawtok->nextSkipComments();
+        if (!inctok || inctok->str() != "include")
+            continue;
+        const simplecpp::Token *htok = inctok->nextSkipComments();
+        if (!sameline(inctok, htok))
+            continue;
+        if (htok->str().size() < 2U || (htok->str()[0] != '<' && htok->str()[0] != '\"'))
+            return false;
+        const bool systemheader = (htok->str()[0] == '<');
+        const std::string header(htok->str().substr(1U, htok->str().size() - 2U));
+        for (const std::string &path : getHeaderPaths(dui, inctok->location.file(), header, systemheader)) {
+            if (Path::fileExists(path))
+                break;
+            missedFiles->insert(path);
+        }
+    }
+    return true;
+}
+
+simplecpp::TokenList *HeaderCache::read(std::istream &istr, std::vector<std::string> &filenames, const std::string &filename, simplecpp::OutputList *outputList)
+{
+    const std::string path = Path::getAbsoluteFilePath(filename);
+    long long mtime = 0;
+    long long size = 0;
+    if (path.empty() || !getFileStamp(path, &mtime, &size))
+        return new simplecpp::TokenList(istr, filenames, filename, outputList);
+
+    std::shared_ptr<const Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(mSync);
+        const std::map<std::string, std::shared_ptr<const Entry>>::const_iterator it = mEntries.find(path);
+        if (it != mEntries.end() && it->second->mtime == mtime && it->second->size == size)
+            entry = it->second;
+    }
+
+    if (entry) {
+        ++mHits;
+    } else {
+        ++mMisses;
+        std::shared_ptr<Entry> newEntry = std::make_shared<Entry>(mtime, size);
+        newEntry->tokens.readfile(istr, filename, &newEntry->outputs);
+        for (const simplecpp::Token *tok = newEntry->tokens.cfront(); tok; tok = tok->next)
+            ++newEntry->tokenCount;
+
+        std::lock_guard<std::mutex> lock(mSync);
+        std::shared_ptr<const Entry> &cached = mEntries[path];
+        const std::size_t oldTokenCount = cached ? cached->tokenCount : 0;
+        if (mTokenCount - oldTokenCount + newEntry->tokenCount <= MAX_TOKENS) {
+            mTokenCount = mTokenCount - oldTokenCount + newEntry->tokenCount;
+            cached = newEntry;
+        } else if (!cached) {
+            mEntries.erase(path);
+        }
+        entry = newEntry;
+    }
+
+    // The tokens refer to the files of the cache entry, map them to the files of this translation unit
+    std::vector<unsigned int> fileIndexes;
+    for (std::size_t i = 0; i < entry->files.size(); ++i) {
+        const std::string &name = (i == 0) ? filename : entry->files[i];
+        const std::vector<std::string>::const_iterator it = std::find(filenames.begin(), filenames.end(), name);
+        fileIndexes.push_back(static_cast<unsigned int>(it - filenames.begin()));
+        if (it == filenames.end())
+            filenames.push_back(name);
+    }
+
+    simplecpp::TokenList *tokens = new simplecpp::TokenList(filenames);
+    for (const simplecpp::Token *tok = entry->tokens.cfront(); tok; tok = tok->next) {
+        simplecpp::Location location(filenames);
+        location.fileIndex = fileIndexes[tok->location.fileIndex];
+        location.line = tok->location.line;
+        location.col = tok->location.col;
+        tokens->push_back(new simplecpp::Token(tok->str(), location));
+    }
+
+    if (outputList) {
+        for (const simplecpp::Output &output : entry->outputs) {
+            simplecpp::Output out(filenames);
+            out.type = output.type;
+            out.location.fileIndex = (output.location.fileIndex < fileIndexes.size()) ? fileIndexes[output.location.fileIndex] : 0;
+            out.location.line = output.location.line;
+            out.location.col = output.location.col;
+            out.msg = output.msg;
+            outputList->push_back(out);
+        }
+    }
+
+    return tokens;
+}
@@ -0,0 +1,117 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2020 Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef headercacheH
+#define headercacheH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+
+#include <simplecpp.h>
+
+#include <atomic>
+#include <cstddef>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Cache for the raw tokens of included files.
+ *
+ * The same headers are included by many translation units. The first time
+ * a header is loaded its raw tokens are kept, when the header is included
+ * again the tokens are copied instead of reading and tokenizing the file.
+ * The cache is shared by all CppCheck instances of the process and can be
+ * used by several threads at the same time. Files are identified by their
+ * absolute path; a file is loaded again when its modification time or size
+ * has changed.
+ */
+class CPPCHECKLIB HeaderCache : public simplecpp::FileReader {
+public:
+    HeaderCache();
+    ~HeaderCache() OVERRIDE;
+    HeaderCache(const HeaderCache &) = delete;
+    HeaderCache &operator=(const HeaderCache &) = delete;
+
+    /** The cache that is shared by the whole process */
+    static HeaderCache &instance();
+
+    /**
+     * Get the modification time and size of a file. The time has the
+     * resolution of the file system, so an edit that does not change the
+     * size is noticed even if it is done within the same second.
+     * @param path name of the file
+     * @param mtime output: modification time
+     * @param size output: size of the file
+     * @return false if the file does not exist
+     */
+    static bool getFileStamp(const std::string &path, long long *mtime, long long *size);
+
+    /**
+     * Get the paths that are tried before the files included by the tokens
+     * are found. When one of these files is created another file might be
+     * included.
+     * @param tokens the tokens of a file
+     * @param dui the include paths
+     * @param missedFiles output: the paths that were tried
+     * @return false if a file is included with a macro, then its path is not known
+     */
+    static bool getMissedFiles(const simplecpp::TokenList &tokens, const simplecpp::DUI &dui, std::set<std::string> *missedFiles);
+
+    /**
+     * Get the tokens of a file, the tokens are copied from the cache
+     * when the file has been read before.
+     * @param istr the opened file
+     * @param filenames file names of the translation unit
+     * @param filename name of the file
+     * @param outputList output: list that will receive output messages
+     */
+    simplecpp::TokenList *read(std::istream &istr, std::vector<std::string> &filenames, const std::string &filename, simplecpp::OutputList *outputList) OVERRIDE;
+
+    /** Number of files that were copied from the cache */
+    std::size_t hits() const {
+        return mHits;
+    }
+
+    /** Number of files that were read and tokenized */
+    std::size_t misses() const {
+        return mMisses;
+    }
+
+private:
+    struct Entry;
+
+    std::map<std::string, std::shared_ptr<const Entry>> mEntries;
+    std::size_t mTokenCount;
+    std::mutex mSync;
+
+    std::atomic<std::size_t> mHits;
+    std::atomic<std::size_t> mMisses;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // headercacheH
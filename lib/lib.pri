@@ -39,8 +39,10 @@ HEADERS += $${PWD}/analyzerinfo.h \
            $${PWD}/errortypes.h \
            $${PWD}/exprengine.h \
            $${PWD}/forwardanalyzer.h \
+           $${PWD}/headercache.h \
            $${PWD}/importproject.h \
            $${PWD}/library.h \
+           $${PWD}/librarycache.h \
            $${PWD}/mathlib.h \
            $${PWD}/path.h \
            $${PWD}/pathanalysis.h \
@@ -95,8 +97,10 @@ SOURCES += $${PWD}/analyzerinfo.cpp \
            $${PWD}/errortypes.cpp \
            $${PWD}/exprengine.cpp \
            $${PWD}/forwardanalyzer.cpp \
+           $${PWD}/headercache.cpp \
            $${PWD}/importproject.cpp \
            $${PWD}/library.cpp \
+           $${PWD}/librarycache.cpp \
            $${PWD}/mathlib.cpp \
            $${PWD}/path.cpp \
            $${PWD}/pathanalysis.cpp \
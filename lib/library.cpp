@@ -19,6 +19,7 @@
 #include "library.h"
 
 #include "astutils.h"
+#include "librarycache.h"
 #include "mathlib.h"
 #include "path.h"
 #include "symboldatabase.h"
@@ -27,9 +28,12 @@
 #include "tokenlist.h"
 #include "utils.h"
 
+#include <algorithm>
 #include <cctype>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <iterator>
 #include <list>
 #include <string>
 
@@ -56,10 +60,116 @@ static void gettokenlistfromvalid(const std::string& valid, TokenList& tokenList
     }
 }
 
-Library::Library() : mAllocId(0)
+Library::Library() : mAllocId(0), mChecksum(0), mCacheKey(0), mCacheKeyValid(true)
 {
 }
 
+static std::list<std::string> getCfgFolders(const char exename[])
+{
+    std::list<std::string> cfgfolders;
+#ifdef FILESDIR
+    cfgfolders.emplace_back(FILESDIR "/cfg");
+#endif
+    if (exename) {
+        const std::string exepath(Path::fromNativeSeparators(Path::getPathFromFilename(exename)));
+        cfgfolders.push_back(exepath + "cfg");
+        cfgfolders.push_back(exepath);
+    }
+    return cfgfolders;
+}
+
+static bool readFile(const std::string &filename, std::string &data)
+{
+    std::ifstream fin(filename, std::ios::binary);
+    if (!fin.is_open())
+        return false;
+    data.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+    return !fin.bad();
+}
+
+// Find and read the cfg file, the same paths are tried as when the file is loaded with tinyxml2
+static bool readCfgFile(const char exename[], const char path[], std::string &filename, std::string &data)
+{
+    filename = path;
+    if (readFile(filename, data))
+        return true;
+    if (Path::getFilenameExtension(filename).empty()) {
+        filename += ".cfg";
+        if (readFile(filename, data))
+            return true;
+    }
+    const std::string fullfilename(filename);
+    std::list<std::string> cfgfolders = getCfgFolders(exename);
+    while (!cfgfolders.empty()) {
+        const std::string cfgfolder(cfgfolders.back());
+        cfgfolders.pop_back();
+        const char *sep = (!cfgfolder.empty() && endsWith(cfgfolder,'/') ? "" : "/");
+        filename = cfgfolder + sep + fullfilename;
+        if (readFile(filename, data))
+            return true;
+    }
+    return false;
+}
+
+Library::Error Library::loadCached(const char exename[], const char path[], bool *loaded)
+{
+    *loaded = false;
+    std::string filename, data;
+    if (!readCfgFile(exename, path, filename, data))
+        return Error(OK);
+
+    const std::string absolute_path = Path::getAbsoluteFilePath(filename);
+    if (mFiles.find(absolute_path) != mFiles.end()) {
+        *loaded = true;
+        return Error(OK); // ignore duplicates
+    }
+
+    // The key depends on all cfg files that have been loaded before
+    const unsigned long long key = LibraryCache::hash(LibraryCache::hash(mCacheKey, absolute_path), data);
+    const std::string cacheFile = mCacheDir + '/' + LibraryCache::filename(key);
+    if (LibraryCache::load(*this, cacheFile, key)) {
+        *loaded = true;
+        return Error(OK);
+    }
+
+    tinyxml2::XMLDocument doc;
+    if (doc.Parse(data.c_str(), data.size()) != tinyxml2::XML_SUCCESS)
+        return Error(OK); // report the error when the file is loaded without the cache
+
+    *loaded = true;
+    Error err = load(doc);
+    if (err.errorcode == OK) {
+        mFiles.insert(absolute_path);
+        mCacheKey = key;
+        mCacheKeyValid = true;
+        LibraryCache::save(*this, cacheFile, key);
+    }
+    return err;
+}
+
+bool Library::loadCache(const char exename[], const std::list<std::string> &paths)
+{
+    if (mCacheDir.empty() || !mCacheKeyValid)
+        return false;
+
+    unsigned long long key = mCacheKey;
+    std::set<std::string> files(mFiles);
+    for (const std::string &path : paths) {
+        for (std::string::size_type pos = 0; pos < path.size();) {
+            const std::string::size_type end = std::min(path.find(',', pos), path.size());
+            const std::string p = path.substr(pos, end - pos);
+            pos = end + 1;
+            std::string filename, data;
+            if (!readCfgFile(exename, p.c_str(), filename, data))
+                continue; // the error is reported by load()
+            const std::string absolute_path = Path::getAbsoluteFilePath(filename);
+            if (files.insert(absolute_path).second)
+                key = LibraryCache::hash(LibraryCache::hash(key, absolute_path), data);
+        }
+    }
+    return key != mCacheKey && LibraryCache::load(*this, mCacheDir + '/' + LibraryCache::filename(key), key);
+}
+
 Library::Error Library::load(const char exename[], const char path[])
 {
     if (std::strchr(path,',') != nullptr) {
@@ -78,6 +188,13 @@ Library::Error Library::load(const char exename[], const char path[])
         return Error();
     }
 
+    if (!mCacheDir.empty() && mCacheKeyValid) {
+        bool loaded;
+        const Error err = loadCached(exename, path, &loaded);
+        if (loaded)
+            return err;
+    }
+
     std::string absolute_path;
     // open file..
     tinyxml2::XMLDocument doc;
@@ -95,15 +212,7 @@ Library::Error Library::load(const char exename[], const char path[])
                 absolute_path = Path::getAbsoluteFilePath(fullfilename);
         }
 
-        std::list<std::string> cfgfolders;
-#ifdef FILESDIR
-        cfgfolders.emplace_back(FILESDIR "/cfg");
-#endif
-        if (exename) {
-            const std::string exepath(Path::fromNativeSeparators(Path::getPathFromFilename(exename)));
-            cfgfolders.push_back(exepath + "cfg");
-            cfgfolders.push_back(exepath);
-        }
+        std::list<std::string> cfgfolders = getCfgFolders(exename);
 
         while (error == tinyxml2::XML_ERROR_FILE_NOT_FOUND && !cfgfolders.empty()) {
             const std::string cfgfolder(cfgfolders.back());
@@ -144,6 +253,13 @@ bool Library::loadxmldata(const char xmldata[], std::size_t len)
 
 Library::Error Library::load(const tinyxml2::XMLDocument &doc)
 {
+    // The library can't be restored from the cache anymore, unless this is called by loadCached()
+    mCacheKeyValid = false;
+
+    tinyxml2::XMLPrinter printer(nullptr, true);
+    doc.Print(&printer);
+    mChecksum = LibraryCache::hash(mChecksum, printer.CStr());
+
     const tinyxml2::XMLElement * const rootnode = doc.FirstChildElement();
 
     if (rootnode == nullptr) {
@@ -171,7 +287,7 @@ Library::Error Library::load(const tinyxml2::XMLDocument &doc)
             int allocationId = 0;
             for (const tinyxml2::XMLElement *memorynode = node->FirstChildElement(); memorynode; memorynode = memorynode->NextSiblingElement()) {
                 if (strcmp(memorynode->Name(),"dealloc")==0) {
-                    const std::map<std::string, AllocFunc>::const_iterator it = mDealloc.find(memorynode->GetText());
+                    const std::unordered_map<std::string, AllocFunc>::const_iterator it = mDealloc.find(memorynode->GetText());
                     if (it != mDealloc.end()) {
                         allocationId = it->second.groupId;
                         break;
@@ -974,9 +1090,14 @@ std::string Library::getFunctionName(const Token *ftok) const
 
     // Lookup function name using AST..
     if (ftok->astParent()) {
+        // The name is looked up for every library query, it is remembered until the AST is changed
+        const std::string *cached = ftok->libraryFunctionName(this);
+        if (cached)
+            return *cached;
         bool error = false;
         const Token * tok = ftok->astParent()->isUnaryOp("&") ? ftok->astParent()->astOperand1() : ftok->next()->astOperand1();
         const std::string ret = getFunctionName(tok, &error);
+        ftok->libraryFunctionName(this, error ? emptyString : ret);
         return error ? std::string() : ret;
     }
 
@@ -1000,7 +1121,7 @@ bool Library::isnullargbad(const Token *ftok, int argnr) const
     if (!arg) {
         // scan format string argument should not be null
         const std::string funcname = getFunctionName(ftok);
-        const std::map<std::string, Function>::const_iterator it = functions.find(funcname);
+        const std::unordered_map<std::string, Function>::const_iterator it = functions.find(funcname);
         if (it != functions.cend() && it->second.formatstr && it->second.formatstr_scan)
             return true;
     }
@@ -1013,7 +1134,7 @@ bool Library::isuninitargbad(const Token *ftok, int argnr, int indirect, bool *h
     if (!arg) {
         // non-scan format string argument should not be uninitialized
         const std::string funcname = getFunctionName(ftok);
-        const std::map<std::string, Function>::const_iterator it = functions.find(funcname);
+        const std::unordered_map<std::string, Function>::const_iterator it = functions.find(funcname);
         if (it != functions.cend() && it->second.formatstr && !it->second.formatstr_scan)
             return true;
     }
@@ -1070,7 +1191,7 @@ const Library::ArgumentChecks * Library::getarg(const Token *ftok, int argnr) co
 {
     if (isNotLibraryFunction(ftok))
         return nullptr;
-    const std::map<std::string, Function>::const_iterator it1 = functions.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, Function>::const_iterator it1 = functions.find(getFunctionName(ftok));
     if (it1 == functions.cend())
         return nullptr;
     const std::map<int,ArgumentChecks>::const_iterator it2 = it1->second.argumentChecks.find(argnr);
@@ -1181,7 +1302,7 @@ bool Library::isNotLibraryFunction(const Token *ftok) const
 bool Library::matchArguments(const Token *ftok, const std::string &functionName) const
 {
     const int callargs = numberOfArguments(ftok);
-    const std::map<std::string, Function>::const_iterator it = functions.find(functionName);
+    const std::unordered_map<std::string, Function>::const_iterator it = functions.find(functionName);
     if (it == functions.cend())
         return (callargs == 0);
     int args = 0;
@@ -1251,7 +1372,7 @@ bool Library::formatstr_function(const Token* ftok) const
     if (isNotLibraryFunction(ftok))
         return false;
 
-    const std::map<std::string, Function>::const_iterator it = functions.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, Function>::const_iterator it = functions.find(getFunctionName(ftok));
     if (it != functions.cend())
         return it->second.formatstr;
     return false;
@@ -1282,7 +1403,7 @@ bool Library::isUseRetVal(const Token* ftok) const
 {
     if (isNotLibraryFunction(ftok))
         return false;
-    const std::map<std::string, Function>::const_iterator it = functions.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, Function>::const_iterator it = functions.find(getFunctionName(ftok));
     if (it != functions.cend())
         return it->second.useretval;
     return false;
@@ -1292,7 +1413,7 @@ const std::string& Library::returnValue(const Token *ftok) const
 {
     if (isNotLibraryFunction(ftok))
         return emptyString;
-    const std::map<std::string, std::string>::const_iterator it = mReturnValue.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, std::string>::const_iterator it = mReturnValue.find(getFunctionName(ftok));
     return it != mReturnValue.end() ? it->second : emptyString;
 }
 
@@ -1300,7 +1421,7 @@ const std::string& Library::returnValueType(const Token *ftok) const
 {
     if (isNotLibraryFunction(ftok))
         return emptyString;
-    const std::map<std::string, std::string>::const_iterator it = mReturnValueType.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, std::string>::const_iterator it = mReturnValueType.find(getFunctionName(ftok));
     return it != mReturnValueType.end() ? it->second : emptyString;
 }
 
@@ -1308,7 +1429,7 @@ int Library::returnValueContainer(const Token *ftok) const
 {
     if (isNotLibraryFunction(ftok))
         return -1;
-    const std::map<std::string, int>::const_iterator it = mReturnValueContainer.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, int>::const_iterator it = mReturnValueContainer.find(getFunctionName(ftok));
     return it != mReturnValueContainer.end() ? it->second : -1;
 }
 
@@ -1316,7 +1437,7 @@ std::vector<MathLib::bigint> Library::unknownReturnValues(const Token *ftok) con
 {
     if (isNotLibraryFunction(ftok))
         return std::vector<MathLib::bigint>();
-    const std::map<std::string, std::vector<MathLib::bigint>>::const_iterator it = mUnknownReturnValues.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, std::vector<MathLib::bigint>>::const_iterator it = mUnknownReturnValues.find(getFunctionName(ftok));
     return (it == mUnknownReturnValues.end()) ? std::vector<MathLib::bigint>() : it->second;
 }
 
@@ -1324,7 +1445,7 @@ const Library::Function *Library::getFunction(const Token *ftok) const
 {
     if (isNotLibraryFunction(ftok))
         return nullptr;
-    const std::map<std::string, Function>::const_iterator it1 = functions.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, Function>::const_iterator it1 = functions.find(getFunctionName(ftok));
     if (it1 == functions.cend())
         return nullptr;
     return &it1->second;
@@ -1335,7 +1456,7 @@ bool Library::hasminsize(const Token *ftok) const
 {
     if (isNotLibraryFunction(ftok))
         return false;
-    const std::map<std::string, Function>::const_iterator it1 = functions.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, Function>::const_iterator it1 = functions.find(getFunctionName(ftok));
     if (it1 == functions.cend())
         return false;
     for (std::map<int, ArgumentChecks>::const_iterator it2 = it1->second.argumentChecks.cbegin(); it2 != it1->second.argumentChecks.cend(); ++it2) {
@@ -1364,28 +1485,28 @@ Library::ArgumentChecks::Direction Library::getArgDirection(const Token* ftok, i
 
 bool Library::ignorefunction(const std::string& functionName) const
 {
-    const std::map<std::string, Function>::const_iterator it = functions.find(functionName);
+    const std::unordered_map<std::string, Function>::const_iterator it = functions.find(functionName);
     if (it != functions.cend())
         return it->second.ignore;
     return false;
 }
 bool Library::isUse(const std::string& functionName) const
 {
-    const std::map<std::string, Function>::const_iterator it = functions.find(functionName);
+    const std::unordered_map<std::string, Function>::const_iterator it = functions.find(functionName);
     if (it != functions.cend())
         return it->second.use;
     return false;
 }
 bool Library::isLeakIgnore(const std::string& functionName) const
 {
-    const  std::map<std::string, Function>::const_iterator it = functions.find(functionName);
+    const  std::unordered_map<std::string, Function>::const_iterator it = functions.find(functionName);
     if (it != functions.cend())
         return it->second.leakignore;
     return false;
 }
 bool Library::isFunctionConst(const std::string& functionName, bool pure) const
 {
-    const std::map<std::string, Function>::const_iterator it = functions.find(functionName);
+    const std::unordered_map<std::string, Function>::const_iterator it = functions.find(functionName);
     if (it != functions.cend())
         return pure ? it->second.ispure : it->second.isconst;
     return false;
@@ -1396,7 +1517,7 @@ bool Library::isFunctionConst(const Token *ftok) const
         return true;
     if (isNotLibraryFunction(ftok))
         return false;
-    const std::map<std::string, Function>::const_iterator it = functions.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, Function>::const_iterator it = functions.find(getFunctionName(ftok));
     return (it != functions.end() && it->second.isconst);
 }
 bool Library::isnoreturn(const Token *ftok) const
@@ -1405,7 +1526,7 @@ bool Library::isnoreturn(const Token *ftok) const
         return true;
     if (isNotLibraryFunction(ftok))
         return false;
-    const std::map<std::string, bool>::const_iterator it = mNoReturn.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, bool>::const_iterator it = mNoReturn.find(getFunctionName(ftok));
     return (it != mNoReturn.end() && it->second);
 }
 
@@ -1415,7 +1536,7 @@ bool Library::isnotnoreturn(const Token *ftok) const
         return false;
     if (isNotLibraryFunction(ftok))
         return false;
-    const std::map<std::string, bool>::const_iterator it = mNoReturn.find(getFunctionName(ftok));
+    const std::unordered_map<std::string, bool>::const_iterator it = mNoReturn.find(getFunctionName(ftok));
     return (it != mNoReturn.end() && !it->second);
 }
 
@@ -27,9 +27,11 @@
 #include "standards.h"
 
 #include <cstddef>
+#include <list>
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -48,6 +50,7 @@ namespace tinyxml2 {
  */
 class CPPCHECKLIB Library {
     friend class TestSymbolDatabase; // For testing only
+    friend class LibraryCache;
 
 public:
     Library();
@@ -70,6 +73,32 @@ public:
     /** this is primarily meant for unit tests. it only returns true/false */
     bool loadxmldata(const char xmldata[], std::size_t len);
 
+    /**
+     * Directory for the binary cache of the loaded cfg files (--library-cache-dir).
+     * When it is set, load() reads the library from the cache if the cfg files
+     * have been loaded before, and writes the cache otherwise.
+     */
+    void setCacheDir(const std::string &cacheDir) {
+        mCacheDir = cacheDir;
+    }
+    const std::string &cacheDir() const {
+        return mCacheDir;
+    }
+
+    /**
+     * Restore the library from the cache if the given cfg files have been
+     * loaded in this order before. Later calls of load() for these files are
+     * ignored then. Loading the cfg files one by one would read a cache file
+     * for each of them.
+     * @return true if the library was loaded from the cache
+     */
+    bool loadCache(const char exename[], const std::list<std::string> &paths);
+
+    /** Hash of the content of the loaded cfg files, it changes when another cfg file is loaded */
+    unsigned long long checksum() const {
+        return mChecksum;
+    }
+
     struct AllocFunc {
         int groupId;
         int arg;
@@ -315,7 +344,7 @@ public:
     };
 
     const Function *getFunction(const Token *ftok) const;
-    std::map<std::string, Function> functions;
+    std::unordered_map<std::string, Function> functions;
     bool isUse(const std::string& functionName) const;
     bool isLeakIgnore(const std::string& functionName) const;
     bool isFunctionConst(const std::string& functionName, bool pure) const;
@@ -496,10 +525,14 @@ public:
     TypeCheck getTypeCheck(const std::string &check, const std::string &typeName) const;
 
 private:
+    // load a cfg file with the binary cache, loaded is false if the file should be loaded without the cache
+    Error loadCached(const char exename[], const char path[], bool *loaded);
+
     // load a <function> xml node
     Error loadFunction(const tinyxml2::XMLElement * const node, const std::string &name, std::set<std::string> &unknown_elements);
 
     class ExportedFunctions {
+        friend class LibraryCache;
     public:
         void addPrefix(const std::string& prefix) {
             mPrefixes.insert(prefix);
@@ -519,6 +552,7 @@ private:
         std::set<std::string> mSuffixes;
     };
     class CodeBlock {
+        friend class LibraryCache;
     public:
         CodeBlock() : mOffset(0) {}
 
@@ -553,16 +587,18 @@ private:
         int mOffset;
         std::set<std::string> mBlocks;
     };
+    // The data is written to the binary cache by LibraryCache, update it when adding members
     int mAllocId;
     std::set<std::string> mFiles;
-    std::map<std::string, AllocFunc> mAlloc; // allocation functions
-    std::map<std::string, AllocFunc> mDealloc; // deallocation functions
-    std::map<std::string, AllocFunc> mRealloc; // reallocation functions
-    std::map<std::string, bool> mNoReturn; // is function noreturn?
-    std::map<std::string, std::string> mReturnValue;
-    std::map<std::string, std::string> mReturnValueType;
-    std::map<std::string, int> mReturnValueContainer;
-    std::map<std::string, std::vector<MathLib::bigint>> mUnknownReturnValues;
+    unsigned long long mChecksum; // hash of the loaded cfg files and their contents
+    std::unordered_map<std::string, AllocFunc> mAlloc; // allocation functions
+    std::unordered_map<std::string, AllocFunc> mDealloc; // deallocation functions
+    std::unordered_map<std::string, AllocFunc> mRealloc; // reallocation functions
+    std::unordered_map<std::string, bool> mNoReturn; // is function noreturn?
+    std::unordered_map<std::string, std::string> mReturnValue;
+    std::unordered_map<std::string, std::string> mReturnValueType;
+    std::unordered_map<std::string, int> mReturnValueContainer;
+    std::unordered_map<std::string, std::vector<MathLib::bigint>> mUnknownReturnValues;
     std::map<std::string, bool> mReportErrors;
     std::map<std::string, bool> mProcessAfterCode;
     std::set<std::string> mMarkupExtensions; // file extensions of markup files
@@ -576,12 +612,16 @@ private:
     std::map<std::string, Platform> mPlatforms; // platform dependent typedefs
     std::map<std::pair<std::string,std::string>, TypeCheck> mTypeChecks;
 
+    std::string mCacheDir;
+    unsigned long long mCacheKey; // hash of the loaded cfg files
+    bool mCacheKeyValid; // false if the library was changed without a cfg file
+
     const ArgumentChecks * getarg(const Token *ftok, int argnr) const;
 
     std::string getFunctionName(const Token *ftok, bool *error) const;
 
-    static const AllocFunc* getAllocDealloc(const std::map<std::string, AllocFunc> &data, const std::string &name) {
-        const std::map<std::string, AllocFunc>::const_iterator it = data.find(name);
+    static const AllocFunc* getAllocDealloc(const std::unordered_map<std::string, AllocFunc> &data, const std::string &name) {
+        const std::unordered_map<std::string, AllocFunc>::const_iterator it = data.find(name);
         return (it == data.end()) ? nullptr : &it->second;
     }
 };
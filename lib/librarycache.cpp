@@ -0,0 +1,475 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2020 Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "librarycache.h"
+
+#include "library.h"
+#include "standards.h"
+#include "version.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+static const char MAGIC[] = "cppcheck library cache";
+
+// Increase this when the data of the Library is changed
+static const unsigned int FORMAT_VERSION = 2;
+
+namespace {
+    /** Writes the values in a binary format */
+    class Writer {
+    public:
+        static const bool reading = false;
+
+        explicit Writer(std::string &data) : mData(data) {}
+
+        bool ok() const {
+            return true;
+        }
+
+        template<class T>
+        void value(T &x) {
+            const unsigned long long v = static_cast<unsigned long long>(x);
+            for (int i = 0; i < 8; ++i)
+                mData += static_cast<char>((v >> (8 * i)) & 0xff);
+        }
+
+        void size(std::size_t &n) {
+            value(n);
+        }
+
+        void string(std::string &s) {
+            std::size_t n = s.size();
+            size(n);
+            mData += s;
+        }
+
+    private:
+        std::string &mData;
+    };
+
+    /** Reads the values written by the Writer. Stops reading when the data is invalid. */
+    class Reader {
+    public:
+        static const bool reading = true;
+
+        explicit Reader(const std::string &data) : mData(data), mPos(0), mOk(true) {}
+
+        bool ok() const {
+            return mOk;
+        }
+
+        bool atEnd() const {
+            return mPos == mData.size();
+        }
+
+        template<class T>
+        void value(T &x) {
+            if (!mOk || mData.size() - mPos < 8) {
+                mOk = false;
+                x = T();
+                return;
+            }
+            unsigned long long v = 0;
+            for (int i = 0; i < 8; ++i)
+                v |= static_cast<unsigned long long>(static_cast<unsigned char>(mData[mPos + i])) << (8 * i);
+            mPos += 8;
+            x = static_cast<T>(v);
+        }
+
+        void size(std::size_t &n) {
+            value(n);
+            // every item needs at least one byte
+            if (n > mData.size() - mPos) {
+                mOk = false;
+                n = 0;
+            }
+        }
+
+        void string(std::string &s) {
+            std::size_t n;
+            size(n);
+            s = mData.substr(mPos, n);
+            mPos += n;
+        }
+
+    private:
+        const std::string &mData;
+        std::size_t mPos;
+        bool mOk;
+    };
+}
+
+template<class Archive>
+class LibraryCache::Serializer {
+public:
+    template<class T>
+    static typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type io(Archive &ar, T &x) {
+        ar.value(x);
+    }
+
+    static void io(Archive &ar, std::string &s) {
+        ar.string(s);
+    }
+
+    template<class T>
+    static void io(Archive &ar, std::vector<T> &v) {
+        std::size_t n = v.size();
+        ar.size(n);
+        if (Archive::reading) {
+            v.clear();
+            for (std::size_t i = 0; i < n && ar.ok(); ++i) {
+                T item = create(static_cast<T *>(nullptr));
+                io(ar, item);
+                v.push_back(std::move(item));
+            }
+        } else {
+            for (T &item : v)
+                io(ar, item);
+        }
+    }
+
+    template<class T>
+    static void io(Archive &ar, std::set<T> &s) {
+        std::size_t n = s.size();
+        ar.size(n);
+        if (Archive::reading) {
+            s.clear();
+            for (std::size_t i = 0; i < n && ar.ok(); ++i) {
+                T item = create(static_cast<T *>(nullptr));
+                io(ar, item);
+                s.emplace_hint(s.end(), std::move(item)); // the items are written in order
+            }
+        } else {
+            for (const T &item : s)
+                io(ar, const_cast<T &>(item));
+        }
+    }
+
+    template<class K, class V>
+    static void io(Archive &ar, std::map<K, V> &m) {
+        std::size_t n = m.size();
+        ar.size(n);
+        if (Archive::reading) {
+            m.clear();
+            for (std::size_t i = 0; i < n && ar.ok(); ++i) {
+                K key = create(static_cast<K *>(nullptr));
+                V value = create(static_cast<V *>(nullptr));
+                io(ar, key);
+                io(ar, value);
+                m.emplace_hint(m.end(), std::move(key), std::move(value)); // the items are written in order
+            }
+        } else {
+            for (std::pair<const K, V> &item : m) {
+                io(ar, const_cast<K &>(item.first));
+                io(ar, item.second);
+            }
+        }
+    }
+
+    template<class K, class V>
+    static void io(Archive &ar, std::unordered_map<K, V> &m) {
+        std::size_t n = m.size();
+        ar.size(n);
+        if (Archive::reading) {
+            m.clear();
+            m.reserve(n);
+            for (std::size_t i = 0; i < n && ar.ok(); ++i) {
+                K key = create(static_cast<K *>(nullptr));
+                V value = create(static_cast<V *>(nullptr));
+                io(ar, key);
+                io(ar, value);
+                m.emplace(std::move(key), std::move(value));
+            }
+        } else {
+            // write the items in order so the file does not depend on the hashing
+            std::vector<std::pair<const K, V> *> items;
+            items.reserve(n);
+            for (std::pair<const K, V> &item : m)
+                items.push_back(&item);
+            std::sort(items.begin(), items.end(), [](const std::pair<const K, V> *a, const std::pair<const K, V> *b) {
+                return a->first < b->first;
+            });
+            for (std::pair<const K, V> *item : items) {
+                io(ar, const_cast<K &>(item->first));
+                io(ar, item->second);
+            }
+        }
+    }
+
+    template<class A, class B>
+    static void io(Archive &ar, std::pair<A, B> &p) {
+        io(ar, p.first);
+        io(ar, p.second);
+    }
+
+    static void io(Archive &ar, Standards &standards) {
+        io(ar, standards.c);
+        io(ar, standards.cpp);
+        io(ar, standards.stdValue);
+    }
+
+    static void io(Archive &ar, Library::AllocFunc &f) {
+        io(ar, f.groupId);
+        io(ar, f.arg);
+        io(ar, f.bufferSize);
+        io(ar, f.bufferSizeArg1);
+        io(ar, f.bufferSizeArg2);
+        io(ar, f.reallocArg);
+        io(ar, f.initData);
+    }
+
+    static void io(Archive &ar, Library::WarnInfo &w) {
+        io(ar, w.message);
+        io(ar, w.standards);
+        io(ar, w.severity);
+    }
+
+    static void io(Archive &ar, Library::Container::Function &f) {
+        io(ar, f.action);
+        io(ar, f.yield);
+    }
+
+    static void io(Archive &ar, Library::Container &c) {
+        io(ar, c.startPattern);
+        io(ar, c.startPattern2);
+        io(ar, c.endPattern);
+        io(ar, c.itEndPattern);
+        io(ar, c.functions);
+        io(ar, c.type_templateArgNo);
+        io(ar, c.size_templateArgNo);
+        io(ar, c.arrayLike_indexOp);
+        io(ar, c.stdStringLike);
+        io(ar, c.stdAssociativeLike);
+        io(ar, c.opLessAllowed);
+        io(ar, c.hasInitializerListConstructor);
+        io(ar, c.unstableErase);
+        io(ar, c.unstableInsert);
+    }
+
+    static void io(Archive &ar, Library::ArgumentChecks::MinSize &minsize) {
+        io(ar, minsize.type);
+        io(ar, minsize.arg);
+        io(ar, minsize.arg2);
+        io(ar, minsize.value);
+    }
+
+    static void io(Archive &ar, Library::ArgumentChecks &a) {
+        io(ar, a.notbool);
+        io(ar, a.notnull);
+        io(ar, a.notuninit);
+        io(ar, a.formatstr);
+        io(ar, a.strz);
+        io(ar, a.optional);
+        io(ar, a.variadic);
+        io(ar, a.valid);
+        io(ar, a.iteratorInfo.container);
+        io(ar, a.iteratorInfo.it);
+        io(ar, a.iteratorInfo.first);
+        io(ar, a.iteratorInfo.last);
+        io(ar, a.minsizes);
+        io(ar, a.direction);
+    }
+
+    static void io(Archive &ar, Library::Function &f) {
+        io(ar, f.argumentChecks);
+        io(ar, f.use);
+        io(ar, f.leakignore);
+        io(ar, f.isconst);
+        io(ar, f.ispure);
+        io(ar, f.useretval);
+        io(ar, f.ignore);
+        io(ar, f.formatstr);
+        io(ar, f.formatstr_scan);
+        io(ar, f.formatstr_secure);
+    }
+
+    static void io(Archive &ar, Library::PodType &p) {
+        io(ar, p.size);
+        io(ar, p.sign);
+        io(ar, p.stdtype);
+    }
+
+    static void io(Archive &ar, Library::PlatformType &p) {
+        io(ar, p.mType);
+        io(ar, p.mSigned);
+        io(ar, p.mUnsigned);
+        io(ar, p.mLong);
+        io(ar, p.mPointer);
+        io(ar, p.mPtrPtr);
+        io(ar, p.mConstPtr);
+    }
+
+    static void io(Archive &ar, Library::Platform &p) {
+        io(ar, p.mPlatformTypes);
+    }
+
+    static void io(Archive &ar, Library::CodeBlock &c) {
+        io(ar, c.mStart);
+        io(ar, c.mEnd);
+        io(ar, c.mOffset);
+        io(ar, c.mBlocks);
+    }
+
+    static void io(Archive &ar, Library::ExportedFunctions &e) {
+        io(ar, e.mPrefixes);
+        io(ar, e.mSuffixes);
+    }
+
+    static void io(Archive &ar, Library &library) {
+        io(ar, library.functionwarn);
+        io(ar, library.containers);
+        io(ar, library.functions);
+        io(ar, library.defines);
+        io(ar, library.smartPointers);
+        io(ar, library.mAllocId);
+        io(ar, library.mFiles);
+        io(ar, library.mChecksum);
+        io(ar, library.mAlloc);
+        io(ar, library.mDealloc);
+        io(ar, library.mRealloc);
+        io(ar, library.mNoReturn);
+        io(ar, library.mReturnValue);
+        io(ar, library.mReturnValueType);
+        io(ar, library.mReturnValueContainer);
+        io(ar, library.mUnknownReturnValues);
+        io(ar, library.mReportErrors);
+        io(ar, library.mProcessAfterCode);
+        io(ar, library.mMarkupExtensions);
+        io(ar, library.mKeywords);
+        io(ar, library.mExecutableBlocks);
+        io(ar, library.mExporters);
+        io(ar, library.mImporters);
+        io(ar, library.mReflection);
+        io(ar, library.mPodTypes);
+        io(ar, library.mPlatformTypes);
+        io(ar, library.mPlatforms);
+        io(ar, library.mTypeChecks);
+    }
+
+    /** Header that identifies the format, the cppcheck version and the key */
+    static bool header(Archive &ar, unsigned long long key) {
+        std::string magic(MAGIC);
+        unsigned int formatVersion = FORMAT_VERSION;
+        std::string version(CPPCHECK_VERSION_STRING);
+        unsigned long long fileKey = key;
+        io(ar, magic);
+        io(ar, formatVersion);
+        io(ar, version);
+        io(ar, fileKey);
+        return ar.ok() && magic == MAGIC && formatVersion == FORMAT_VERSION && version == CPPCHECK_VERSION_STRING && fileKey == key;
+    }
+
+private:
+    template<class T>
+    static T create(T *) {
+        return T();
+    }
+
+    static Library::ArgumentChecks::MinSize create(Library::ArgumentChecks::MinSize *) {
+        return Library::ArgumentChecks::MinSize(Library::ArgumentChecks::MinSize::NONE, 0);
+    }
+};
+
+unsigned long long LibraryCache::hash(unsigned long long key, const std::string &data)
+{
+    // FNV-1a
+    unsigned long long h = key ^ 14695981039346656037ULL;
+    for (const char c : data) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+std::string LibraryCache::filename(unsigned long long key)
+{
+    std::ostringstream ostr;
+    ostr << std::hex;
+    ostr.width(16);
+    ostr.fill('0');
+    ostr << key << ".cfgcache";
+    return ostr.str();
+}
+
+bool LibraryCache::load(Library &library, const std::string &filename, unsigned long long key)
+{
+    std::ifstream fin(filename, std::ios::binary);
+    if (!fin.is_open())
+        return false;
+    fin.seekg(0, std::ios::end);
+    const std::streamoff size = fin.tellg();
+    if (size <= 0)
+        return false;
+    std::string data(static_cast<std::size_t>(size), '\0');
+    fin.seekg(0, std::ios::beg);
+    if (!fin.read(&data[0], size))
+        return false;
+
+    Reader reader(data);
+    if (!Serializer<Reader>::header(reader, key))
+        return false;
+    Library cached;
+    Serializer<Reader>::io(reader, cached);
+    if (!reader.ok() || !reader.atEnd())
+        return false;
+
+    cached.mCacheDir = library.mCacheDir;
+    cached.mCacheKey = key;
+    cached.mCacheKeyValid = true;
+    library = std::move(cached);
+    return true;
+}
+
+bool LibraryCache::save(const Library &library, const std::string &filename, unsigned long long key)
+{
+    std::string data;
+    Writer writer(data);
+    Serializer<Writer>::header(writer, key);
+    // The writer does not change the library
+    Serializer<Writer>::io(writer, const_cast<Library &>(library));
+
+    // Other processes might read the cache file at the same time so write a temporary file first
+    const std::string tempname = filename + '.' + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        std::ofstream fout(tempname, std::ios::binary);
+        if (!fout.is_open())
+            return false;
+        fout.write(data.data(), data.size());
+        if (!fout.good()) {
+            fout.close();
+            std::remove(tempname.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tempname.c_str(), filename.c_str()) != 0) {
+        std::remove(tempname.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2020 Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef librarycacheH
+#define librarycacheH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+
+#include <string>
+
+class Library;
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Binary cache for loaded library configurations.
+ *
+ * Loading the .cfg files with tinyxml2 and building the Library tables is
+ * a noticeable part of the startup time of short cppcheck runs. When a
+ * library cache directory is configured the state of the Library after a
+ * .cfg file is loaded is written to a binary file. The file is identified
+ * by a key that is the hash of the cfg files that have been loaded so far
+ * and their contents, so changed cfg files are never read from the cache.
+ */
+class CPPCHECKLIB LibraryCache {
+public:
+    /** Hash data into a key, start with key 0 */
+    static unsigned long long hash(unsigned long long key, const std::string &data);
+
+    /** Name of the cache file for a key */
+    static std::string filename(unsigned long long key);
+
+    /**
+     * Replace the library with the cached library.
+     * @return false if the file does not exist, is not written by this version
+     *         of cppcheck or is for another key. The library is not changed then.
+     */
+    static bool load(Library &library, const std::string &filename, unsigned long long key);
+
+    /** Write the library to the cache file */
+    static bool save(const Library &library, const std::string &filename, unsigned long long key);
+
+private:
+    template<class Archive> class Serializer;
+};
+
+/// @}
+//---------------------------------------------------------------------------
+#endif // librarycacheH
@@ -108,6 +108,19 @@ public:
 
     void removeComments();
 
+    /**
+     * Get the paths that are tried before the included files are found,
+     * see HeaderCache::getMissedFiles(). Call it after the code is preprocessed
+     * so the files included with macros are known.
+     * @return false if a file is included with a macro, then its path is not known
+     */
+    bool getMissedIncludeFiles(const simplecpp::TokenList &rawtokens, std::set<std::string> *missedFiles) const;
+
+    /** Was there an include file that could not be found, also if the missingInclude message is suppressed */
+    bool hasMissingIncludes() const {
+        return mMissingIncludes;
+    }
+
     void setPlatformInfo(simplecpp::TokenList *tokens) const;
 
     /**
@@ -170,13 +183,14 @@ public:
     void validateCfgError(const std::string &file, const unsigned int line, const std::string &cfg, const std::string &macro);
 
     /**
-     * Calculate CRC32 checksum. Using toolinfo, tokens1, filedata.
+     * Calculate 64 bit checksum. Using toolinfo, tokens1, filedata.
+     * The checksums of the included files are calculated once per process.
      *
      * @param tokens1    Sourcefile tokens
      * @param toolinfo   Arbitrary extra toolinfo
-     * @return CRC32 checksum
+     * @return checksum
      */
-    unsigned int calculateChecksum(const simplecpp::TokenList &tokens1, const std::string &toolinfo) const;
+    unsigned long long calculateChecksum(const simplecpp::TokenList &tokens1, const std::string &toolinfo) const;
 
     void simplifyPragmaAsm(simplecpp::TokenList *tokenList);
 
@@ -208,6 +222,11 @@ public:
 
     void reportOutput(const simplecpp::OutputList &outputList, bool showerror);
 
+    /** errors are reported to this logger, see CppCheck::checkConfigurations */
+    void setErrorLogger(ErrorLogger *errorLogger) {
+        mErrorLogger = errorLogger;
+    }
+
 private:
     void missingInclude(const std::string &filename, unsigned int linenr, const std::string &header, HeaderTypes headerType);
     void error(const std::string &filename, unsigned int linenr, const std::string &msg);
@@ -222,6 +241,8 @@ private:
 
     /** filename for cpp/c file - useful when reporting errors */
     std::string mFile0;
+
+    bool mMissingIncludes;
 };
 
 /// @}
@@ -39,6 +39,7 @@ Settings::Settings()
       clang(false),
       clangExecutable("clang"),
       clangTidy(false),
+      configJobs(1),
       daca(false),
       debugBugHunting(false),
       debugnormal(false),
@@ -48,6 +49,7 @@ Settings::Settings()
       dump(false),
       enforcedLang(None),
       exceptionHandling(false),
+      executor(ExecutorType::Thread),
       exitCode(0),
       experimental(false),
       force(false),
@@ -64,6 +66,7 @@ Settings::Settings()
       relativePaths(false),
       reportProgress(false),
       showtime(SHOWTIME_MODES::SHOWTIME_NONE),
+      valueFlowJobs(1),
       verbose(false),
       xml(false),
       xml_version(2)
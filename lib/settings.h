@@ -124,6 +124,10 @@ public:
     /** @brief include paths excluded from checking the configuration */
     std::set<std::string> configExcludePaths;
 
+    /** @brief How many threads should check the preprocessor configurations
+        of a single file at the same time. Default is 1. (--config-jobs=N) */
+    unsigned int configJobs;
+
     /** @brief Are we running from DACA script? */
     bool daca;
 
@@ -156,6 +160,14 @@ public:
     /** @brief Is --exception-handling given */
     bool exceptionHandling;
 
+    enum class ExecutorType {
+        Thread, Process
+    };
+
+    /** @brief How the files are checked when -j is used. Process
+        isolates crashes but is only available where fork() is. (--executor) */
+    ExecutorType executor;
+
     // argv[0]
     std::string exename;
 
@@ -338,6 +350,10 @@ public:
     /** @brief forced includes given by the user */
     std::list<std::string> userIncludes;
 
+    /** @brief How many threads should run the ValueFlow passes that analyse
+        one function at a time. Default is 1. (--valueflow-jobs=N) */
+    unsigned int valueFlowJobs;
+
     /** @brief Is --verbose given? */
     bool verbose;
 
@@ -42,6 +42,47 @@ static bool isAcceptedErrorIdChar(char c)
     }
 }
 
+static bool isGlobPattern(const std::string &pattern)
+{
+    return pattern.find_first_of("*?") != std::string::npos;
+}
+
+/** Match a suppression pattern. Patterns without wildcards are compared directly, like matchglob() a '/' matches a '\\'. */
+static bool matchPattern(const std::string &pattern, const std::string &name)
+{
+    if (isGlobPattern(pattern))
+        return matchglob(pattern, name);
+    if (pattern.size() != name.size())
+        return false;
+    for (std::string::size_type pos = 0; pos < pattern.size(); ++pos) {
+        if (pattern[pos] == name[pos])
+            continue;
+        if ((pattern[pos] == '/' || pattern[pos] == '\\') && (name[pos] == '/' || name[pos] == '\\'))
+            continue;
+        return false;
+    }
+    return true;
+}
+
+/** File name used in the index keys, the path separators are unified since they match each other */
+static std::string getIndexFileName(std::string fileName)
+{
+    std::replace(fileName.begin(), fileName.end(), '\\', '/');
+    return fileName;
+}
+
+static std::string getIndexKey(const std::string &errorId, const std::string &indexFileName, int lineNumber)
+{
+    return errorId + '\n' + indexFileName + '\n' + MathLib::toString(lineNumber);
+}
+
+template<class Key>
+static const std::vector<std::size_t> *findPositions(const std::unordered_map<Key, std::vector<std::size_t>> &positions, const Key &key)
+{
+    const typename std::unordered_map<Key, std::vector<std::size_t>>::const_iterator it = positions.find(key);
+    return it == positions.end() ? nullptr : &it->second;
+}
+
 std::string Suppressions::parseFile(std::istream &istr)
 {
     // Change '\r' to '\n' in the istr
@@ -238,10 +279,31 @@ std::string Suppressions::addSuppression(const Suppressions::Suppression &suppre
         return "Failed to add suppression. Invalid glob pattern '" + suppression.fileName + "'.";
 
     mSuppressions.push_back(suppression);
+    addToIndex(mSuppressions.size() - 1);
 
     return "";
 }
 
+void Suppressions::addToIndex(std::size_t pos)
+{
+    const Suppression &s = mSuppressions[pos];
+    const bool exactErrorId = !s.errorId.empty() && !isGlobPattern(s.errorId);
+    const bool exactFileName = !s.fileName.empty() && !isGlobPattern(s.fileName);
+    if (exactErrorId && exactFileName) {
+        const std::string fileName = getIndexFileName(s.fileName);
+        mIndex.errorIdFileLine[getIndexKey(s.errorId, fileName, s.lineNumber)].push_back(pos);
+        if (s.thisAndNextLine && s.lineNumber != Suppression::NO_LINE)
+            mIndex.errorIdFileLine[getIndexKey(s.errorId, fileName, s.lineNumber + 1)].push_back(pos);
+    } else if (exactErrorId)
+        mIndex.errorId[s.errorId].push_back(pos);
+    else if (s.hash > 0)
+        mIndex.hash[s.hash].push_back(pos);
+    else if (exactFileName)
+        mIndex.fileName[getIndexFileName(s.fileName)].push_back(pos);
+    else
+        mIndex.glob.push_back(pos);
+}
+
 void Suppressions::ErrorMessage::setFileName(const std::string &s)
 {
     mFileName = Path::simplifyPath(s);
@@ -287,27 +349,24 @@ bool Suppressions::Suppression::isSuppressed(const Suppressions::ErrorMessage &e
 {
     if (hash > 0 && hash != errmsg.hash)
         return false;
-    if (!errorId.empty() && !matchglob(errorId, errmsg.errorId))
+    if (!errorId.empty() && !matchPattern(errorId, errmsg.errorId))
         return false;
-    if (!fileName.empty() && !matchglob(fileName, errmsg.getFileName()))
+    if (!fileName.empty() && !matchPattern(fileName, errmsg.getFileName()))
         return false;
     if (lineNumber != NO_LINE && lineNumber != errmsg.lineNumber) {
         if (!thisAndNextLine || lineNumber + 1 != errmsg.lineNumber)
             return false;
     }
     if (!symbolName.empty()) {
+        std::string symname;
         for (std::string::size_type pos = 0; pos < errmsg.symbolNames.size();) {
-            const std::string::size_type pos2 = errmsg.symbolNames.find('\n',pos);
-            std::string symname;
-            if (pos2 == std::string::npos) {
-                symname = errmsg.symbolNames.substr(pos);
-                pos = pos2;
-            } else {
-                symname = errmsg.symbolNames.substr(pos,pos2-pos);
-                pos = pos2+1;
-            }
-            if (matchglob(symbolName, symname))
+            std::string::size_type pos2 = errmsg.symbolNames.find('\n',pos);
+            if (pos2 == std::string::npos)
+                pos2 = errmsg.symbolNames.size();
+            symname.assign(errmsg.symbolNames, pos, pos2 - pos);
+            if (matchPattern(symbolName, symname))
                 return true;
+            pos = pos2 + 1;
         }
         return false;
     }
@@ -340,35 +399,57 @@ std::string Suppressions::Suppression::getText() const
     return ret;
 }
 
-bool Suppressions::isSuppressed(const Suppressions::ErrorMessage &errmsg)
+const Suppressions::Suppression *Suppressions::findMatch(const Suppressions::ErrorMessage &errmsg, bool localOnly)
 {
     const bool unmatchedSuppression(errmsg.errorId == "unmatchedSuppression");
-    for (Suppression &s : mSuppressions) {
-        if (unmatchedSuppression && s.errorId != errmsg.errorId)
-            continue;
-        if (s.isMatch(errmsg))
-            return true;
+    const std::string fileName = getIndexFileName(errmsg.getFileName());
+    std::size_t first = mSuppressions.size();
+    const auto search = [&](const std::vector<std::size_t> *positions) {
+        if (!positions)
+            return;
+        for (const std::size_t pos : *positions) {
+            if (pos >= first)
+                break;
+            if (localOnly && !mSuppressions[pos].isLocal())
+                continue;
+            if (mSuppressions[pos].isSuppressed(errmsg)) {
+                first = pos;
+                break;
+            }
+        }
+    };
+
+    // The errorId of the suppression must be "unmatchedSuppression" to match an unmatchedSuppression
+    search(findPositions(mIndex.errorIdFileLine, getIndexKey(errmsg.errorId, fileName, errmsg.lineNumber)));
+    search(findPositions(mIndex.errorIdFileLine, getIndexKey(errmsg.errorId, fileName, Suppression::NO_LINE)));
+    if (!localOnly)
+        search(findPositions(mIndex.errorId, errmsg.errorId));
+    if (!unmatchedSuppression) {
+        search(findPositions(mIndex.hash, errmsg.hash));
+        search(findPositions(mIndex.fileName, fileName));
+        if (!localOnly)
+            search(&mIndex.glob);
     }
-    return false;
+
+    if (first == mSuppressions.size())
+        return nullptr;
+    mSuppressions[first].matched = true;
+    return &mSuppressions[first];
+}
+
+bool Suppressions::isSuppressed(const Suppressions::ErrorMessage &errmsg)
+{
+    return findMatch(errmsg, false) != nullptr;
 }
 
 bool Suppressions::isSuppressedLocal(const Suppressions::ErrorMessage &errmsg)
 {
-    const bool unmatchedSuppression(errmsg.errorId == "unmatchedSuppression");
-    for (Suppression &s : mSuppressions) {
-        if (!s.isLocal())
-            continue;
-        if (unmatchedSuppression && s.errorId != errmsg.errorId)
-            continue;
-        if (s.isMatch(errmsg))
-            return true;
-    }
-    return false;
+    return findMatch(errmsg, true) != nullptr;
 }
 
 void Suppressions::dump(std::ostream & out) const
 {
-    out << "  <suppressions>" << std::endl;
+    out << "  <suppressions>\n";
     for (const Suppression &suppression : mSuppressions) {
         out << "    <suppression";
         out << " errorId=\"" << ErrorLogger::toxml(suppression.errorId) << '"';
@@ -380,9 +461,9 @@ void Suppressions::dump(std::ostream & out) const
             out << " symbolName=\"" << ErrorLogger::toxml(suppression.symbolName) << '\"';
         if (suppression.hash > 0)
             out << " hash=\"" << suppression.hash << '\"';
-        out << " />" << std::endl;
+        out << " />\n";
     }
-    out << "  </suppressions>" << std::endl;
+    out << "  </suppressions>\n";
 }
 
 std::list<Suppressions::Suppression> Suppressions::getUnmatchedLocalSuppressions(const std::string &file, const bool unusedFunctionChecking) const
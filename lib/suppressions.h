@@ -25,6 +25,7 @@
 #include <istream>
 #include <list>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /// @addtogroup Core
@@ -180,8 +181,39 @@ public:
     std::list<Suppression> getUnmatchedGlobalSuppressions(const bool unusedFunctionChecking) const;
 
 private:
+    /**
+     * @brief Find the first suppression in the list that matches the error and mark it as matched.
+     * @param errmsg error message
+     * @param localOnly only use local suppressions
+     * @return the matching suppression, nullptr if there is none
+     */
+    const Suppression *findMatch(const ErrorMessage &errmsg, bool localOnly);
+
+    /** @brief Add the suppression at position @p pos in mSuppressions to mIndex */
+    void addToIndex(std::size_t pos);
+
     /** @brief List of error which the user doesn't want to see. */
-    std::list<Suppression> mSuppressions;
+    std::vector<Suppression> mSuppressions;
+
+    /**
+     * @brief Positions of the suppressions in mSuppressions, grouped by what
+     * must match exactly. Each suppression is put in the first group it fits in,
+     * the positions in a group are increasing so the first match in the list
+     * is found by looking at the first match in each group that can match.
+     */
+    struct Index {
+        /** errorId, file name and line number. A suppression without a line uses Suppression::NO_LINE */
+        std::unordered_map<std::string, std::vector<std::size_t>> errorIdFileLine;
+        /** errorId, the file name is empty or a glob pattern */
+        std::unordered_map<std::string, std::vector<std::size_t>> errorId;
+        /** hash, the errorId is empty or a glob pattern */
+        std::unordered_map<std::size_t, std::vector<std::size_t>> hash;
+        /** file name, the errorId is empty or a glob pattern */
+        std::unordered_map<std::string, std::vector<std::size_t>> fileName;
+        /** everything else, these are tested against all errors */
+        std::vector<std::size_t> glob;
+    };
+    Index mIndex;
 };
 
 /// @}
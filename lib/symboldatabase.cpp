@@ -73,6 +73,10 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
     createSymbolDatabaseEscapeFunctions();
     createSymbolDatabaseIncompleteVars();
     createSymbolDatabaseExprIds();
+
+    // The library function names depend on the function and type pointers, which were set after they were looked up
+    for (const Token *tok = mTokenizer->tokens(); tok; tok = tok->next())
+        tok->clearLibraryFunctionName();
 }
 
 static const Token* skipScopeIdentifiers(const Token* tok)
@@ -287,13 +291,13 @@ void SymbolDatabase::createSymbolDatabaseFindAllScopes()
 
                 if (new_scope->type == Scope::eEnum) {
                     tok2 = new_scope->addEnum(tok, mTokenizer->isCPP());
-                    scope->nestedList.push_back(new_scope);
+                    scope->addNestedScope(new_scope);
 
                     if (!tok2)
                         mTokenizer->syntaxError(tok);
                 } else {
                     // make the new scope the current scope
-                    scope->nestedList.push_back(new_scope);
+                    scope->addNestedScope(new_scope);
                     scope = new_scope;
                 }
 
@@ -323,7 +327,7 @@ void SymbolDatabase::createSymbolDatabaseFindAllScopes()
             }
 
             // make the new scope the current scope
-            scope->nestedList.push_back(new_scope);
+            scope->addNestedScope(new_scope);
             scope = &scopeList.back();
 
             tok = tok2;
@@ -412,7 +416,7 @@ void SymbolDatabase::createSymbolDatabaseFindAllScopes()
             }
 
             // make the new scope the current scope
-            scope->nestedList.push_back(new_scope);
+            scope->addNestedScope(new_scope);
             scope = new_scope;
 
             tok = tok2;
@@ -446,7 +450,7 @@ void SymbolDatabase::createSymbolDatabaseFindAllScopes()
             }
 
             // make the new scope the current scope
-            scope->nestedList.push_back(new_scope);
+            scope->addNestedScope(new_scope);
             scope = new_scope;
 
             tok = tok2;
@@ -658,7 +662,7 @@ void SymbolDatabase::createSymbolDatabaseFindAllScopes()
                     scopeList.emplace_back(this, tok, scope, Scope::eTry, tok1);
 
                 tok = tok1;
-                scope->nestedList.push_back(&scopeList.back());
+                scope->addNestedScope(&scopeList.back());
                 scope = &scopeList.back();
             } else if (tok->isKeyword() && Token::Match(tok, "if|for|while|catch|switch (") && Token::simpleMatch(tok->next()->link(), ") {")) {
                 const Token *scopeStartTok = tok->next()->link()->next();
@@ -673,7 +677,7 @@ void SymbolDatabase::createSymbolDatabaseFindAllScopes()
                 } else // if (tok->str() == "switch")
                     scopeList.emplace_back(this, tok, scope, Scope::eSwitch, scopeStartTok);
 
-                scope->nestedList.push_back(&scopeList.back());
+                scope->addNestedScope(&scopeList.back());
                 scope = &scopeList.back();
                 if (scope->type == Scope::eFor)
                     scope->checkVariable(tok->tokAt(2), AccessControl::Local, mSettings); // check for variable declaration and add it to new scope if found
@@ -693,7 +697,7 @@ void SymbolDatabase::createSymbolDatabaseFindAllScopes()
             } else if (tok->str() == "{") {
                 if (isExecutableScope(tok)) {
                     scopeList.emplace_back(this, tok, scope, Scope::eUnconditional, tok);
-                    scope->nestedList.push_back(&scopeList.back());
+                    scope->addNestedScope(&scopeList.back());
                     scope = &scopeList.back();
                 } else {
                     tok = tok->link();
@@ -1014,22 +1018,16 @@ void SymbolDatabase::createSymbolDatabaseSetScopePointers()
 
         end->scope(&*it);
 
+        std::set<const Token *> innerBodyStarts;
+        for (const Scope *innerScope : it->nestedList)
+            innerBodyStarts.insert(innerScope->bodyStart);
+
         for (Token* tok = start; tok != end; tok = tok->next()) {
-            if (start != end && tok->str() == "{") {
-                bool isEndOfScope = false;
-                for (std::list<Scope*>::const_iterator innerScope = it->nestedList.begin(); innerScope != it->nestedList.end(); ++innerScope) {
-                    if (tok == (*innerScope)->bodyStart) { // Is begin of inner scope
-                        tok = tok->link();
-                        if (tok->next() == end || !tok->next()) {
-                            isEndOfScope = true;
-                            break;
-                        }
-                        tok = tok->next();
-                        break;
-                    }
-                }
-                if (isEndOfScope)
+            if (start != end && tok->str() == "{" && innerBodyStarts.find(tok) != innerBodyStarts.end()) { // Is begin of inner scope
+                tok = tok->link();
+                if (tok->next() == end || !tok->next())
                     break;
+                tok = tok->next();
             }
             tok->scope(&*it);
         }
@@ -2813,7 +2811,7 @@ void SymbolDatabase::addNewFunction(Scope **scope, const Token **tok)
             return;
         }
 
-        (*scope)->nestedList.push_back(newScope);
+        (*scope)->addNestedScope(newScope);
         *scope = newScope;
         *tok = tok1;
     } else {
@@ -3480,7 +3478,7 @@ void SymbolDatabase::printXml(std::ostream &out) const
     std::set<const Variable *> variables;
 
     // Scopes..
-    out << "  <scopes>" << std::endl;
+    out << "  <scopes>\n";
     for (std::list<Scope>::const_iterator scope = scopeList.begin(); scope != scopeList.end(); ++scope) {
         out << "    <scope";
         out << " id=\"" << &*scope << "\"";
@@ -3496,11 +3494,11 @@ void SymbolDatabase::printXml(std::ostream &out) const
         if (scope->function)
             out << " function=\"" << scope->function << "\"";
         if (scope->functionList.empty() && scope->varlist.empty())
-            out << "/>" << std::endl;
+            out << "/>\n";
         else {
-            out << '>' << std::endl;
+            out << ">\n";
             if (!scope->functionList.empty()) {
-                out << "      <functionList>" << std::endl;
+                out << "      <functionList>\n";
                 for (std::list<Function>::const_iterator function = scope->functionList.begin(); function != scope->functionList.end(); ++function) {
                     out << "        <function id=\"" << &*function << "\" tokenDef=\"" << function->tokenDef << "\" name=\"" << ErrorLogger::toxml(function->name()) << '\"';
                     out << " type=\"" << (function->type == Function::eConstructor? "Constructor" :
@@ -3520,34 +3518,34 @@ void SymbolDatabase::printXml(std::ostream &out) const
                     if (function->isStatic())
                         out << " isStatic=\"true\"";
                     if (function->argCount() == 0U)
-                        out << "/>" << std::endl;
+                        out << "/>\n";
                     else {
-                        out << ">" << std::endl;
+                        out << ">\n";
                         for (unsigned int argnr = 0; argnr < function->argCount(); ++argnr) {
                             const Variable *arg = function->getArgumentVar(argnr);
-                            out << "          <arg nr=\"" << argnr+1 << "\" variable=\"" << arg << "\"/>" << std::endl;
+                            out << "          <arg nr=\"" << argnr+1 << "\" variable=\"" << arg << "\"/>\n";
                             variables.insert(arg);
                         }
-                        out << "        </function>" << std::endl;
+                        out << "        </function>\n";
                     }
                 }
-                out << "      </functionList>" << std::endl;
+                out << "      </functionList>\n";
             }
             if (!scope->varlist.empty()) {
-                out << "      <varlist>" << std::endl;
+                out << "      <varlist>\n";
                 for (std::list<Variable>::const_iterator var = scope->varlist.begin(); var != scope->varlist.end(); ++var)
-                    out << "        <var id=\""   << &*var << "\"/>" << std::endl;
-                out << "      </varlist>" << std::endl;
+                    out << "        <var id=\""   << &*var << "\"/>\n";
+                out << "      </varlist>\n";
             }
-            out << "    </scope>" << std::endl;
+            out << "    </scope>\n";
         }
     }
-    out << "  </scopes>" << std::endl;
+    out << "  </scopes>\n";
 
     // Variables..
     for (const Variable *var : mVariableList)
         variables.insert(var);
-    out << "  <variables>" << std::endl;
+    out << "  <variables>\n";
     for (const Variable *var : variables) {
         if (!var)
             continue;
@@ -3567,9 +3565,9 @@ void SymbolDatabase::printXml(std::ostream &out) const
         out << " isPointer=\""      << var->isPointer() << '\"';
         out << " isReference=\""    << var->isReference() << '\"';
         out << " isStatic=\""       << var->isStatic() << '\"';
-        out << "/>" << std::endl;
+        out << "/>\n";
     }
-    out << "  </variables>" << std::endl;
+    out << "  </variables>\n";
     out << std::resetiosflags(std::ios::boolalpha);
 }
 
@@ -3838,7 +3836,8 @@ Scope::Scope(const SymbolDatabase *check_, const Token *classDef_, const Scope *
     functionOf(nullptr),
     function(nullptr),
     enumType(nullptr),
-    enumClass(false)
+    enumClass(false),
+    valueChanges(0)
 {
 }
 
@@ -3854,7 +3853,8 @@ Scope::Scope(const SymbolDatabase *check_, const Token *classDef_, const Scope *
     functionOf(nullptr),
     function(nullptr),
     enumType(nullptr),
-    enumClass(false)
+    enumClass(false),
+    valueChanges(0)
 {
     const Token *nameTok = classDef;
     if (!classDef) {
@@ -4341,12 +4341,10 @@ const Enumerator * SymbolDatabase::findEnumerator(const Token * tok) const
                     return enumerator;
                 // enum
                 else {
-                    for (std::list<Scope *>::const_iterator it = scope->nestedList.begin(), end = scope->nestedList.end(); it != end; ++it) {
-                        enumerator = (*it)->findEnumerator(tokStr);
+                    enumerator = scope->findEnumeratorInNestedList(tokStr);
 
-                        if (enumerator)
-                            return enumerator;
-                    }
+                    if (enumerator)
+                        return enumerator;
                 }
             }
         }
@@ -4356,12 +4354,10 @@ const Enumerator * SymbolDatabase::findEnumerator(const Token * tok) const
         if (enumerator)
             return enumerator;
 
-        for (std::list<Scope *>::const_iterator s = scope->nestedList.begin(); s != scope->nestedList.end(); ++s) {
-            enumerator = (*s)->findEnumerator(tokStr);
+        enumerator = scope->findEnumeratorInNestedList(tokStr);
 
-            if (enumerator)
-                return enumerator;
-        }
+        if (enumerator)
+            return enumerator;
 
         if (scope->definedType) {
             const std::vector<Type::BaseInfo> & derivedFrom = scope->definedType->derivedFrom;
@@ -4387,12 +4383,10 @@ const Enumerator * SymbolDatabase::findEnumerator(const Token * tok) const
             if (enumerator)
                 return enumerator;
 
-            for (std::list<Scope*>::const_iterator s = scope->nestedList.begin(); s != scope->nestedList.end(); ++s) {
-                enumerator = (*s)->findEnumerator(tokStr);
+            enumerator = scope->findEnumeratorInNestedList(tokStr);
 
-                if (enumerator)
-                    return enumerator;
-            }
+            if (enumerator)
+                return enumerator;
         }
     }
 
@@ -4674,9 +4668,10 @@ const Function* Scope::findFunction(const Token *tok, bool requireConst) const
     addMatchingFunctions(this);
 
     // check in anonumous namespaces
-    for (const Scope *nestedScope : nestedList) {
-        if (nestedScope->type == eNamespace && nestedScope->className.empty())
-            addMatchingFunctions(nestedScope);
+    const auto anonymous = nestedListMap.equal_range(emptyString);
+    for (auto it = anonymous.first; it != anonymous.second; ++it) {
+        if (it->second->type == eNamespace)
+            addMatchingFunctions(it->second);
     }
 
     // check in base classes
@@ -4975,24 +4970,19 @@ const Scope *SymbolDatabase::findScopeByName(const std::string& name) const
 
 Scope *Scope::findInNestedList(const std::string & name)
 {
-    std::list<Scope *>::iterator it;
-
-    for (it = nestedList.begin(); it != nestedList.end(); ++it) {
-        if ((*it)->className == name)
-            return (*it);
-    }
-    return nullptr;
+    const std::multimap<std::string, Scope *>::const_iterator it = nestedListMap.find(name);
+    return it != nestedListMap.end() ? it->second : nullptr;
 }
 
 //---------------------------------------------------------------------------
 
 const Scope *Scope::findRecordInNestedList(const std::string & name) const
 {
-    std::list<Scope *>::const_iterator it;
+    const auto range = nestedListMap.equal_range(name);
 
-    for (it = nestedList.begin(); it != nestedList.end(); ++it) {
-        if ((*it)->className == name && (*it)->type != eFunction)
-            return (*it);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->type != eFunction)
+            return it->second;
     }
 
     const Type * nested_type = findType(name);
@@ -5021,8 +5011,10 @@ const Type* Scope::findType(const std::string & name) const
     // is type defined in anonymous namespace..
     it = definedTypesMap.find("");
     if (it != definedTypesMap.end()) {
-        for (const Scope *scope : nestedList) {
-            if (scope->className.empty() && (scope->type == eNamespace || scope->isClassOrStructOrUnion())) {
+        const auto anonymous = nestedListMap.equal_range(emptyString);
+        for (auto nested = anonymous.first; nested != anonymous.second; ++nested) {
+            const Scope *scope = nested->second;
+            if (scope->type == eNamespace || scope->isClassOrStructOrUnion()) {
                 const Type *t = scope->findType(name);
                 if (t)
                     return t;
@@ -5038,14 +5030,11 @@ const Type* Scope::findType(const std::string & name) const
 
 Scope *Scope::findInNestedListRecursive(const std::string & name)
 {
-    std::list<Scope *>::iterator it;
-
-    for (it = nestedList.begin(); it != nestedList.end(); ++it) {
-        if ((*it)->className == name)
-            return (*it);
-    }
+    Scope *nested = findInNestedList(name);
+    if (nested)
+        return nested;
 
-    for (it = nestedList.begin(); it != nestedList.end(); ++it) {
+    for (std::list<Scope *>::iterator it = nestedList.begin(); it != nestedList.end(); ++it) {
         Scope *child = (*it)->findInNestedListRecursive(name);
         if (child)
             return child;
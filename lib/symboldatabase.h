@@ -27,6 +27,7 @@
 #include "token.h"
 #include "utils.h"
 
+#include <atomic>
 #include <cstddef>
 #include <list>
 #include <map>
@@ -1005,6 +1006,7 @@ public:
     std::list<Variable> varlist;
     const Scope *nestedIn;
     std::list<Scope *> nestedList;
+    std::multimap<std::string, Scope *> nestedListMap;
     nonneg int numConstructors;
     nonneg int numCopyOrMoveConstructors;
     std::list<UsingInfo> usingList;
@@ -1022,6 +1024,15 @@ public:
 
     std::vector<Enumerator> enumeratorList;
 
+    /** enumerators of the nested enums, the first one in the nested list is used for each name */
+    std::map<std::string, const Enumerator *> nestedEnumeratorMap;
+
+    /**
+     * Number of ValueFlow value changes of the tokens in this function body.
+     * For the global scope the changes outside all function bodies are counted.
+     */
+    mutable std::atomic<std::size_t> valueChanges;
+
     const Enumerator * findEnumerator(const std::string & name) const {
         for (const Enumerator & i : enumeratorList) {
             if (i.name->str() == name)
@@ -1030,6 +1041,11 @@ public:
         return nullptr;
     }
 
+    const Enumerator * findEnumeratorInNestedList(const std::string & name) const {
+        const std::map<std::string, const Enumerator *>::const_iterator it = nestedEnumeratorMap.find(name);
+        return it != nestedEnumeratorMap.end() ? it->second : nullptr;
+    }
+
     bool isNestedIn(const Scope * outer) const {
         if (!outer)
             return false;
@@ -1123,6 +1139,15 @@ public:
         functionMap.insert(make_pair(back->tokenDef->str(), back));
     }
 
+    void addNestedScope(Scope *scope) {
+        nestedList.push_back(scope);
+
+        nestedListMap.insert(std::make_pair(scope->className, scope));
+
+        for (const Enumerator & enumerator : scope->enumeratorList)
+            nestedEnumeratorMap.insert(std::make_pair(enumerator.name->str(), &enumerator));
+    }
+
     bool hasDefaultConstructor() const;
 
     AccessControl defaultAccess() const;
@@ -42,26 +42,6 @@ namespace {
     private:
         const Token * const mToken;
     };
-
-    class FindName {
-    public:
-        explicit FindName(const std::string &name) : mName(name) {}
-        bool operator()(const TemplateSimplifier::TokenAndName &tokenAndName) const {
-            return tokenAndName.name() == mName;
-        }
-    private:
-        const std::string mName;
-    };
-
-    class FindFullName {
-    public:
-        explicit FindFullName(const std::string &fullName) : mFullName(fullName) {}
-        bool operator()(const TemplateSimplifier::TokenAndName &tokenAndName) const {
-            return tokenAndName.fullName() == mFullName;
-        }
-    private:
-        const std::string mFullName;
-    };
 }
 
 TemplateSimplifier::TokenAndName::TokenAndName(Token *token, const std::string &scope) :
@@ -755,7 +735,7 @@ bool TemplateSimplifier::getTemplateDeclarations()
                         mTemplateForwardDeclarations.emplace_back(std::move(decl));
                     } else {
                         // Implementation => add to mTemplateDeclarations
-                        mTemplateDeclarations.emplace_back(std::move(decl));
+                        addTemplateDeclaration(std::move(decl));
                     }
                     break;
                 }
@@ -772,12 +752,72 @@ void TemplateSimplifier::addInstantiation(Token *token, const std::string &scope
     TokenAndName instantiation(token, scope);
 
     // check if instantiation already exists before adding it
-    std::list<TokenAndName>::iterator it = std::find(mTemplateInstantiations.begin(),
-                                           mTemplateInstantiations.end(),
-                                           instantiation);
+    const auto it = mTemplateInstantiationsByName.find(instantiation.name());
+    if (it != mTemplateInstantiationsByName.end()) {
+        for (const std::list<TokenAndName>::iterator &ti : it->second) {
+            if (ti != mTemplateInstantiations.end() && *ti == instantiation)
+                return;
+        }
+    }
+
+    addTemplateInstantiation(instantiation);
+}
+
+void TemplateSimplifier::addTemplateDeclaration(TokenAndName &&declaration)
+{
+    mTemplateDeclarations.emplace_back(std::move(declaration));
+    const std::list<TokenAndName>::iterator it = std::prev(mTemplateDeclarations.end());
+    mTemplateDeclarationsByFullName[it->fullName()].push_back(it);
+}
 
-    if (it == mTemplateInstantiations.end())
-        mTemplateInstantiations.emplace_back(instantiation);
+std::list<TemplateSimplifier::TokenAndName>::iterator TemplateSimplifier::eraseTemplateDeclaration(std::list<TokenAndName>::iterator it)
+{
+    const auto byFullName = mTemplateDeclarationsByFullName.find(it->fullName());
+    if (byFullName != mTemplateDeclarationsByFullName.end()) {
+        std::vector<std::list<TokenAndName>::iterator> &declarations = byFullName->second;
+        declarations.erase(std::find(declarations.begin(), declarations.end(), it));
+        if (declarations.empty())
+            mTemplateDeclarationsByFullName.erase(byFullName);
+    }
+    return mTemplateDeclarations.erase(it);
+}
+
+std::list<TemplateSimplifier::TokenAndName>::iterator TemplateSimplifier::findTemplateDeclaration(const TokenAndName &declaration)
+{
+    const auto byFullName = mTemplateDeclarationsByFullName.find(declaration.fullName());
+    if (byFullName != mTemplateDeclarationsByFullName.end()) {
+        for (const std::list<TokenAndName>::iterator &it : byFullName->second) {
+            if (it->token() == declaration.token())
+                return it;
+        }
+    }
+    return mTemplateDeclarations.end();
+}
+
+void TemplateSimplifier::addTemplateInstantiation(const TokenAndName &instantiation)
+{
+    mTemplateInstantiations.emplace_back(instantiation);
+    mTemplateInstantiationsByName[instantiation.name()].push_back(std::prev(mTemplateInstantiations.end()));
+}
+
+std::list<TemplateSimplifier::TokenAndName>::iterator TemplateSimplifier::eraseTemplateInstantiation(std::list<TokenAndName>::iterator it)
+{
+    // the index is not shrunk so that it can be iterated while instantiations are erased
+    const auto byName = mTemplateInstantiationsByName.find(it->name());
+    if (byName != mTemplateInstantiationsByName.end())
+        std::replace(byName->second.begin(), byName->second.end(), it, mTemplateInstantiations.end());
+    return mTemplateInstantiations.erase(it);
+}
+
+bool TemplateSimplifier::hasTemplateInstantiation(const std::string &name) const
+{
+    const auto byName = mTemplateInstantiationsByName.find(name);
+    if (byName == mTemplateInstantiationsByName.end())
+        return false;
+    // erased instantiations are replaced by mTemplateInstantiations.end() in the index
+    return std::any_of(byName->second.begin(), byName->second.end(), [this](const std::list<TokenAndName>::iterator &it) {
+        return it != mTemplateInstantiations.end();
+    });
 }
 
 void TemplateSimplifier::getTemplateInstantiations()
@@ -944,10 +984,10 @@ void TemplateSimplifier::getTemplateInstantiations()
                 while (true) {
                     const std::string fullName = scopeName + (scopeName.empty()?"":" :: ") +
                                                  qualification + (qualification.empty()?"":" :: ") + tok->str();
-                    const std::list<TokenAndName>::const_iterator it = std::find_if(mTemplateDeclarations.begin(), mTemplateDeclarations.end(), FindFullName(fullName));
-                    if (it != mTemplateDeclarations.end()) {
+                    const auto it = mTemplateDeclarationsByFullName.find(fullName);
+                    if (it != mTemplateDeclarationsByFullName.end()) {
                         // full name matches
-                        addInstantiation(tok, it->scope());
+                        addInstantiation(tok, it->second.front()->scope());
                         break;
                     } else {
                         // full name doesn't match so try with using namespaces if available
@@ -956,8 +996,8 @@ void TemplateSimplifier::getTemplateInstantiations()
                             std::string fullNameSpace = scopeName + (scopeName.empty()?"":" :: ") +
                                                         nameSpace + (qualification.empty()?"":" :: ") + qualification;
                             std::string newFullName = fullNameSpace + " :: " + tok->str();
-                            const std::list<TokenAndName>::const_iterator it1 = std::find_if(mTemplateDeclarations.begin(), mTemplateDeclarations.end(), FindFullName(newFullName));
-                            if (it1 != mTemplateDeclarations.end()) {
+                            const auto it1 = mTemplateDeclarationsByFullName.find(newFullName);
+                            if (it1 != mTemplateDeclarationsByFullName.end()) {
                                 // insert using namespace into token stream
                                 std::string::size_type offset = 0;
                                 std::string::size_type pos = 0;
@@ -967,7 +1007,7 @@ void TemplateSimplifier::getTemplateInstantiations()
                                 }
                                 qualificationTok->insertToken(nameSpace.substr(offset), "", true);
                                 qualificationTok->insertToken("::", "", true);
-                                addInstantiation(tok, it1->scope());
+                                addInstantiation(tok, it1->second.front()->scope());
                                 found = true;
                                 break;
                             }
@@ -1179,7 +1219,7 @@ void TemplateSimplifier::useDefaultArgumentValues(TokenAndName &declaration)
                                                        mTemplateInstantiations.end(),
                                                        FindToken(tok2));
                 if (ti != mTemplateInstantiations.end())
-                    mTemplateInstantiations.erase(ti);
+                    eraseTemplateInstantiation(ti);
                 ++indentlevel;
             } else if (indentlevel > 0 && tok2->str() == ">")
                 --indentlevel;
@@ -1194,11 +1234,7 @@ void TemplateSimplifier::useDefaultArgumentValues(TokenAndName &declaration)
             continue;
 
         // don't strip args from uninstantiated templates
-        std::list<TokenAndName>::iterator ti2 = std::find_if(mTemplateInstantiations.begin(),
-                                                mTemplateInstantiations.end(),
-                                                FindName(declaration.name()));
-
-        if (ti2 == mTemplateInstantiations.end())
+        if (!hasTemplateInstantiation(declaration.name()))
             continue;
 
         eraseTokens(eqtok, tok2);
@@ -1314,7 +1350,7 @@ void TemplateSimplifier::simplifyTemplateAliases()
             found = true;
 
             // erase this instantiation
-            it2 = mTemplateInstantiations.erase(it2);
+            it2 = eraseTemplateInstantiation(it2);
         }
 
         if (found) {
@@ -1329,7 +1365,7 @@ void TemplateSimplifier::simplifyTemplateAliases()
             }
 
             // remove declaration
-            it1 = mTemplateDeclarations.erase(it1);
+            it1 = eraseTemplateDeclaration(it1);
         } else
             ++it1;
     }
@@ -2189,7 +2225,7 @@ void TemplateSimplifier::expandTemplate(
         // only add recursive instantiation if its arguments are a constant expression
         if (templateDeclaration.fullName() != fullName ||
             (inst.token->tokAt(2)->isNumber() || inst.token->tokAt(2)->isStandardType()))
-            mTemplateInstantiations.emplace_back(inst.token, inst.scope);
+            addTemplateInstantiation(TokenAndName(inst.token, inst.scope));
     }
 }
 
@@ -2936,33 +2972,17 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
 
     bool instantiated = false;
 
-    for (const TokenAndName &instantiation : mTemplateInstantiations) {
-        // skip deleted instantiations
-        if (!instantiation.token())
-            continue;
-        if (numberOfTemplateInstantiations != mTemplateInstantiations.size()) {
-            numberOfTemplateInstantiations = mTemplateInstantiations.size();
-            ++recursiveCount;
-            if (recursiveCount > mSettings->maxTemplateRecursion) {
-                std::list<std::string> typeStringsUsedInTemplateInstantiation;
-                const std::string typeForNewName = templateDeclaration.name() + "<" + getNewName(instantiation.token(), typeStringsUsedInTemplateInstantiation) + ">";
+    // only the instantiations with the same name can match the declaration
+    const auto byName = mTemplateInstantiationsByName.find(templateDeclaration.name());
+    const std::vector<std::list<TokenAndName>::iterator> * const instantiations =
+        (byName != mTemplateInstantiationsByName.end()) ? &byName->second : nullptr;
 
-                const std::list<const Token *> callstack(1, instantiation.token());
-                const ErrorMessage errmsg(callstack,
-                                          &mTokenizer->list,
-                                          Severity::information,
-                                          "templateRecursion",
-                                          "TemplateSimplifier: max template recursion ("
-                                          + MathLib::toString(mSettings->maxTemplateRecursion)
-                                          + ") reached for template '"+typeForNewName+"'. You might want to limit Cppcheck recursion.",
-                                          false);
-                if (mErrorLogger && mSettings->isEnabled(Settings::INFORMATION))
-                    mErrorLogger->reportErr(errmsg);
-
-                // bail out..
-                break;
-            }
-        }
+    for (std::size_t i = 0; instantiations && i < instantiations->size(); ++i) {
+        const std::list<TokenAndName>::iterator it = (*instantiations)[i];
+        // skip erased and deleted instantiations
+        if (it == mTemplateInstantiations.end() || !it->token())
+            continue;
+        const TokenAndName &instantiation = *it;
 
         // already simplified
         if (!Token::Match(instantiation.token(), "%name% <"))
@@ -3045,6 +3065,36 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
 
         // Replace all these template usages..
         replaceTemplateUsage(instantiation, typeStringsUsedInTemplateInstantiation, newName);
+
+        // instantiations were added or removed => the recursion is counted at the next instantiation in the list
+        if (numberOfTemplateInstantiations != mTemplateInstantiations.size()) {
+            std::list<TokenAndName>::const_iterator next = std::next(it);
+            while (next != mTemplateInstantiations.end() && !next->token())
+                ++next;
+            if (next == mTemplateInstantiations.end())
+                continue;
+            numberOfTemplateInstantiations = mTemplateInstantiations.size();
+            ++recursiveCount;
+            if (recursiveCount > mSettings->maxTemplateRecursion) {
+                std::list<std::string> typeStringsUsedInNextInstantiation;
+                const std::string typeForNextName = templateDeclaration.name() + "<" + getNewName(next->token(), typeStringsUsedInNextInstantiation) + ">";
+
+                const std::list<const Token *> callstack(1, next->token());
+                const ErrorMessage errmsg(callstack,
+                                          &mTokenizer->list,
+                                          Severity::information,
+                                          "templateRecursion",
+                                          "TemplateSimplifier: max template recursion ("
+                                          + MathLib::toString(mSettings->maxTemplateRecursion)
+                                          + ") reached for template '"+typeForNextName+"'. You might want to limit Cppcheck recursion.",
+                                          false);
+                if (mErrorLogger && mSettings->isEnabled(Settings::INFORMATION))
+                    mErrorLogger->reportErr(errmsg);
+
+                // bail out..
+                break;
+            }
+        }
     }
 
     // process uninstantiated templates
@@ -3209,7 +3259,7 @@ void TemplateSimplifier::replaceTemplateUsage(
                     std::list<TokenAndName>::iterator ti;
                     for (ti = mTemplateInstantiations.begin(); ti != mTemplateInstantiations.end();) {
                         if (ti->token() == tok) {
-                            mTemplateInstantiations.erase(ti++);
+                            eraseTemplateInstantiation(ti);
                             break;
                         } else {
                             ++ti;
@@ -3248,16 +3298,14 @@ void TemplateSimplifier::getSpecializations()
     for (auto & spec : mTemplateDeclarations) {
         if (spec.isSpecialization()) {
             bool found = false;
-            for (auto & decl : mTemplateDeclarations) {
-                if (!specMatch(spec, decl))
+            // the scopes and names match
+            for (const std::list<TokenAndName>::iterator &decl : mTemplateDeclarationsByFullName[spec.fullName()]) {
+                if (!specMatch(spec, *decl))
                     continue;
 
-                // make sure the scopes and names match
-                if (spec.fullName() == decl.fullName()) {
-                    // @todo make sure function parameters also match
-                    mTemplateSpecializationMap[spec.token()] = decl.token();
-                    found = true;
-                }
+                // @todo make sure function parameters also match
+                mTemplateSpecializationMap[spec.token()] = decl->token();
+                found = true;
             }
 
             if (!found) {
@@ -3282,16 +3330,14 @@ void TemplateSimplifier::getPartialSpecializations()
     for (auto & spec : mTemplateDeclarations) {
         if (spec.isPartialSpecialization()) {
             bool found = false;
-            for (auto & decl : mTemplateDeclarations) {
-                if (!specMatch(spec, decl))
+            // the scopes and names match
+            for (const std::list<TokenAndName>::iterator &decl : mTemplateDeclarationsByFullName[spec.fullName()]) {
+                if (!specMatch(spec, *decl))
                     continue;
 
-                // make sure the scopes and names match
-                if (spec.fullName() == decl.fullName()) {
-                    // @todo make sure function parameters also match
-                    mTemplatePartialSpecializationMap[spec.token()] = decl.token();
-                    found = true;
-                }
+                // @todo make sure function parameters also match
+                mTemplatePartialSpecializationMap[spec.token()] = decl->token();
+                found = true;
             }
 
             if (!found) {
@@ -3318,7 +3364,14 @@ void TemplateSimplifier::fixForwardDeclaredDefaultArgumentValues()
 
         getTemplateParametersInDeclaration(forwardDecl.token()->tokAt(2), params1);
 
-        for (auto & decl : mTemplateDeclarations) {
+        // the scopes and names must match
+        const auto byFullName = mTemplateDeclarationsByFullName.find(forwardDecl.fullName());
+        if (byFullName == mTemplateDeclarationsByFullName.end())
+            continue;
+
+        for (const std::list<TokenAndName>::iterator &it : byFullName->second) {
+            TokenAndName &decl = *it;
+
             // skip partializations, type aliases and friends
             if (decl.isPartialSpecialization() || decl.isAlias() || decl.isFriend())
                 continue;
@@ -3329,35 +3382,32 @@ void TemplateSimplifier::fixForwardDeclaredDefaultArgumentValues()
 
             // make sure the number of arguments match
             if (params1.size() == params2.size()) {
-                // make sure the scopes and names match
-                if (forwardDecl.fullName() == decl.fullName()) {
-                    // save forward declaration for lookup later
-                    if ((decl.nameToken()->strAt(1) == "(" && forwardDecl.nameToken()->strAt(1) == "(") ||
-                        (decl.nameToken()->strAt(1) == "{" && forwardDecl.nameToken()->strAt(1) == ";")) {
-                        mTemplateForwardDeclarationsMap[decl.token()] = forwardDecl.token();
-                    }
+                // save forward declaration for lookup later
+                if ((decl.nameToken()->strAt(1) == "(" && forwardDecl.nameToken()->strAt(1) == "(") ||
+                    (decl.nameToken()->strAt(1) == "{" && forwardDecl.nameToken()->strAt(1) == ";")) {
+                    mTemplateForwardDeclarationsMap[decl.token()] = forwardDecl.token();
+                }
 
-                    for (size_t k = 0; k < params1.size(); k++) {
-                        // copy default value to declaration if not present
-                        if (params1[k]->strAt(1) == "=" && params2[k]->strAt(1) != "=") {
-                            int level = 0;
-                            const Token *end = params1[k]->next();
-                            while (end && !(level == 0 && Token::Match(end, ",|>"))) {
-                                if (Token::Match(end, "{|(|<"))
-                                    level++;
-                                else if (Token::Match(end, "}|)|>"))
-                                    level--;
-                                end = end->next();
-                            }
-                            if (end)
-                                TokenList::copyTokens(const_cast<Token *>(params2[k]), params1[k]->next(), end->previous());
-                            break;
+                for (size_t k = 0; k < params1.size(); k++) {
+                    // copy default value to declaration if not present
+                    if (params1[k]->strAt(1) == "=" && params2[k]->strAt(1) != "=") {
+                        int level = 0;
+                        const Token *end = params1[k]->next();
+                        while (end && !(level == 0 && Token::Match(end, ",|>"))) {
+                            if (Token::Match(end, "{|(|<"))
+                                level++;
+                            else if (Token::Match(end, "}|)|>"))
+                                level--;
+                            end = end->next();
                         }
+                        if (end)
+                            TokenList::copyTokens(const_cast<Token *>(params2[k]), params1[k]->next(), end->previous());
+                        break;
                     }
-
-                    // update parameter end pointer
-                    decl.paramEnd(decl.token()->next()->findClosingBracket());
                 }
+
+                // update parameter end pointer
+                decl.paramEnd(decl.token()->next()->findClosingBracket());
             }
         }
     }
@@ -3586,11 +3636,13 @@ void TemplateSimplifier::simplifyTemplates(
 
             mChanged = usingChanged;
             mTemplateDeclarations.clear();
+            mTemplateDeclarationsByFullName.clear();
             mTemplateForwardDeclarations.clear();
             mTemplateForwardDeclarationsMap.clear();
             mTemplateSpecializationMap.clear();
             mTemplatePartialSpecializationMap.clear();
             mTemplateInstantiations.clear();
+            mTemplateInstantiationsByName.clear();
             mInstantiatedTemplates.clear();
             mExplicitInstantiationsToDelete.clear();
             mTemplateNamePos.clear();
@@ -3638,12 +3690,11 @@ void TemplateSimplifier::simplifyTemplates(
 
             // get specializations..
             std::list<const Token *> specializations;
-            for (std::list<TokenAndName>::const_iterator iter2 = mTemplateDeclarations.begin(); iter2 != mTemplateDeclarations.end(); ++iter2) {
+            for (const std::list<TokenAndName>::iterator &iter2 : mTemplateDeclarationsByFullName[iter1->fullName()]) {
                 if (iter2->isAlias() || iter2->isFriend())
                     continue;
 
-                if (iter1->fullName() == iter2->fullName())
-                    specializations.push_back(iter2->nameToken());
+                specializations.push_back(iter2->nameToken());
             }
 
             const bool instantiated = simplifyTemplateInstantiations(
@@ -3656,11 +3707,7 @@ void TemplateSimplifier::simplifyTemplates(
         }
 
         for (std::list<TokenAndName>::const_iterator it = mInstantiatedTemplates.begin(); it != mInstantiatedTemplates.end(); ++it) {
-            std::list<TokenAndName>::iterator decl;
-            for (decl = mTemplateDeclarations.begin(); decl != mTemplateDeclarations.end(); ++decl) {
-                if (decl->token() == it->token())
-                    break;
-            }
+            const std::list<TokenAndName>::iterator decl = findTemplateDeclaration(*it);
             if (decl != mTemplateDeclarations.end()) {
                 if (it->isSpecialization()) {
                     // delete the "template < >"
@@ -3674,19 +3721,17 @@ void TemplateSimplifier::simplifyTemplates(
                         removeTemplate(it1->second);
                     removeTemplate(it->token());
                 }
-                mTemplateDeclarations.erase(decl);
+                eraseTemplateDeclaration(decl);
             }
         }
 
         // remove out of line member functions
         while (!mMemberFunctionsToDelete.empty()) {
-            const std::list<TokenAndName>::iterator it = std::find_if(mTemplateDeclarations.begin(),
-                    mTemplateDeclarations.end(),
-                    FindToken(mMemberFunctionsToDelete.begin()->token()));
+            const std::list<TokenAndName>::iterator it = findTemplateDeclaration(mMemberFunctionsToDelete.front());
             // multiple functions can share the same declaration so make sure it hasn't already been deleted
             if (it != mTemplateDeclarations.end()) {
                 removeTemplate(it->token());
-                mTemplateDeclarations.erase(it);
+                eraseTemplateDeclaration(it);
             }
             mMemberFunctionsToDelete.erase(mMemberFunctionsToDelete.begin());
         }
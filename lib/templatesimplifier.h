@@ -349,6 +349,31 @@ private:
      */
     void addInstantiation(Token *token, const std::string &scope);
 
+    /** Add template declaration to mTemplateDeclarations and its index */
+    void addTemplateDeclaration(TokenAndName &&declaration);
+
+    /** Erase template declaration from mTemplateDeclarations and its index
+     * @return iterator of the next declaration
+     */
+    std::list<TokenAndName>::iterator eraseTemplateDeclaration(std::list<TokenAndName>::iterator it);
+
+    /** Find a template declaration in mTemplateDeclarations using its index
+     * @param declaration copy of the declaration
+     * @return iterator of the declaration with the same token or mTemplateDeclarations.end()
+     */
+    std::list<TokenAndName>::iterator findTemplateDeclaration(const TokenAndName &declaration);
+
+    /** Add template instantiation to mTemplateInstantiations and its index */
+    void addTemplateInstantiation(const TokenAndName &instantiation);
+
+    /** Erase template instantiation from mTemplateInstantiations and its index
+     * @return iterator of the next instantiation
+     */
+    std::list<TokenAndName>::iterator eraseTemplateInstantiation(std::list<TokenAndName>::iterator it);
+
+    /** Is there a template instantiation with the given name? Uses the index of mTemplateInstantiations */
+    bool hasTemplateInstantiation(const std::string &name) const;
+
     /**
      * Get template instantiations
      */
@@ -510,6 +535,10 @@ private:
     std::map<Token *, Token *> mTemplateSpecializationMap;
     std::map<Token *, Token *> mTemplatePartialSpecializationMap;
     std::list<TokenAndName> mTemplateInstantiations;
+    /** mTemplateDeclarations by full name, in the order of the list */
+    std::unordered_map<std::string, std::vector<std::list<TokenAndName>::iterator>> mTemplateDeclarationsByFullName;
+    /** mTemplateInstantiations by name, in the order of the list. Erased instantiations are end(). */
+    std::unordered_map<std::string, std::vector<std::list<TokenAndName>::iterator>> mTemplateInstantiationsByName;
     std::list<TokenAndName> mInstantiatedTemplates;
     std::list<TokenAndName> mMemberFunctionsToDelete;
     std::vector<TokenAndName> mExplicitInstantiationsToDelete;
@@ -25,7 +25,6 @@
 /*
     TODO:
     - rename "file" to "single"
-    - synchronise map access in multithreaded mode or disable timing
     - add unit tests
         - for --showtime (needs input file)
         - for Timer* classes
@@ -47,7 +46,9 @@ void TimerResults::showResults(SHOWTIME_MODES mode) const
     std::cout << std::endl;
     TimerResultsData overallData;
 
+    std::unique_lock<std::mutex> lock(mResultsSync);
     std::vector<dataElementType> data(mResults.begin(), mResults.end());
+    lock.unlock();
     std::sort(data.begin(), data.end(), more_second_sec);
 
     size_t ordinal = 1; // maybe it would be nice to have an ordinal in output later!
@@ -67,6 +68,7 @@ void TimerResults::showResults(SHOWTIME_MODES mode) const
 
 void TimerResults::addResults(const std::string& str, std::clock_t clocks)
 {
+    std::lock_guard<std::mutex> lock(mResultsSync);
     mResults[str].mClocks += clocks;
     mResults[str].mNumberOfResults++;
 }
@@ -1603,18 +1603,18 @@ void Token::printValueFlow(bool xml, std::ostream &out) const
 {
     int line = 0;
     if (xml)
-        out << "  <valueflow>" << std::endl;
+        out << "  <valueflow>\n";
     else
-        out << "\n\n##Value flow" << std::endl;
+        out << "\n\n##Value flow\n";
     for (const Token *tok = this; tok; tok = tok->next()) {
         if (!tok->mImpl->mValues)
             continue;
         if (tok->mImpl->mValues->empty()) // Values might be removed by removeContradictions
             continue;
         if (xml)
-            out << "    <values id=\"" << tok->mImpl->mValues << "\">" << std::endl;
+            out << "    <values id=\"" << tok->mImpl->mValues << "\">\n";
         else if (line != tok->linenr())
-            out << "Line " << tok->linenr() << std::endl;
+            out << "Line " << tok->linenr() << '\n';
         line = tok->linenr();
         if (!xml) {
             ValueFlow::Value::ValueKind valueKind = tok->mImpl->mValues->front().valueKind;
@@ -1689,7 +1689,7 @@ void Token::printValueFlow(bool xml, std::ostream &out) const
                     out << " impossible=\"true\"";
                 else if (value.isInconclusive())
                     out << " inconclusive=\"true\"";
-                out << "/>" << std::endl;
+                out << "/>\n";
             }
 
             else {
@@ -1742,14 +1742,14 @@ void Token::printValueFlow(bool xml, std::ostream &out) const
             }
         }
         if (xml)
-            out << "    </values>" << std::endl;
+            out << "    </values>\n";
         else if (tok->mImpl->mValues->size() > 1U)
-            out << '}' << std::endl;
+            out << "}\n";
         else
-            out << std::endl;
+            out << '\n';
     }
     if (xml)
-        out << "  </valueflow>" << std::endl;
+        out << "  </valueflow>\n";
 }
 
 const ValueFlow::Value * Token::getValueLE(const MathLib::bigint val, const Settings *settings) const
@@ -1967,30 +1967,52 @@ static void removeOverlaps(std::list<ValueFlow::Value>& values)
 }
 
 // Removing contradictions is an NP-hard problem. Instead we run multiple
-// passes to try to catch most contradictions
-static void removeContradictions(std::list<ValueFlow::Value>& values)
+// passes to try to catch most contradictions. Returns true if the values were changed.
+static bool removeContradictions(std::list<ValueFlow::Value>& values)
 {
+    bool changed = false;
     for (int i = 0; i < 4; i++) {
         if (!removeContradiction(values))
-            return;
+            break;
+        changed = true;
         removeOverlaps(values);
     }
+    return changed;
+}
+
+void Token::valuesChanged() const
+{
+    const Scope *scope = mImpl->mScope;
+    while (scope && scope->type != Scope::eFunction && scope->nestedIn)
+        scope = scope->nestedIn;
+    if (scope)
+        ++scope->valueChanges;
 }
 
 bool Token::addValue(const ValueFlow::Value &value)
 {
+    // Replacing a known value with the same value is not a change
+    std::size_t removed = 0;
+    bool sameKnownValue = false;
     if (value.isKnown() && mImpl->mValues) {
         // Clear all other values of the same type since value is known
         mImpl->mValues->remove_if([&](const ValueFlow::Value & x) {
-            return x.valueType == value.valueType;
+            if (x.valueType != value.valueType)
+                return false;
+            ++removed;
+            sameKnownValue = (removed == 1 && x.isKnown() && x == value && x.bound == value.bound && x.path == value.path);
+            return true;
         });
     }
 
     if (mImpl->mValues) {
         // Don't handle more than 10 values for performance reasons
         // TODO: add setting?
-        if (mImpl->mValues->size() >= 10U)
+        if (mImpl->mValues->size() >= 10U) {
+            if (removed > 0)
+                valuesChanged();
             return false;
+        }
 
         // if value already exists, don't add it again
         std::list<ValueFlow::Value>::iterator it;
@@ -2042,6 +2064,8 @@ bool Token::addValue(const ValueFlow::Value &value)
             }
 
             // Same value already exists, don't  add new value
+            if (removed > 0)
+                valuesChanged();
             return false;
         }
 
@@ -2062,7 +2086,8 @@ bool Token::addValue(const ValueFlow::Value &value)
         mImpl->mValues = new std::list<ValueFlow::Value>(1, v);
     }
 
-    removeContradictions(*mImpl->mValues);
+    if (removeContradictions(*mImpl->mValues) || !sameKnownValue)
+        valuesChanged();
 
     return true;
 }
@@ -2285,11 +2310,26 @@ const ValueFlow::Value* Token::getContainerSizeValue(const MathLib::bigint val)
     return it == mImpl->mValues->end() ? nullptr : &*it;
 }
 
+void Token::libraryFunctionName(const Library *library, const std::string &name) const
+{
+    // The remembered name is not replaced, another thread might use it
+    const TokenImpl::LibraryFunctionName *functionName = new TokenImpl::LibraryFunctionName{library, name};
+    const TokenImpl::LibraryFunctionName *old = nullptr;
+    if (!mImpl->mLibraryFunctionName.compare_exchange_strong(old, functionName, std::memory_order_acq_rel))
+        delete functionName;
+}
+
+void Token::clearLibraryFunctionName() const
+{
+    delete mImpl->mLibraryFunctionName.exchange(nullptr);
+}
+
 TokenImpl::~TokenImpl()
 {
     delete mOriginalName;
     delete mValueType;
     delete mValues;
+    delete mLibraryFunctionName.load();
 
     if (mTemplateSimplifierPointers)
         for (auto *templateSimplifierPointer : *mTemplateSimplifierPointers) {
@@ -27,6 +27,7 @@
 #include "templatesimplifier.h"
 #include "utils.h"
 
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <list>
@@ -37,6 +38,7 @@
 
 class Enumerator;
 class Function;
+class Library;
 class Scope;
 class Settings;
 class Type;
@@ -119,6 +121,15 @@ struct TokenImpl {
     // For memoization, to speed up parsing of huge arrays #8897
     enum class Cpp11init {UNKNOWN, CPP11INIT, NOINIT} mCpp11init;
 
+    // For memoization, the function name that the library looked up for this token using the AST.
+    // It is atomic because the ValueFlow threads can look up the same token. Once it is set it is
+    // not changed until the AST or symbol database is changed.
+    struct LibraryFunctionName {
+        const Library *library;
+        std::string name;
+    };
+    std::atomic<const LibraryFunctionName *> mLibraryFunctionName;
+
     /** Bitfield bit count. */
     unsigned char mBits;
 
@@ -145,6 +156,7 @@ struct TokenImpl {
         , mScopeInfo(nullptr)
         , mCppcheckAttributes(nullptr)
         , mCpp11init(Cpp11init::UNKNOWN)
+        , mLibraryFunctionName(nullptr)
         , mBits(0)
     {}
 
@@ -1105,6 +1117,24 @@ public:
             *mImpl->mOriginalName = name;
     }
 
+    /**
+     * @return the function name that the library has looked up for this
+     * token using the AST, nullptr if it has not been looked up by that library.
+     */
+    const std::string *libraryFunctionName(const Library *library) const {
+        const TokenImpl::LibraryFunctionName *functionName = mImpl->mLibraryFunctionName.load(std::memory_order_acquire);
+        return (functionName && functionName->library == library) ? &functionName->name : nullptr;
+    }
+
+    /**
+     * Remember the function name that the library has looked up for this token
+     * using the AST. Nothing is done if a name is already remembered.
+     */
+    void libraryFunctionName(const Library *library, const std::string &name) const;
+
+    /** Forget the looked up function name, the AST or symbol database is changed */
+    void clearLibraryFunctionName() const;
+
     bool hasKnownIntValue() const;
     bool hasKnownValue() const;
 
@@ -1136,8 +1166,12 @@ public:
     bool addValue(const ValueFlow::Value &value);
 
     void removeValues(std::function<bool(const ValueFlow::Value &)> pred) {
-        if (mImpl->mValues)
+        if (mImpl->mValues) {
+            const std::size_t size = mImpl->mValues->size();
             mImpl->mValues->remove_if(pred);
+            if (mImpl->mValues->size() != size)
+                valuesChanged();
+        }
     }
 
     nonneg int index() const {
@@ -1158,6 +1192,9 @@ private:
     /** used by deleteThis() to take data from token to delete */
     void takeData(Token *fromToken);
 
+    /** count a change of the values in the function scope of the token */
+    void valuesChanged() const;
+
     /**
      * Works almost like strcmp() except returns only true or false and
      * if str has empty space &apos; &apos; character, that character is handled
@@ -1318,6 +1355,7 @@ public:
 
     void clearAst() {
         mImpl->mAstOperand1 = mImpl->mAstOperand2 = mImpl->mAstParent = nullptr;
+        clearLibraryFunctionName();
     }
 
     void clearValueFlow() {
@@ -577,6 +577,19 @@ void Tokenizer::simplifyTypedef()
     // Convert "using a::b;" to corresponding typedef statements
     simplifyUsingToTypedef();
 
+    // Number of occurrences of each name, it is used to stop searching for the uses of a
+    // typedef when all occurrences of its name have been substituted. The names of the
+    // substituted types are added, removed tokens are not subtracted so the count is never
+    // too low.
+    std::unordered_map<std::string, int> nameCount;
+    const auto countNames = [&nameCount](const Token *start, const Token *end) {
+        for (const Token *tok = start; tok && tok != end; tok = tok->next()) {
+            if (tok->isName())
+                ++nameCount[tok->str()];
+        }
+    };
+    countNames(list.front(), nullptr);
+
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (mErrorLogger && !list.getFiles().empty())
             mErrorLogger->reportProgress(list.getFiles()[0], "Tokenize (typedef)", tok->progressValue());
@@ -1024,6 +1037,24 @@ void Tokenizer::simplifyTypedef()
             continue;
         }
 
+        // A function "operator X (...)" at the start of the code can't be a member function,
+        // the search below reported that when it found the function. Check it here since the
+        // search stops when all uses of the typedef are found.
+        if (isCPP() && Token::Match(list.front(), "operator %any% (")) {
+            const Token *end = list.front()->linkAt(2);
+            bool inside = false;
+            for (const Token *tok2 = list.front()->tokAt(3); tok2 && tok2 != end; tok2 = tok2->next()) {
+                if (tok2 == tok) {
+                    inside = true;
+                    break;
+                }
+            }
+            while (Token::simpleMatch(end, ") [") || Token::simpleMatch(end, "] ["))
+                end = end->next()->link();
+            if (inside && Token::Match(end, ")|] const| {"))
+                syntaxError(list.front());
+        }
+
         bool done = false;
         bool ok = true;
 
@@ -1036,7 +1067,14 @@ void Tokenizer::simplifyTypedef()
             bool globalScope = false;
             int classLevel = spaceInfo.size();
 
-            for (Token *tok2 = tok; tok2; tok2 = tok2->next()) {
+            // The typedef name itself is not a use. The search can't stop early if an enclosing
+            // namespace might be opened again, see below.
+            int usesLeft = nameCount[typeName->str()] - 1;
+            const bool namespaceReopened = std::any_of(spaceInfo.cbegin(), spaceInfo.cend(), [&nameCount](const Space &space) {
+                return space.isNamespace && nameCount[space.className] > 1;
+            });
+
+            for (Token *tok2 = tok; tok2 && (usesLeft > 0 || namespaceReopened); tok2 = tok2->next()) {
                 if (Settings::terminated())
                     return;
 
@@ -1082,8 +1120,8 @@ void Tokenizer::simplifyTypedef()
                         if (func->previous()->str() == "operator")
                             func = func->previous();
 
-                        if (!func->previous())
-                            syntaxError(func);
+                        if (!func->previous()) // Reported before the search
+                            continue;
 
                         // check for qualifier
                         if (func->previous()->str() == "::") {
@@ -1187,6 +1225,7 @@ void Tokenizer::simplifyTypedef()
                             for (int i = classLevel; i < spaceInfo.size(); ++i) {
                                 tok2->deleteNext(2);
                             }
+                            --usesLeft;
                             simplifyType = true;
                         }
                     } else {
@@ -1234,6 +1273,9 @@ void Tokenizer::simplifyTypedef()
                         continue;
                     }
 
+                    // the type is inserted after this token
+                    const Token * const substitutionStart = tok2->previous();
+
                     // There are 2 categories of typedef substitutions:
                     // 1. variable declarations that preserve the variable name like
                     //    global, local, and function parameters
@@ -1290,6 +1332,8 @@ void Tokenizer::simplifyTypedef()
                         typeEnd = typeStart;
 
                     // start substituting at the typedef name by replacing it with the type
+                    if (tok2->str() == typeName->str() && typeStart->str() != typeName->str())
+                        --usesLeft;
                     tok2->str(typeStart->str());
 
                     // restore qualification if it was removed
@@ -1329,8 +1373,10 @@ void Tokenizer::simplifyTypedef()
                         if (!inCast)
                             tok2 = processFunc(tok2, inOperator);
 
-                        if (!tok2)
+                        if (!tok2) {
+                            countNames(substitutionStart->next(), nullptr);
                             break;
+                        }
 
                         while (Token::Match(tok2, "%name%|] ["))
                             tok2 = tok2->linkAt(1);
@@ -1602,6 +1648,7 @@ void Tokenizer::simplifyTypedef()
                         } while (Token::Match(tok2, ", %name% ;|=|,"));
                     }
 
+                    countNames(substitutionStart->next(), tok2 ? tok2->next() : nullptr);
                     simplifyType = false;
                 }
                 if (!tok2)
@@ -3009,7 +3056,7 @@ void Tokenizer::simplifyTemplates()
 //---------------------------------------------------------------------------
 
 
-static bool setVarIdParseDeclaration(const Token **tok, const std::map<std::string,int> &variableId, bool executableScope, bool cpp, bool c)
+static bool setVarIdParseDeclaration(const Token **tok, const std::unordered_map<std::string, int> &variableId, bool executableScope, bool cpp, bool c)
 {
     const Token *tok2 = *tok;
     if (!tok2->isName())
@@ -3136,7 +3183,7 @@ static bool setVarIdParseDeclaration(const Token **tok, const std::map<std::stri
 
 
 void Tokenizer::setVarIdStructMembers(Token **tok1,
-                                      std::map<int, std::map<std::string, int> >& structMembers,
+                                      std::unordered_map<int, std::unordered_map<std::string, int>>& structMembers,
                                       nonneg int *varId)
 {
     Token *tok = *tok1;
@@ -3146,7 +3193,7 @@ void Tokenizer::setVarIdStructMembers(Token **tok1,
         if (struct_varid == 0)
             return;
 
-        std::map<std::string, int>& members = structMembers[struct_varid];
+        std::unordered_map<std::string, int>& members = structMembers[struct_varid];
 
         tok = tok->tokAt(3);
         while (tok->str() != "}") {
@@ -3154,7 +3201,7 @@ void Tokenizer::setVarIdStructMembers(Token **tok1,
                 tok = tok->link();
             if (Token::Match(tok->previous(), "[,{] . %name% =|{")) {
                 tok = tok->next();
-                const std::map<std::string, int>::iterator it = members.find(tok->str());
+                const std::unordered_map<std::string, int>::iterator it = members.find(tok->str());
                 if (it == members.end()) {
                     members[tok->str()] = ++(*varId);
                     tok->varId(*varId);
@@ -3187,8 +3234,8 @@ void Tokenizer::setVarIdStructMembers(Token **tok1,
         if (TemplateSimplifier::templateParameters(tok->next()) > 0)
             break;
 
-        std::map<std::string, int>& members = structMembers[struct_varid];
-        const std::map<std::string, int>::iterator it = members.find(tok->str());
+        std::unordered_map<std::string, int>& members = structMembers[struct_varid];
+        const std::unordered_map<std::string, int>::iterator it = members.find(tok->str());
         if (it == members.end()) {
             members[tok->str()] = ++(*varId);
             tok->varId(*varId);
@@ -3204,7 +3251,7 @@ void Tokenizer::setVarIdStructMembers(Token **tok1,
 void Tokenizer::setVarIdClassDeclaration(const Token * const startToken,
         const VariableMap &variableMap,
         const nonneg int scopeStartVarId,
-        std::map<int, std::map<std::string,int> >& structMembers)
+        std::unordered_map<int, std::unordered_map<std::string, int>>& structMembers)
 {
     // end of scope
     const Token * const endToken = startToken->link();
@@ -3245,7 +3292,7 @@ void Tokenizer::setVarIdClassDeclaration(const Token * const startToken,
             --indentlevel;
             inEnum = false;
         } else if (initList && indentlevel == 0 && Token::Match(tok->previous(), "[,:] %name% [({]")) {
-            const std::map<std::string, int>::const_iterator it = variableMap.find(tok->str());
+            const std::unordered_map<std::string, int>::const_iterator it = variableMap.find(tok->str());
             if (it != variableMap.end()) {
                 tok->varId(it->second);
             }
@@ -3263,7 +3310,7 @@ void Tokenizer::setVarIdClassDeclaration(const Token * const startToken,
                 }
 
                 if (!inEnum) {
-                    const std::map<std::string, int>::const_iterator it = variableMap.find(tok->str());
+                    const std::unordered_map<std::string, int>::const_iterator it = variableMap.find(tok->str());
                     if (it != variableMap.end()) {
                         tok->varId(it->second);
                         setVarIdStructMembers(&tok, structMembers, variableMap.getVarId());
@@ -3282,8 +3329,8 @@ void Tokenizer::setVarIdClassDeclaration(const Token * const startToken,
 void Tokenizer::setVarIdClassFunction(const std::string &classname,
                                       Token * const startToken,
                                       const Token * const endToken,
-                                      const std::map<std::string, int> &varlist,
-                                      std::map<int, std::map<std::string, int> >& structMembers,
+                                      const std::unordered_map<std::string, int> &varlist,
+                                      std::unordered_map<int, std::unordered_map<std::string, int>>& structMembers,
                                       nonneg int *varId_)
 {
     for (Token *tok2 = startToken; tok2 && tok2 != endToken; tok2 = tok2->next()) {
@@ -3296,7 +3343,7 @@ void Tokenizer::setVarIdClassFunction(const std::string &classname,
         if (Token::Match(tok2->tokAt(-2), "!!this .") && !Token::simpleMatch(tok2->tokAt(-5), "( * this ) ."))
             continue;
 
-        const std::map<std::string,int>::const_iterator it = varlist.find(tok2->str());
+        const std::unordered_map<std::string, int>::const_iterator it = varlist.find(tok2->str());
         if (it != varlist.end()) {
             tok2->varId(it->second);
             setVarIdStructMembers(&tok2, structMembers, varId_);
@@ -3335,7 +3382,7 @@ void Tokenizer::setVarIdPass1()
     const std::set<std::string>& notstart = (isC()) ? notstart_c : notstart_cpp;
 
     VariableMap variableMap;
-    std::map<int, std::map<std::string, int> > structMembers;
+    std::unordered_map<int, std::unordered_map<std::string, int>> structMembers;
 
     std::stack<VarIdScopeInfo> scopeStack;
 
@@ -3546,7 +3593,7 @@ void Tokenizer::setVarIdPass1()
                         const Token *end = tok->findClosingBracket();
                         while (tok != end) {
                             if (tok->isName()) {
-                                const std::map<std::string, int>::const_iterator it = variableMap.find(tok->str());
+                                const std::unordered_map<std::string, int>::const_iterator it = variableMap.find(tok->str());
                                 if (it != variableMap.end())
                                     tok->varId(it->second);
                             }
@@ -3606,7 +3653,7 @@ void Tokenizer::setVarIdPass1()
             }
 
             if (!scopeStack.top().isEnum) {
-                const std::map<std::string, int>::const_iterator it = variableMap.find(tok->str());
+                const std::unordered_map<std::string, int>::const_iterator it = variableMap.find(tok->str());
                 if (it != variableMap.end()) {
                     tok->varId(it->second);
                     setVarIdStructMembers(&tok, structMembers, variableMap.getVarId());
@@ -3711,6 +3758,30 @@ static Token * matchMemberName(const Member &member, const std::list<ScopeInfo2>
     return nullptr;
 }
 
+// Add the member to the lists of members that can match a scope with these names
+static void indexMember(std::unordered_map<std::string, std::vector<std::size_t>> &membersByName, std::size_t index, const Member &member)
+{
+    const auto add = [&](const std::string &name) {
+        std::vector<std::size_t> &members = membersByName[name];
+        if (members.empty() || members.back() != index)
+            members.push_back(index);
+    };
+    for (const std::string &name : member.scope)
+        add(name);
+    for (const Token *ns : member.usingnamespaces) {
+        for (; Token::Match(ns, "%name% ::|;"); ns = ns->tokAt(2))
+            add(ns->str());
+    }
+    for (const Token *tok = member.tok; Token::Match(tok, "%name% ::|<"); tok = tok->tokAt(2)) {
+        add(tok->str());
+        if (tok->next()->str() == "<") {
+            tok = tok->next()->findClosingBracket();
+            if (!Token::simpleMatch(tok, "> ::"))
+                break;
+        }
+    }
+}
+
 static Token * matchMemberVarName(const Member &var, const std::list<ScopeInfo2> &scopeInfo)
 {
     Token *tok = matchMemberName(var, scopeInfo);
@@ -3725,11 +3796,11 @@ static Token * matchMemberFunctionName(const Member &func, const std::list<Scope
 
 void Tokenizer::setVarIdPass2()
 {
-    std::map<int, std::map<std::string, int> > structMembers;
+    std::unordered_map<int, std::unordered_map<std::string, int>> structMembers;
 
     // Member functions and variables in this source
-    std::list<Member> allMemberFunctions;
-    std::list<Member> allMemberVars;
+    std::vector<Member> allMemberFunctions;
+    std::vector<Member> allMemberVars;
     if (!isC()) {
         std::map<const Token *, std::string> endOfScope;
         std::list<std::string> scope;
@@ -3784,10 +3855,20 @@ void Tokenizer::setVarIdPass2()
         }
     }
 
+    // Members indexed by the scope names they can be matched with
+    std::unordered_map<std::string, std::vector<std::size_t>> memberFunctionsByName;
+    std::unordered_map<std::string, std::vector<std::size_t>> memberVarsByName;
+    for (std::size_t i = 0; i < allMemberFunctions.size(); ++i)
+        indexMember(memberFunctionsByName, i, allMemberFunctions[i]);
+    for (std::size_t i = 0; i < allMemberVars.size(); ++i)
+        indexMember(memberVarsByName, i, allMemberVars[i]);
+
+    static const std::vector<std::size_t> noMembers;
+
     std::list<ScopeInfo2> scopeInfo;
 
     // class members..
-    std::map<std::string, std::map<std::string, int> > varsByClass;
+    std::unordered_map<std::string, std::unordered_map<std::string, int>> varsByClass;
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         while (tok->str() == "}" && !scopeInfo.empty() && tok == scopeInfo.back().bodyEnd)
             scopeInfo.pop_back();
@@ -3810,7 +3891,7 @@ void Tokenizer::setVarIdPass2()
         for (const Token *it : classnameTokens)
             classname += (classname.empty() ? "" : " :: ") + it->str();
 
-        std::map<std::string, int> &thisClassVars = varsByClass[scopeName2 + classname];
+        std::unordered_map<std::string, int> &thisClassVars = varsByClass[scopeName2 + classname];
         while (Token::Match(tokStart, ":|::|,|%name%")) {
             if (Token::Match(tokStart, "%name% <")) {
                 tokStart = tokStart->next()->findClosingBracket();
@@ -3819,7 +3900,7 @@ void Tokenizer::setVarIdPass2()
                 continue;
             }
             if (Token::Match(tokStart, "%name% ,|{")) {
-                const std::map<std::string, int>& baseClassVars = varsByClass[tokStart->str()];
+                const std::unordered_map<std::string, int>& baseClassVars = varsByClass[tokStart->str()];
                 thisClassVars.insert(baseClassVars.begin(), baseClassVars.end());
             }
             tokStart = tokStart->next();
@@ -3857,8 +3938,9 @@ void Tokenizer::setVarIdPass2()
             continue;
 
         // Member variables
-        for (const Member &var : allMemberVars) {
-            Token *tok2 = matchMemberVarName(var, scopeInfo);
+        const std::unordered_map<std::string, std::vector<std::size_t>>::const_iterator vars = memberVarsByName.find(scopeInfo.back().name);
+        for (std::size_t i : (vars != memberVarsByName.end()) ? vars->second : noMembers) {
+            Token *tok2 = matchMemberVarName(allMemberVars[i], scopeInfo);
             if (!tok2)
                 continue;
             tok2->varId(thisClassVars[tok2->str()]);
@@ -3868,8 +3950,9 @@ void Tokenizer::setVarIdPass2()
             continue;
 
         // Set variable ids in member functions for this class..
-        for (const Member &func : allMemberFunctions) {
-            Token *tok2 = matchMemberFunctionName(func, scopeInfo);
+        const std::unordered_map<std::string, std::vector<std::size_t>>::const_iterator funcs = memberFunctionsByName.find(scopeInfo.back().name);
+        for (std::size_t i : (funcs != memberFunctionsByName.end()) ? funcs->second : noMembers) {
+            Token *tok2 = matchMemberFunctionName(allMemberFunctions[i], scopeInfo);
             if (!tok2)
                 continue;
 
@@ -3902,7 +3985,7 @@ void Tokenizer::setVarIdPass2()
                     break;
 
                 // set varid
-                const std::map<std::string, int>::const_iterator varpos = thisClassVars.find(tok3->str());
+                const std::unordered_map<std::string, int>::const_iterator varpos = thisClassVars.find(tok3->str());
                 if (varpos != thisClassVars.end())
                     tok3->varId(varpos->second);
 
@@ -4939,10 +5022,15 @@ void Tokenizer::dump(std::ostream &out) const
     // The idea is not that this will be readable for humans. It's a
     // data dump that 3rd party tools could load and get useful info from.
 
+    // the file names are escaped once, not for each token
+    std::vector<std::string> fileNames;
+    for (const std::string &fileName : list.getFiles())
+        fileNames.push_back(ErrorLogger::toxml(fileName));
+
     // tokens..
-    out << "  <tokenlist>" << std::endl;
+    out << "  <tokenlist>\n";
     for (const Token *tok = list.front(); tok; tok = tok->next()) {
-        out << "    <token id=\"" << tok << "\" file=\"" << ErrorLogger::toxml(list.file(tok)) << "\" linenr=\"" << tok->linenr() << "\" column=\"" << tok->column() << "\"";
+        out << "    <token id=\"" << tok << "\" file=\"" << fileNames.at(tok->fileIndex()) << "\" linenr=\"" << tok->linenr() << "\" column=\"" << tok->column() << "\"";
         out << " str=\"" << ErrorLogger::toxml(tok->str()) << '\"';
         out << " scope=\"" << tok->scope() << '\"';
         if (tok->isName()) {
@@ -5005,9 +5093,9 @@ void Tokenizer::dump(std::ostream &out) const
             if (!vt.empty())
                 out << ' ' << vt;
         }
-        out << "/>" << std::endl;
+        out << "/>\n";
     }
-    out << "  </tokenlist>" << std::endl;
+    out << "  </tokenlist>\n";
 
     mSymbolDatabase->printXml(out);
     if (list.front())
@@ -11872,7 +11960,7 @@ Tokenizer::VariableMap::VariableMap() : mVarId(0) {}
 
 void Tokenizer::VariableMap::enterScope()
 {
-    mScopeInfo.push(std::list<std::pair<std::string, int>>());
+    mScopeInfo.push(std::vector<std::pair<std::string, int>>());
 }
 
 bool Tokenizer::VariableMap::leaveScope()
@@ -11896,7 +11984,7 @@ void Tokenizer::VariableMap::addVariable(const std::string &varname)
         mVariableId[varname] = ++mVarId;
         return;
     }
-    std::map<std::string, int>::iterator it = mVariableId.find(varname);
+    std::unordered_map<std::string, int>::iterator it = mVariableId.find(varname);
     if (it == mVariableId.end()) {
         mScopeInfo.top().push_back(std::pair<std::string, int>(varname, 0));
         mVariableId[varname] = ++mVarId;
@@ -30,6 +30,8 @@
 #include <map>
 #include <string>
 #include <stack>
+#include <unordered_map>
+#include <vector>
 
 class Settings;
 class SymbolDatabase;
@@ -60,8 +62,8 @@ class CPPCHECKLIB Tokenizer {
     /** Class used in Tokenizer::setVarIdPass1 */
     class VariableMap {
     private:
-        std::map<std::string, int> mVariableId;
-        std::stack<std::list<std::pair<std::string,int> > > mScopeInfo;
+        std::unordered_map<std::string, int> mVariableId;
+        std::stack<std::vector<std::pair<std::string, int>>> mScopeInfo;
         mutable nonneg int mVarId;
     public:
         VariableMap();
@@ -69,13 +71,13 @@ class CPPCHECKLIB Tokenizer {
         bool leaveScope();
         void addVariable(const std::string &varname);
         bool hasVariable(const std::string &varname) const;
-        std::map<std::string,int>::const_iterator find(const std::string &varname) const {
+        std::unordered_map<std::string, int>::const_iterator find(const std::string &varname) const {
             return mVariableId.find(varname);
         }
-        std::map<std::string,int>::const_iterator end() const {
+        std::unordered_map<std::string, int>::const_iterator end() const {
             return mVariableId.end();
         }
-        const std::map<std::string,int> &map() const {
+        const std::unordered_map<std::string, int> &map() const {
             return mVariableId;
         }
         nonneg int *getVarId() const {
@@ -790,17 +792,17 @@ private:
     void setVarIdClassDeclaration(const Token * const startToken,
                                   const VariableMap &variableMap,
                                   const nonneg int scopeStartVarId,
-                                  std::map<int, std::map<std::string,int> >& structMembers);
+                                  std::unordered_map<int, std::unordered_map<std::string, int>>& structMembers);
 
     void setVarIdStructMembers(Token **tok1,
-                               std::map<int, std::map<std::string, int> >& structMembers,
+                               std::unordered_map<int, std::unordered_map<std::string, int>>& structMembers,
                                nonneg int *varId);
 
     void setVarIdClassFunction(const std::string &classname,
                                Token * const startToken,
                                const Token * const endToken,
-                               const std::map<std::string,int> &varlist,
-                               std::map<int, std::map<std::string,int> >& structMembers,
+                               const std::unordered_map<std::string, int> &varlist,
+                               std::unordered_map<int, std::unordered_map<std::string, int>>& structMembers,
                                nonneg int *varId_);
 
     /**
@@ -25,6 +25,7 @@
 #include "settings.h"
 #include "standards.h"
 #include "token.h"
+#include "utils.h"
 
 #include <simplecpp.h>
 #include <cctype>
@@ -455,6 +456,20 @@ unsigned long long TokenList::calculateChecksum() const
     return checksum;
 }
 
+unsigned long long TokenList::calculateHash() const
+{
+    Hash64 hash;
+    for (const Token* tok = front(); tok; tok = tok->next()) {
+        hash.update(tok->str());
+        hash.update(tok->str().size());
+        hash.update(tok->flags());
+        hash.update(tok->fileIndex());
+        hash.update(tok->linenr());
+        hash.update(tok->column());
+    }
+    return hash.digest();
+}
+
 
 //---------------------------------------------------------------------------
 
@@ -153,6 +153,14 @@ public:
     */
     unsigned long long calculateChecksum() const;
 
+    /**
+    * Calculates a 64-bit hash of the token list that also covers the
+    * locations of the tokens. Unless the hashes of different token lists
+    * collide, token lists with the same hash are simplified into the same
+    * tokens.
+    */
+    unsigned long long calculateHash() const;
+
     /**
      * Create abstract syntax tree.
      */
@@ -18,6 +18,8 @@
 
 #include "utils.h"
 
+#include <algorithm>
+#include <cstring>
 #include <utility>
 #include <stack>
 
@@ -111,3 +113,121 @@ bool matchglob(const std::string& pattern, const std::string& name)
         n++;
     }
 }
+
+static const unsigned long long PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static const unsigned long long PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const unsigned long long PRIME64_3 = 0x165667B19E3779F9ULL;
+static const unsigned long long PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static const unsigned long long PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static unsigned long long rotl64(unsigned long long x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static unsigned long long read64(const unsigned char *p)
+{
+    unsigned long long ret = 0;
+    for (int i = 7; i >= 0; --i)
+        ret = (ret << 8) | p[i];
+    return ret;
+}
+
+static unsigned long long read32(const unsigned char *p)
+{
+    return (static_cast<unsigned long long>(p[3]) << 24) | (static_cast<unsigned long long>(p[2]) << 16) | (static_cast<unsigned long long>(p[1]) << 8) | p[0];
+}
+
+static unsigned long long hash64Round(unsigned long long acc, unsigned long long input)
+{
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static unsigned long long hash64MergeRound(unsigned long long acc, unsigned long long val)
+{
+    acc ^= hash64Round(0, val);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+Hash64::Hash64(unsigned long long seed)
+    : mSeed(seed)
+    , mTotalSize(0)
+    , mBufferSize(0)
+{
+    mState[0] = seed + PRIME64_1 + PRIME64_2;
+    mState[1] = seed + PRIME64_2;
+    mState[2] = seed;
+    mState[3] = seed - PRIME64_1;
+}
+
+void Hash64::update(const void *data, std::size_t size)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    mTotalSize += size;
+
+    // fill up the buffer first
+    if (mBufferSize > 0) {
+        const std::size_t n = std::min(size, sizeof(mBuffer) - mBufferSize);
+        std::memcpy(mBuffer + mBufferSize, p, n);
+        mBufferSize += n;
+        p += n;
+        size -= n;
+        if (mBufferSize < sizeof(mBuffer))
+            return;
+        for (int i = 0; i < 4; ++i)
+            mState[i] = hash64Round(mState[i], read64(mBuffer + 8 * i));
+        mBufferSize = 0;
+    }
+
+    // hash whole stripes directly from the data
+    for (; size >= 32; p += 32, size -= 32) {
+        mState[0] = hash64Round(mState[0], read64(p));
+        mState[1] = hash64Round(mState[1], read64(p + 8));
+        mState[2] = hash64Round(mState[2], read64(p + 16));
+        mState[3] = hash64Round(mState[3], read64(p + 24));
+    }
+
+    std::memcpy(mBuffer, p, size);
+    mBufferSize = size;
+}
+
+void Hash64::update(unsigned long long value)
+{
+    unsigned char data[8];
+    for (int i = 0; i < 8; ++i)
+        data[i] = static_cast<unsigned char>(value >> (8 * i));
+    update(data, sizeof(data));
+}
+
+unsigned long long Hash64::digest() const
+{
+    unsigned long long h;
+    if (mTotalSize >= 32) {
+        h = rotl64(mState[0], 1) + rotl64(mState[1], 7) + rotl64(mState[2], 12) + rotl64(mState[3], 18);
+        for (int i = 0; i < 4; ++i)
+            h = hash64MergeRound(h, mState[i]);
+    } else {
+        h = mSeed + PRIME64_5;
+    }
+    h += mTotalSize;
+
+    const unsigned char *p = mBuffer;
+    const unsigned char * const end = mBuffer + mBufferSize;
+    for (; p + 8 <= end; p += 8)
+        h = rotl64(h ^ hash64Round(0, read64(p)), 27) * PRIME64_1 + PRIME64_4;
+    if (p + 4 <= end) {
+        h = rotl64(h ^ (read32(p) * PRIME64_1), 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; ++p)
+        h = rotl64(h ^ (*p * PRIME64_5), 11) * PRIME64_1;
+
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
@@ -104,6 +104,33 @@ CPPCHECKLIB bool isValidGlobPattern(const std::string& pattern);
 
 CPPCHECKLIB bool matchglob(const std::string& pattern, const std::string& name);
 
+/**
+ * @brief 64 bit hash (xxHash64) of data that is added in pieces.
+ *
+ * The result is the same as if all data was hashed at once, so no
+ * temporary string is needed to hash many small strings.
+ */
+class CPPCHECKLIB Hash64 {
+public:
+    explicit Hash64(unsigned long long seed = 0);
+
+    void update(const void *data, std::size_t size);
+    void update(const std::string &data) {
+        update(data.data(), data.size());
+    }
+    void update(unsigned long long value);
+
+    /** Hash of the data added so far */
+    unsigned long long digest() const;
+
+private:
+    unsigned long long mSeed;
+    unsigned long long mState[4];
+    unsigned long long mTotalSize;
+    unsigned char mBuffer[32];
+    std::size_t mBufferSize;
+};
+
 #define UNUSED(x) (void)(x)
 
 // Use the nonneg macro when you want to assert that a variable/argument is not negative
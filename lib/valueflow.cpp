@@ -94,15 +94,19 @@
 #include "valueptr.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstring>
+#include <exception>
 #include <functional>
 #include <iterator>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <set>
 #include <stack>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -1379,17 +1383,19 @@ static void valueFlowSameExpressions(TokenList *tokenlist)
         if (!val.isKnown())
             continue;
 
-        if (isSameExpression(tokenlist->isCPP(), false, tok->astOperand1(), tok->astOperand2(), tokenlist->getSettings()->library, true, true, &val.errorPath)) {
+        ErrorPath errorPath;
+        if (isSameExpression(tokenlist->isCPP(), false, tok->astOperand1(), tok->astOperand2(), tokenlist->getSettings()->library, true, true, &errorPath)) {
+            val.errorPath = errorPath;
             setTokenValue(tok, val, tokenlist->getSettings());
         }
     }
 }
 
-static void valueFlowTerminatingCondition(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger, const Settings *settings)
+static void valueFlowTerminatingCondition(TokenList *tokenlist, SymbolDatabase* symboldatabase, const std::vector<const Scope *> &functionScopes, ErrorLogger *errorLogger, const Settings *settings)
 {
     const bool cpp = symboldatabase->isCPP();
     typedef std::pair<const Token*, const Scope*> Condition;
-    for (const Scope * scope : symboldatabase->functionScopes) {
+    for (const Scope * scope : functionScopes) {
         bool skipFunction = false;
         std::vector<Condition> conds;
         for (const Token* tok = scope->bodyStart; tok != scope->bodyEnd; tok = tok->next()) {
@@ -2013,9 +2019,9 @@ static bool isConditionKnown(const Token* tok, bool then)
     return (parent && parent->str() == "(");
 }
 
-static void valueFlowBeforeCondition(TokenList *tokenlist, SymbolDatabase *symboldatabase, ErrorLogger *errorLogger, const Settings *settings)
+static void valueFlowBeforeCondition(TokenList *tokenlist, const std::vector<const Scope *> &functionScopes, ErrorLogger *errorLogger, const Settings *settings)
 {
-    for (const Scope * scope : symboldatabase->functionScopes) {
+    for (const Scope * scope : functionScopes) {
         for (Token* tok = const_cast<Token*>(scope->bodyStart); tok != scope->bodyEnd; tok = tok->next()) {
             MathLib::bigint num = 0;
             const Token *vartok = nullptr;
@@ -4069,11 +4075,11 @@ static const Token * findEndOfFunctionCallForParameter(const Token * parameterTo
     return nextAfterAstRightmostLeaf(parent);
 }
 
-static void valueFlowAfterMove(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger, const Settings *settings)
+static void valueFlowAfterMove(TokenList *tokenlist, const std::vector<const Scope *> &functionScopes, ErrorLogger *errorLogger, const Settings *settings)
 {
     if (!tokenlist->isCPP() || settings->standards.cpp < Standards::CPP11)
         return;
-    for (const Scope * scope : symboldatabase->functionScopes) {
+    for (const Scope * scope : functionScopes) {
         if (!scope)
             continue;
         const Token * start = scope->bodyStart;
@@ -4268,9 +4274,9 @@ static bool isVariableInit(const Token *tok)
            !Token::simpleMatch(tok->astOperand2(), ",");
 }
 
-static void valueFlowAfterAssign(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger, const Settings *settings)
+static void valueFlowAfterAssign(TokenList *tokenlist, const std::vector<const Scope *> &functionScopes, ErrorLogger *errorLogger, const Settings *settings)
 {
-    for (const Scope * scope : symboldatabase->functionScopes) {
+    for (const Scope * scope : functionScopes) {
         std::set<int> aliased;
         for (Token* tok = const_cast<Token*>(scope->bodyStart); tok != scope->bodyEnd; tok = tok->next()) {
             // Alias
@@ -4396,9 +4402,10 @@ struct ValueFlowConditionHandler {
 
     void afterCondition(TokenList *tokenlist,
                         SymbolDatabase *symboldatabase,
+                        const std::vector<const Scope *> &functionScopes,
                         ErrorLogger *errorLogger,
                         const Settings *settings) const {
-        for (const Scope *scope : symboldatabase->functionScopes) {
+        for (const Scope *scope : functionScopes) {
             std::set<unsigned> aliased;
             for (Token *tok = const_cast<Token *>(scope->bodyStart); tok != scope->bodyEnd; tok = tok->next()) {
                 if (Token::Match(tok, "if|while|for ("))
@@ -4648,6 +4655,7 @@ struct ValueFlowConditionHandler {
 
 static void valueFlowAfterCondition(TokenList *tokenlist,
                                     SymbolDatabase *symboldatabase,
+                                    const std::vector<const Scope *> &functionScopes,
                                     ErrorLogger *errorLogger,
                                     const Settings *settings)
 {
@@ -4689,7 +4697,7 @@ static void valueFlowAfterCondition(TokenList *tokenlist,
 
         return cond;
     };
-    handler.afterCondition(tokenlist, symboldatabase, errorLogger, settings);
+    handler.afterCondition(tokenlist, symboldatabase, functionScopes, errorLogger, settings);
 }
 
 static bool isInBounds(const ValueFlow::Value& value, MathLib::bigint x)
@@ -6155,6 +6163,7 @@ static std::list<ValueFlow::Value> getIteratorValues(std::list<ValueFlow::Value>
 
 static void valueFlowIteratorAfterCondition(TokenList *tokenlist,
         SymbolDatabase *symboldatabase,
+        const std::vector<const Scope *> &functionScopes,
         ErrorLogger *errorLogger,
         const Settings *settings)
 {
@@ -6192,7 +6201,7 @@ static void valueFlowIteratorAfterCondition(TokenList *tokenlist,
 
         return cond;
     };
-    handler.afterCondition(tokenlist, symboldatabase, errorLogger, settings);
+    handler.afterCondition(tokenlist, symboldatabase, functionScopes, errorLogger, settings);
 }
 
 static void valueFlowIteratorInfer(TokenList *tokenlist, const Settings *settings)
@@ -6223,7 +6232,7 @@ static void valueFlowIteratorInfer(TokenList *tokenlist, const Settings *setting
     }
 }
 
-static void valueFlowContainerSize(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger * /*errorLogger*/, const Settings *settings)
+static void valueFlowContainerSize(TokenList *tokenlist, SymbolDatabase* symboldatabase, const std::vector<const Scope *> &functionScopes, ErrorLogger * /*errorLogger*/, const Settings *settings)
 {
     // declaration
     for (const Variable *var : symboldatabase->variableList()) {
@@ -6250,7 +6259,7 @@ static void valueFlowContainerSize(TokenList *tokenlist, SymbolDatabase* symbold
     }
 
     // after assignment
-    for (const Scope *functionScope : symboldatabase->functionScopes) {
+    for (const Scope *functionScope : functionScopes) {
         for (const Token *tok = functionScope->bodyStart; tok != functionScope->bodyEnd; tok = tok->next()) {
             if (Token::Match(tok, "%name%|;|{|} %var% = %str% ;")) {
                 const Token *containerTok = tok->next();
@@ -6324,6 +6333,7 @@ static void valueFlowContainerSize(TokenList *tokenlist, SymbolDatabase* symbold
 
 static void valueFlowContainerAfterCondition(TokenList *tokenlist,
         SymbolDatabase *symboldatabase,
+        const std::vector<const Scope *> &functionScopes,
         ErrorLogger *errorLogger,
         const Settings *settings)
 {
@@ -6398,7 +6408,7 @@ static void valueFlowContainerAfterCondition(TokenList *tokenlist,
         }
         return cond;
     };
-    handler.afterCondition(tokenlist, symboldatabase, errorLogger, settings);
+    handler.afterCondition(tokenlist, symboldatabase, functionScopes, errorLogger, settings);
 }
 
 static void valueFlowFwdAnalysis(const TokenList *tokenlist, const Settings *settings)
@@ -6565,9 +6575,9 @@ static bool getMinMaxValues(const std::string &typestr, const Settings *settings
     return getMinMaxValues(&vt, *settings, minvalue, maxvalue);
 }
 
-static void valueFlowSafeFunctions(TokenList *tokenlist, SymbolDatabase *symboldatabase, ErrorLogger *errorLogger, const Settings *settings)
+static void valueFlowSafeFunctions(TokenList *tokenlist, const std::vector<const Scope *> &functionScopes, ErrorLogger *errorLogger, const Settings *settings)
 {
-    for (const Scope *functionScope : symboldatabase->functionScopes) {
+    for (const Scope *functionScope : functionScopes) {
         if (!functionScope->bodyStart)
             continue;
         const Function *function = functionScope->function;
@@ -6698,6 +6708,16 @@ static void valueFlowUnknownFunctionReturn(TokenList *tokenlist, const Settings
     }
 }
 
+ValueFlow::ErrorPathChain::const_iterator ValueFlow::ErrorPathChain::begin() const
+{
+    if (mLast && mLast->order.empty()) {
+        mLast->order.resize(mLast->size);
+        for (const Node *node = mLast.get(); node; node = node->previous.get())
+            mLast->order[node->size - 1] = node;
+    }
+    return const_iterator(mLast, 0);
+}
+
 ValueFlow::Value::Value(const Token* c, long long val)
     : valueType(INT),
       bound(Bound::Point),
@@ -6776,6 +6796,30 @@ const ValueFlow::Value *ValueFlow::valueFlowConstantFoldAST(Token *expr, const S
     return expr && expr->hasKnownValue() ? &expr->values().front() : nullptr;
 }
 
+// Get the number of value changes of the global scope and of the function scopes
+static std::vector<std::size_t> getValueChanges(const SymbolDatabase *symboldatabase)
+{
+    std::vector<std::size_t> valueChanges;
+    valueChanges.push_back(symboldatabase->scopeList.front().valueChanges);
+    for (const Scope *scope : symboldatabase->functionScopes)
+        valueChanges.push_back(scope->valueChanges);
+    return valueChanges;
+}
+
+// Get the function scopes where values have changed since the previous call. Values that
+// changed outside the function bodies can affect all functions.
+static void getChangedScopes(const SymbolDatabase *symboldatabase, std::vector<std::size_t> &valueChanges, std::vector<const Scope *> &changedScopes)
+{
+    const std::vector<std::size_t> newValueChanges = getValueChanges(symboldatabase);
+    const bool globalChanged = (newValueChanges[0] != valueChanges[0]);
+    changedScopes.clear();
+    for (std::size_t i = 0; i < symboldatabase->functionScopes.size(); ++i) {
+        if (globalChanged || newValueChanges[i + 1] != valueChanges[i + 1])
+            changedScopes.push_back(symboldatabase->functionScopes[i]);
+    }
+    valueChanges = newValueChanges;
+}
+
 static std::size_t getTotalValues(TokenList *tokenlist)
 {
     std::size_t n = 1;
@@ -6784,6 +6828,131 @@ static std::size_t getTotalValues(TokenList *tokenlist)
     return n;
 }
 
+namespace {
+    /** Keeps the reports of the ValueFlow passes of a thread until all threads are done */
+    class ValueFlowBufferedLogger : public ErrorLogger {
+    public:
+        void reportOut(const std::string &outmsg) OVERRIDE {
+            mReports.emplace_back(Report::Type::OUT, outmsg, ErrorMessage());
+        }
+
+        void reportErr(const ErrorMessage &msg) OVERRIDE {
+            mReports.emplace_back(Report::Type::ERR, emptyString, msg);
+        }
+
+        void reportInfo(const ErrorMessage &msg) OVERRIDE {
+            mReports.emplace_back(Report::Type::INFO, emptyString, msg);
+        }
+
+        void bughuntingReport(const std::string &str) OVERRIDE {
+            mReports.emplace_back(Report::Type::BUGHUNTING, str, ErrorMessage());
+        }
+
+        void replay(ErrorLogger &errorLogger) const {
+            for (const Report &report : mReports) {
+                switch (report.type) {
+                case Report::Type::OUT:
+                    errorLogger.reportOut(report.str);
+                    break;
+                case Report::Type::ERR:
+                    errorLogger.reportErr(report.msg);
+                    break;
+                case Report::Type::INFO:
+                    errorLogger.reportInfo(report.msg);
+                    break;
+                case Report::Type::BUGHUNTING:
+                    errorLogger.bughuntingReport(report.str);
+                    break;
+                }
+            }
+        }
+
+    private:
+        struct Report {
+            enum class Type { OUT, ERR, INFO, BUGHUNTING };
+            Report(Type t, const std::string &s, const ErrorMessage &m) : type(t), str(s), msg(m) {}
+            Type type;
+            std::string str;
+            ErrorMessage msg;
+        };
+        std::vector<Report> mReports;
+    };
+}
+
+// Get the outermost function that contains the function scope. The passes for a function
+// also walk the tokens of the functions nested in it, e.g. member functions of local classes.
+static const Scope *getOutermostFunctionScope(const Scope *scope)
+{
+    const Scope *ret = scope;
+    for (const Scope *s = scope->nestedIn; s; s = s->nestedIn) {
+        if (s->type == Scope::eFunction)
+            ret = s;
+    }
+    return ret;
+}
+
+// Run passes that analyse one function at a time. With --valueflow-jobs the functions
+// are split between several threads. A function and the functions nested in it are
+// analysed by the same thread. The reports are given in the order of the functions
+// when all threads are done. All functions are done when this returns, so the passes
+// that look at several functions see all the values.
+template<class F>
+static void valueFlowForEachFunction(const std::vector<const Scope *> &functionScopes, ErrorLogger *errorLogger, const Settings *settings, F passes)
+{
+    if (settings->valueFlowJobs <= 1) {
+        passes(functionScopes, errorLogger);
+        return;
+    }
+
+    std::vector<std::vector<const Scope *>> groups;
+    std::map<const Scope *, std::size_t> groupIndex;
+    for (const Scope *scope : functionScopes) {
+        const std::pair<std::map<const Scope *, std::size_t>::iterator, bool> it = groupIndex.emplace(getOutermostFunctionScope(scope), groups.size());
+        if (it.second)
+            groups.emplace_back();
+        groups[it.first->second].push_back(scope);
+    }
+
+    const std::size_t threadCount = std::min<std::size_t>(settings->valueFlowJobs, groups.size());
+    if (threadCount <= 1) {
+        passes(functionScopes, errorLogger);
+        return;
+    }
+
+    std::vector<ValueFlowBufferedLogger> loggers(groups.size());
+    std::atomic<std::size_t> nextGroup(0);
+    std::exception_ptr exception;
+    std::mutex exceptionSync;
+
+    const auto worker = [&]() {
+        try {
+            for (std::size_t i = nextGroup++; i < groups.size(); i = nextGroup++)
+                passes(groups[i], errorLogger ? &loggers[i] : nullptr);
+        } catch (...) {
+            // Stop the other threads and rethrow the exception when all are done
+            nextGroup = groups.size();
+            std::lock_guard<std::mutex> lock(exceptionSync);
+            if (!exception)
+                exception = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 1; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread &t : threads)
+        t.join();
+
+    if (errorLogger) {
+        for (const ValueFlowBufferedLogger &logger : loggers)
+            logger.replay(*errorLogger);
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
 void ValueFlow::setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase, ErrorLogger *errorLogger, const Settings *settings)
 {
     for (Token *tok = tokenlist->front(); tok; tok = tok->next())
@@ -6801,20 +6970,32 @@ void ValueFlow::setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase,
     valueFlowSameExpressions(tokenlist);
     valueFlowFwdAnalysis(tokenlist, settings);
 
+    // The passes that only analyse one function at a time skip the functions
+    // where no values have changed since the previous iteration
+    std::vector<const Scope *> functionScopes(symboldatabase->functionScopes);
+    std::vector<std::size_t> valueChanges = getValueChanges(symboldatabase);
     std::size_t values = 0;
     std::size_t n = 4;
-    while (n > 0 && values < getTotalValues(tokenlist)) {
-        values = getTotalValues(tokenlist);
+    while (n > 0) {
+        const std::size_t total = getTotalValues(tokenlist);
+        if (total <= values)
+            break;
+        values = total;
         valueFlowPointerAliasDeref(tokenlist);
         valueFlowArrayBool(tokenlist);
         valueFlowRightShift(tokenlist, settings);
         valueFlowOppositeCondition(symboldatabase, settings);
-        valueFlowTerminatingCondition(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowBeforeCondition(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowAfterMove(tokenlist, symboldatabase, errorLogger, settings);
-        valueFlowAfterCondition(tokenlist, symboldatabase, errorLogger, settings);
+        // Not run in parallel, the functions after the first function with incomplete variables are skipped
+        valueFlowTerminatingCondition(tokenlist, symboldatabase, functionScopes, errorLogger, settings);
+        valueFlowForEachFunction(functionScopes, errorLogger, settings, [&](const std::vector<const Scope *> &scopes, ErrorLogger *logger) {
+            valueFlowBeforeCondition(tokenlist, scopes, logger, settings);
+            valueFlowAfterMove(tokenlist, scopes, logger, settings);
+            valueFlowAfterCondition(tokenlist, symboldatabase, scopes, logger, settings);
+        });
         valueFlowInferCondition(tokenlist, settings);
-        valueFlowAfterAssign(tokenlist, symboldatabase, errorLogger, settings);
+        valueFlowForEachFunction(functionScopes, errorLogger, settings, [&](const std::vector<const Scope *> &scopes, ErrorLogger *logger) {
+            valueFlowAfterAssign(tokenlist, scopes, logger, settings);
+        });
         valueFlowSwitchVariable(tokenlist, symboldatabase, errorLogger, settings);
         valueFlowForLoop(tokenlist, symboldatabase, errorLogger, settings);
         valueFlowSubFunction(tokenlist, symboldatabase, errorLogger, settings);
@@ -6825,12 +7006,18 @@ void ValueFlow::setValues(TokenList *tokenlist, SymbolDatabase* symboldatabase,
         if (tokenlist->isCPP()) {
             valueFlowSmartPointer(tokenlist, errorLogger, settings);
             valueFlowIterators(tokenlist, settings);
-            valueFlowIteratorAfterCondition(tokenlist, symboldatabase, errorLogger, settings);
+            valueFlowForEachFunction(functionScopes, errorLogger, settings, [&](const std::vector<const Scope *> &scopes, ErrorLogger *logger) {
+                valueFlowIteratorAfterCondition(tokenlist, symboldatabase, scopes, logger, settings);
+            });
             valueFlowIteratorInfer(tokenlist, settings);
-            valueFlowContainerSize(tokenlist, symboldatabase, errorLogger, settings);
-            valueFlowContainerAfterCondition(tokenlist, symboldatabase, errorLogger, settings);
+            valueFlowContainerSize(tokenlist, symboldatabase, functionScopes, errorLogger, settings);
         }
-        valueFlowSafeFunctions(tokenlist, symboldatabase, errorLogger, settings);
+        valueFlowForEachFunction(functionScopes, errorLogger, settings, [&](const std::vector<const Scope *> &scopes, ErrorLogger *logger) {
+            if (tokenlist->isCPP())
+                valueFlowContainerAfterCondition(tokenlist, symboldatabase, scopes, logger, settings);
+            valueFlowSafeFunctions(tokenlist, scopes, logger, settings);
+        });
+        getChangedScopes(symboldatabase, valueChanges, functionScopes);
         n--;
     }
 
@@ -25,7 +25,10 @@
 #include "mathlib.h"
 #include "utils.h"
 
+#include <cstddef>
+#include <iterator>
 #include <list>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -51,9 +54,134 @@ namespace ValueFlow {
             x--;
         }
     };
+
+    /**
+     * @brief Error path of a value.
+     *
+     * Values are copied very often during the analysis. The items of the error
+     * path are immutable and shared by the copies so copying a value does not
+     * copy the error path. Appending an item to the path does not copy the
+     * previous items either. The items can be iterated in order like a list;
+     * the order is stored in the last node the first time the path is iterated.
+     * Inserting items before the end (emplace_front(), insert() at begin())
+     * copies the following items so it is O(n).
+     */
+    class CPPCHECKLIB ErrorPathChain {
+    public:
+        typedef std::pair<const Token *, std::string> Item;
+
+    private:
+        struct Node {
+            Node(std::shared_ptr<const Node> previous_, Item item_)
+                : previous(std::move(previous_)), item(std::move(item_)), size(previous ? previous->size + 1 : 1) {}
+            const std::shared_ptr<const Node> previous;
+            const Item item;
+            const std::size_t size;
+            /** Nodes of the chain that ends with this node, filled by begin() */
+            mutable std::vector<const Node *> order;
+        };
+
+    public:
+        class const_iterator {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef Item value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const Item *pointer;
+            typedef const Item &reference;
+
+            const_iterator() : mIndex(0) {}
+            const_iterator(std::shared_ptr<const Node> last, std::size_t index) : mLast(std::move(last)), mIndex(index) {}
+
+            reference operator*() const {
+                return mLast->order[mIndex]->item;
+            }
+            pointer operator->() const {
+                return &mLast->order[mIndex]->item;
+            }
+            const_iterator &operator++() {
+                ++mIndex;
+                return *this;
+            }
+            const_iterator operator++(int) {
+                const_iterator it(*this);
+                ++mIndex;
+                return it;
+            }
+            bool operator==(const const_iterator &rhs) const {
+                return mIndex == rhs.mIndex;
+            }
+            bool operator!=(const const_iterator &rhs) const {
+                return mIndex != rhs.mIndex;
+            }
+
+        private:
+            friend class ErrorPathChain;
+            /** Keeps the nodes alive when the chain is changed during the iteration */
+            std::shared_ptr<const Node> mLast;
+            std::size_t mIndex;
+        };
+
+        ErrorPathChain() {}
+        // cppcheck-suppress noExplicitConstructor
+        ErrorPathChain(const std::list<Item> &errorPath) {
+            insert(end(), errorPath.begin(), errorPath.end());
+        }
+
+        operator std::list<Item>() const {
+            return std::list<Item>(begin(), end());
+        }
+
+        const_iterator begin() const;
+        const_iterator end() const {
+            return const_iterator(nullptr, size());
+        }
+
+        bool empty() const {
+            return !mLast;
+        }
+        std::size_t size() const {
+            return mLast ? mLast->size : 0;
+        }
+        const Item &back() const {
+            return mLast->item;
+        }
+
+        void clear() {
+            mLast.reset();
+        }
+        void push_back(Item item) {
+            mLast = std::make_shared<const Node>(std::move(mLast), std::move(item));
+        }
+        void emplace_back(const Token *tok, std::string info) {
+            push_back(Item(tok, std::move(info)));
+        }
+        void emplace_front(const Token *tok, std::string info) {
+            const std::list<Item> items(1, Item(tok, std::move(info)));
+            insert(const_iterator(nullptr, 0), items.begin(), items.end());
+        }
+
+        /** Insert items. Inserting before the end is O(n) since the following items are copied. */
+        template<class InputIterator>
+        void insert(const_iterator pos, InputIterator first, InputIterator last) {
+            std::vector<Item> following;
+            while (size() > pos.mIndex) {
+                following.push_back(mLast->item);
+                mLast = mLast->previous;
+            }
+            for (; first != last; ++first)
+                push_back(*first);
+            for (std::vector<Item>::reverse_iterator it = following.rbegin(); it != following.rend(); ++it)
+                push_back(std::move(*it));
+        }
+
+    private:
+        std::shared_ptr<const Node> mLast;
+    };
+
     class CPPCHECKLIB Value {
     public:
-        typedef std::pair<const Token *, std::string> ErrorPathItem;
+        typedef ErrorPathChain::Item ErrorPathItem;
         typedef std::list<ErrorPathItem> ErrorPath;
 
         explicit Value(long long val = 0)
@@ -246,7 +374,7 @@ namespace ValueFlow {
         /** Condition that this value depends on */
         const Token *condition;
 
-        ErrorPath errorPath;
+        ErrorPathChain errorPath;
 
         /** For calculated values - varId that calculated value depends on */
         nonneg int varId;
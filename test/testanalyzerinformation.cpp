@@ -0,0 +1,264 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2020 Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "analyzerinfo.h"
+#include "errorlogger.h"
+#include "importproject.h"
+#include "testsuite.h"
+
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+class TestAnalyzerInformation : public TestFixture {
+public:
+    TestAnalyzerInformation() : TestFixture("TestAnalyzerInformation") {
+    }
+
+private:
+    void run() OVERRIDE {
+        TEST_CASE(getAnalyzerInfoFile);
+        TEST_CASE(manifest);
+        TEST_CASE(manifestChanged);
+        TEST_CASE(readWrite);
+        TEST_CASE(analyzeFile);
+        TEST_CASE(dependencies);
+    }
+
+    void getAnalyzerInfoFile() const {
+        const std::list<std::string> sourcefiles = { "a/main.c", "b/main.c", "b/file.c" };
+        std::list<ImportProject::FileSettings> fileSettings;
+        fileSettings.emplace_back();
+        fileSettings.back().filename = "a/main.c";
+        fileSettings.back().cfg = "Debug";
+        AnalyzerInformation::writeFilesTxt(".", sourcefiles, fileSettings);
+
+        ASSERT_EQUALS("./main.a1", AnalyzerInformation::getAnalyzerInfoFile(".", "a/main.c", ""));
+        ASSERT_EQUALS("./main.a2", AnalyzerInformation::getAnalyzerInfoFile(".", "b/main.c", ""));
+        ASSERT_EQUALS("./file.a1", AnalyzerInformation::getAnalyzerInfoFile(".", "b/file.c", ""));
+        ASSERT_EQUALS("./main.a3", AnalyzerInformation::getAnalyzerInfoFile(".", "a/main.c", "Debug"));
+
+        // file that is not listed in files.txt
+        ASSERT_EQUALS("./other.c.analyzerinfo", AnalyzerInformation::getAnalyzerInfoFile(".", "c/other.c", ""));
+        ASSERT_EQUALS("./main.c.analyzerinfo", AnalyzerInformation::getAnalyzerInfoFile(".", "main.c", ""));
+
+        std::remove("files.txt");
+    }
+
+    void manifest() const {
+        AnalyzerInformation::writeFilesTxt(".", { "a/main.c", "b/main.c" }, std::list<ImportProject::FileSettings>());
+
+        const std::shared_ptr<const AnalyzerInformation::Manifest> manifest = AnalyzerInformation::getManifest(".");
+        ASSERT_EQUALS(2U, manifest->files.size());
+        ASSERT_EQUALS("main.a1", manifest->files[0].analyzerInfoFile);
+        ASSERT_EQUALS("", manifest->files[0].cfg);
+        ASSERT_EQUALS("a/main.c", manifest->files[0].sourcefile);
+        ASSERT_EQUALS("main.a2", manifest->files[1].analyzerInfoFile);
+        ASSERT_EQUALS("b/main.c", manifest->files[1].sourcefile);
+        ASSERT(manifest->find("b/main.c", "") == &manifest->files[1]);
+        ASSERT(manifest->find("b/main.c", "Debug") == nullptr);
+        ASSERT(manifest->find("main.c", "") == nullptr);
+
+        // The manifest is shared
+        ASSERT(manifest == AnalyzerInformation::getManifest("."));
+
+        std::remove("files.txt");
+        ASSERT_EQUALS(0U, AnalyzerInformation::getManifest(".")->files.size());
+    }
+
+    void manifestChanged() const {
+        AnalyzerInformation::writeFilesTxt(".", { "main.c" }, std::list<ImportProject::FileSettings>());
+        ASSERT_EQUALS("./main.a1", AnalyzerInformation::getAnalyzerInfoFile(".", "main.c", ""));
+
+        // files.txt is written by another process
+        {
+            std::ofstream fout("files.txt");
+            fout << "file.a1::file.c\n"
+                 << "main.a7::main.c\n";
+        }
+        ASSERT_EQUALS("./main.a7", AnalyzerInformation::getAnalyzerInfoFile(".", "main.c", ""));
+        ASSERT_EQUALS("./file.a1", AnalyzerInformation::getAnalyzerInfoFile(".", "file.c", ""));
+
+        std::remove("files.txt");
+    }
+
+    void readWrite() const {
+        AnalyzerInfoWriter writer;
+        writer.writeInt(0);
+        writer.writeInt(-1);
+        writer.writeInt(300);
+        writer.writeInt(-0x7fffffffffffffffLL - 1);
+        writer.writeString("abc");
+        writer.writeString(std::string("a\0b", 3));
+        writer.writeString("");
+
+        AnalyzerInfoReader reader(writer.str());
+        ASSERT_EQUALS(0, reader.readInt());
+        ASSERT_EQUALS(-1, reader.readInt());
+        ASSERT_EQUALS(300, reader.readInt());
+        ASSERT_EQUALS(-0x7fffffffffffffffLL - 1, reader.readInt());
+        ASSERT_EQUALS("abc", reader.readString());
+        ASSERT_EQUALS(std::string("a\0b", 3), reader.readString());
+        ASSERT_EQUALS("", reader.readString());
+        ASSERT_EQUALS(true, reader.atEnd());
+        ASSERT_EQUALS(false, reader.error());
+
+        // missing data
+        ASSERT_EQUALS(0, reader.readInt());
+        ASSERT_EQUALS(true, reader.error());
+        AnalyzerInfoReader reader2(writer.str().data(), writer.str().size() - 4);
+        for (int i = 0; i < 5; ++i)
+            reader2.readInt();
+        ASSERT_EQUALS("", reader2.readString());
+        ASSERT_EQUALS(true, reader2.error());
+    }
+
+    void analyzeFile() const {
+        const std::list<ErrorMessage::FileLocation> callStack = { ErrorMessage::FileLocation("test.c", 3, 7) };
+        const ErrorMessage msg(callStack, "test.c", Severity::error, "message", "id", false);
+
+        std::list<ErrorMessage> errors;
+        {
+            AnalyzerInformation analyzerInformation;
+            ASSERT_EQUALS(true, analyzerInformation.analyzeFile(".", "test.c", "", 1234, &errors));
+            analyzerInformation.reportErr(msg, false);
+            analyzerInformation.setFileInfo("check", std::string("data\0\n", 6));
+        }
+
+        ASSERT_EQUALS(0U, errors.size());
+        {
+            AnalyzerInformation analyzerInformation;
+            ASSERT_EQUALS(false, analyzerInformation.analyzeFile(".", "test.c", "", 1234, &errors));
+        }
+        ASSERT_EQUALS(1U, errors.size());
+        ASSERT_EQUALS("test.c:3:7: error: message [id]", errors.front().toString(false, "{file}:{line}:{column}: {severity}: {message} [{id}]"));
+
+        std::list<std::pair<std::string, std::string>> fileInfo;
+        ASSERT_EQUALS(true, AnalyzerInformation::loadFileInfo("./test.c.analyzerinfo", &fileInfo));
+        ASSERT_EQUALS(1U, fileInfo.size());
+        ASSERT_EQUALS("check", fileInfo.front().first);
+        ASSERT_EQUALS(std::string("data\0\n", 6), fileInfo.front().second);
+
+        // The checksum has changed
+        errors.clear();
+        {
+            AnalyzerInformation analyzerInformation;
+            ASSERT_EQUALS(true, analyzerInformation.analyzeFile(".", "test.c", "", 5678, &errors));
+            analyzerInformation.reportErr(msg, false);
+        }
+        ASSERT_EQUALS(0U, errors.size());
+
+        // Incomplete file
+        {
+            std::ifstream fin("test.c.analyzerinfo", std::ios::binary);
+            const std::string data((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+            fin.close();
+            std::ofstream fout("test.c.analyzerinfo", std::ios::binary);
+            fout << data.substr(0, data.size() - 2);
+        }
+        {
+            AnalyzerInformation analyzerInformation;
+            ASSERT_EQUALS(true, analyzerInformation.analyzeFile(".", "test.c", "", 5678, &errors));
+            analyzerInformation.close();
+        }
+        ASSERT_EQUALS(0U, errors.size());
+
+        std::remove("test.c.analyzerinfo");
+    }
+
+    void dependencies() const {
+        const std::list<ErrorMessage::FileLocation> callStack = { ErrorMessage::FileLocation("dep.c", 1, 1) };
+        const ErrorMessage msg(callStack, "dep.c", Severity::error, "message", "id", false);
+        {
+            std::ofstream fout("dep.c");
+            fout << "int x;\n";
+        }
+        const std::vector<std::string> files = { "dep.c" };
+        const std::time_t future = std::time(nullptr) + 100;
+
+        std::list<ErrorMessage> errors;
+        ASSERT_EQUALS(false, AnalyzerInformation::isUnchanged(".", "dep.c", "", 1, &errors));
+        {
+            AnalyzerInformation analyzerInformation;
+            ASSERT_EQUALS(true, analyzerInformation.analyzeFile(".", "dep.c", "", 1234, &errors));
+            analyzerInformation.reportErr(msg, false);
+            analyzerInformation.setDependencies(1, files, std::set<std::string>(), future);
+        }
+        ASSERT_EQUALS(true, AnalyzerInformation::isUnchanged(".", "dep.c", "", 1, &errors));
+        ASSERT_EQUALS(1U, errors.size());
+        errors.clear();
+
+        // The settings have changed
+        ASSERT_EQUALS(false, AnalyzerInformation::isUnchanged(".", "dep.c", "", 2, &errors));
+
+        // The analysis was skipped, the saved files are updated
+        {
+            AnalyzerInformation analyzerInformation;
+            ASSERT_EQUALS(false, analyzerInformation.analyzeFile(".", "dep.c", "", 1234, &errors));
+            analyzerInformation.setDependencies(2, files, std::set<std::string>(), future);
+        }
+        errors.clear();
+        ASSERT_EQUALS(true, AnalyzerInformation::isUnchanged(".", "dep.c", "", 2, &errors));
+        ASSERT_EQUALS(1U, errors.size());
+        errors.clear();
+
+        // A file is created where an included file was looked for before it was found
+        const std::set<std::string> missedFiles = { "dep.h" };
+        {
+            AnalyzerInformation analyzerInformation;
+            ASSERT_EQUALS(false, analyzerInformation.analyzeFile(".", "dep.c", "", 1234, &errors));
+            analyzerInformation.setDependencies(2, files, missedFiles, future);
+        }
+        errors.clear();
+        ASSERT_EQUALS(true, AnalyzerInformation::isUnchanged(".", "dep.c", "", 2, &errors));
+        errors.clear();
+        {
+            std::ofstream fout("dep.h");
+        }
+        ASSERT_EQUALS(false, AnalyzerInformation::isUnchanged(".", "dep.c", "", 2, &errors));
+        std::remove("dep.h");
+
+        // The file has changed
+        {
+            std::ofstream fout("dep.c", std::ios::app);
+            fout << "int y;\n";
+        }
+        ASSERT_EQUALS(false, AnalyzerInformation::isUnchanged(".", "dep.c", "", 2, &errors));
+
+        // The file was modified after the analysis started
+        {
+            AnalyzerInformation analyzerInformation;
+            ASSERT_EQUALS(true, analyzerInformation.analyzeFile(".", "dep.c", "", 5678, &errors));
+            analyzerInformation.setDependencies(2, files, std::set<std::string>(), 0);
+        }
+        ASSERT_EQUALS(false, AnalyzerInformation::isUnchanged(".", "dep.c", "", 2, &errors));
+        ASSERT_EQUALS(0U, errors.size());
+
+        std::remove("dep.c");
+        std::remove("dep.c.analyzerinfo");
+    }
+};
+
+REGISTER_TEST(TestAnalyzerInformation)
@@ -23,6 +23,7 @@
 #include "standards.h"
 #include "suppressions.h"
 #include "testsuite.h"
+#include "threadexecutor.h"
 #include "timer.h"
 
 #include <list>
@@ -98,6 +99,15 @@ private:
         TEST_CASE(jobs);
         TEST_CASE(jobsMissingCount);
         TEST_CASE(jobsInvalid);
+        TEST_CASE(configJobs);
+        TEST_CASE(configJobsInvalid);
+        TEST_CASE(configJobsTooSmall);
+        TEST_CASE(valueFlowJobs);
+        TEST_CASE(valueFlowJobsInvalid);
+        TEST_CASE(libraryCacheDir);
+        TEST_CASE(executorThread);
+        TEST_CASE(executorProcess);
+        TEST_CASE(executorInvalid);
         TEST_CASE(maxConfigs);
         TEST_CASE(maxConfigsMissingCount);
         TEST_CASE(maxConfigsInvalid);
@@ -654,6 +664,81 @@ private:
         ASSERT_EQUALS(false, defParser.parseFromArgs(4, argv));
     }
 
+    void configJobs() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--config-jobs=4", "file.cpp"};
+        settings.configJobs = 1;
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT_EQUALS(4, settings.configJobs);
+    }
+
+    void configJobsInvalid() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--config-jobs=e", "file.cpp"};
+        // Fails since invalid count given for --config-jobs=
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
+    void configJobsTooSmall() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--config-jobs=0", "file.cpp"};
+        // Fails since count must be greater than 0
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
+    void valueFlowJobs() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--valueflow-jobs=4", "file.cpp"};
+        settings.valueFlowJobs = 1;
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT_EQUALS(4, settings.valueFlowJobs);
+        settings.valueFlowJobs = 1;
+    }
+
+    void valueFlowJobsInvalid() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--valueflow-jobs=0", "file.cpp"};
+        // Fails since count must be greater than 0
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
+    void libraryCacheDir() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--library-cache-dir=cache", "file.cpp"};
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT_EQUALS("cache", settings.library.cacheDir());
+        settings.library.setCacheDir(emptyString);
+    }
+
+    void executorThread() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--executor=thread", "file.cpp"};
+        settings.executor = Settings::ExecutorType::Process;
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT(settings.executor == Settings::ExecutorType::Thread);
+    }
+
+    void executorProcess() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--executor=process", "file.cpp"};
+        settings.executor = Settings::ExecutorType::Thread;
+#ifdef THREADING_MODEL_FORK
+        ASSERT(defParser.parseFromArgs(3, argv));
+        ASSERT(settings.executor == Settings::ExecutorType::Process);
+        settings.executor = Settings::ExecutorType::Thread;
+#else
+        // Fails since there is no fork()
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+#endif
+    }
+
+    void executorInvalid() {
+        REDIRECT;
+        const char * const argv[] = {"cppcheck", "--executor=fibers", "file.cpp"};
+        // Fails since the executor is unknown
+        ASSERT_EQUALS(false, defParser.parseFromArgs(3, argv));
+    }
+
     void maxConfigs() {
         REDIRECT;
         const char * const argv[] = {"cppcheck", "-f", "--max-configs=12", "file.cpp"};
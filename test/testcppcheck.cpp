@@ -36,12 +36,14 @@ private:
     class ErrorLogger2 : public ErrorLogger {
     public:
         std::list<std::string> id;
+        std::string output;
 
         void reportOut(const std::string & /*outmsg*/) OVERRIDE {}
         void bughuntingReport(const std::string & /*str*/) OVERRIDE {}
 
         void reportErr(const ErrorMessage &msg) OVERRIDE {
             id.push_back(msg.id);
+            output += msg.toString(false) + '\n';
         }
     };
 
@@ -49,6 +51,8 @@ private:
         TEST_CASE(instancesSorted);
         TEST_CASE(classInfoFormat);
         TEST_CASE(getErrorMessages);
+        TEST_CASE(checkConfigurationsInParallel);
+        TEST_CASE(checkConfigurationsInParallelFileInfo);
     }
 
     void instancesSorted() const {
@@ -103,6 +107,82 @@ private:
         ASSERT(foundPurgedConfiguration);
         ASSERT(foundTooManyConfigs);
     }
+
+    std::string checkConfigurations(const char code[], unsigned int configJobs, int maxConfigs) const {
+        ErrorLogger2 errorLogger;
+        CppCheck cppCheck(errorLogger, true, nullptr);
+        cppCheck.settings().configJobs = configJobs;
+        cppCheck.settings().maxConfigs = maxConfigs;
+        cppCheck.settings().debugwarnings = true;
+        cppCheck.settings().addEnabled("information");
+        cppCheck.check("test.cpp", code);
+        return errorLogger.output;
+    }
+
+    void checkConfigurationsInParallel() const {
+        const char code[] = "#ifdef A\n"
+                            "void a() { int x[10]; x[10] = 0; }\n"
+                            "#endif\n"
+                            "#ifdef B\n"
+                            "#error B\n"
+                            "#endif\n"
+                            "#ifdef C\n"
+                            "void c() { int x[10]; x[11] = 0; }\n"
+                            "#endif\n"
+                            "#ifdef D\n"
+                            "#endif\n"
+                            "void f() { int x[10]; x[12] = 0; }\n";
+
+        const std::string all = checkConfigurations(code, 1, 12);
+        ASSERT(all.find("index 10,") != std::string::npos);
+        ASSERT(all.find("index 11,") != std::string::npos);
+        ASSERT(all.find("index 12,") != std::string::npos);
+        ASSERT(all.find("The configuration 'D' was not checked") != std::string::npos);
+
+        // Same results in the same order
+        for (int maxConfigs = 1; maxConfigs <= 4; ++maxConfigs) {
+            const std::string expected = checkConfigurations(code, 1, maxConfigs);
+            ASSERT_EQUALS(expected, checkConfigurations(code, 2, maxConfigs));
+            ASSERT_EQUALS(expected, checkConfigurations(code, 8, maxConfigs));
+        }
+    }
+
+    std::string checkConfigurationsFileInfo(const char code[], unsigned int configJobs) const {
+        ErrorLogger2 errorLogger;
+        CppCheck cppCheck(errorLogger, true, nullptr);
+        cppCheck.settings().configJobs = configJobs;
+        cppCheck.settings().force = true;
+        cppCheck.settings().addEnabled("unusedFunction");
+        std::string fileInfo;
+        cppCheck.setFileInfoCallback([&](const AnalyzerInformation::TranslationUnitInfo &tu) {
+            for (const std::pair<std::string, std::string> &fi : tu.fileInfo)
+                fileInfo += fi.first + ": " + fi.second + '\n';
+        });
+        cppCheck.check("test.cpp", code);
+        return fileInfo;
+    }
+
+    void checkConfigurationsInParallelFileInfo() const {
+        // The configurations 'A', 'C', 'D' and 'E' are purged, their file info must not be collected
+        const char code[] = "#ifdef A\n"
+                            "#endif\n"
+                            "#ifdef C\n"
+                            "#endif\n"
+                            "#ifdef D\n"
+                            "#endif\n"
+                            "#ifdef E\n"
+                            "#endif\n"
+                            "#ifdef B\n"
+                            "static void b() {}\n"
+                            "#endif\n"
+                            "void f() {}\n"
+                            "void g() { f(); }\n";
+
+        const std::string expected = checkConfigurationsFileInfo(code, 1);
+        ASSERT(expected.find("CheckUnusedFunctions: ") != std::string::npos);
+        ASSERT_EQUALS(expected, checkConfigurationsFileInfo(code, 2));
+        ASSERT_EQUALS(expected, checkConfigurationsFileInfo(code, 8));
+    }
 };
 
 REGISTER_TEST(TestCppcheck)
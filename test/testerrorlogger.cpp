@@ -16,6 +16,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "analyzerinfo.h"
 #include "config.h"
 #include "cppcheck.h"
 #include "errorlogger.h"
@@ -24,6 +25,8 @@
 
 #include <list>
 #include <string>
+#include <thread>
+#include <vector>
 
 
 class TestErrorLogger : public TestFixture {
@@ -58,6 +61,10 @@ private:
         TEST_CASE(DeserializeInvalidInput);
         TEST_CASE(SerializeSanitize);
         TEST_CASE(SerializeFileLocation);
+        TEST_CASE(SerializeBinary);
+        TEST_CASE(Fingerprint);
+        TEST_CASE(reportedErrors);
+        TEST_CASE(toxml);
 
         TEST_CASE(suppressUnmatchedSuppressions);
     }
@@ -310,6 +317,113 @@ private:
         ASSERT_EQUALS("abcd:/,", msg2.callStack.front().getinfo());
     }
 
+    void SerializeBinary() const {
+        ErrorMessage::FileLocation loc1("a.c", 1, 2);
+        ErrorMessage::FileLocation loc2("./b.c", "info", 3, 4);
+        loc2.setfile("b.c");
+        ErrorMessage msg({loc1, loc2}, "a.c", Severity::warning, "$symbol:x\nShort $symbol\nVerbose $symbol", "errorId", CWE(123U), true);
+        msg.hash = 456;
+
+        // The file names are written as numbers
+        std::vector<std::string> fileNames;
+        const auto getFileIndex = [&fileNames](const std::string &fileName) {
+            for (std::size_t i = 0; i < fileNames.size(); ++i) {
+                if (fileNames[i] == fileName)
+                    return static_cast<long long>(i);
+            }
+            fileNames.push_back(fileName);
+            return static_cast<long long>(fileNames.size() - 1);
+        };
+        const auto getFileName = [&fileNames](long long index) -> const std::string * {
+            return index < static_cast<long long>(fileNames.size()) ? &fileNames[index] : nullptr;
+        };
+        AnalyzerInfoWriter writer;
+        msg.serialize(writer, getFileIndex);
+        msg.serialize(writer, getFileIndex);
+        ASSERT_EQUALS(3U, fileNames.size());
+
+        // The same object is used to read both messages
+        AnalyzerInfoReader reader(writer.str());
+        ErrorMessage msg2;
+        for (int i = 0; i < 2; ++i) {
+            ASSERT_EQUALS(true, msg2.deserialize(reader, getFileName));
+            ASSERT_EQUALS("errorId", msg2.id);
+            ASSERT_EQUALS(Severity::warning, msg2.severity);
+            ASSERT_EQUALS(123U, msg2.cwe.id);
+            ASSERT_EQUALS(456U, msg2.hash);
+            ASSERT_EQUALS(true, msg2.inconclusive);
+            ASSERT_EQUALS("Short x", msg2.shortMessage());
+            ASSERT_EQUALS("Verbose x", msg2.verboseMessage());
+            ASSERT_EQUALS("x\n", msg2.symbolNames());
+            ASSERT_EQUALS("a.c", msg2.file0);
+            ASSERT_EQUALS(2U, msg2.callStack.size());
+            ASSERT_EQUALS("[a.c:1] -> [b.c:3]", ErrorLogger::callStackToString(msg2.callStack));
+            ASSERT_EQUALS("./b.c", msg2.callStack.back().getOrigFile(false));
+            ASSERT_EQUALS(4U, msg2.callStack.back().column);
+            ASSERT_EQUALS("info", msg2.callStack.back().getinfo());
+        }
+        ASSERT_EQUALS(true, reader.atEnd());
+
+        // Unknown file number
+        fileNames.clear();
+        AnalyzerInfoReader reader2(writer.str());
+        ASSERT_EQUALS(false, msg2.deserialize(reader2, getFileName));
+    }
+
+    void Fingerprint() const {
+        // The messages have the same fingerprint when they have the same text
+        ErrorMessage::FileLocation loc1("a.c", 1, 2);
+        ErrorMessage::FileLocation loc2("a.c", 1, 5);
+        ErrorMessage::FileLocation loc3("a\\b.c", 1, 2);
+        ErrorMessage::FileLocation loc4("a/b.c", 1, 2);
+        const ErrorMessage msg1({loc1}, "a.c", Severity::error, "Short\nVerbose", "id1", false);
+        const ErrorMessage msg2({loc2}, "b.c", Severity::error, "Short\nVerbose", "id2", false);
+        const ErrorMessage msg3({loc1}, "a.c", Severity::error, "Short\nVerbose2", "id1", false);
+        const ErrorMessage msg4({loc1}, "a.c", Severity::error, "Short\nVerbose", "id1", true);
+        const ErrorMessage msg5({loc3}, "a.c", Severity::error, "Short\nVerbose", "id1", false);
+        const ErrorMessage msg6({loc4}, "a.c", Severity::error, "Short\nVerbose", "id1", false);
+        const ErrorMessage msg7({loc1, loc1}, "a.c", Severity::error, "Short\nVerbose", "id1", false);
+        ASSERT(msg1.fingerprint(false) == msg2.fingerprint(false));
+        ASSERT(msg1.fingerprint(true) == msg2.fingerprint(true));
+        ASSERT(msg1.fingerprint(false) == msg3.fingerprint(false));
+        ASSERT(msg1.fingerprint(true) != msg3.fingerprint(true));
+        ASSERT(msg1.fingerprint(false) != msg4.fingerprint(false));
+        ASSERT(msg5.fingerprint(false) == msg6.fingerprint(false));
+        ASSERT(msg1.fingerprint(false) != msg5.fingerprint(false));
+        ASSERT(msg1.fingerprint(false) != msg7.fingerprint(false));
+    }
+
+    void reportedErrors() const {
+        ReportedErrors reportedErrors;
+        ASSERT_EQUALS(true, reportedErrors.insert(1ULL));
+        ASSERT_EQUALS(false, reportedErrors.insert(1ULL));
+        ASSERT_EQUALS(true, reportedErrors.contains(1ULL));
+        ASSERT_EQUALS(false, reportedErrors.contains(2ULL));
+        ASSERT_EQUALS(true, reportedErrors.insert(std::string("[a.c:1]: (error) message")));
+        ASSERT_EQUALS(false, reportedErrors.insert(std::string("[a.c:1]: (error) message")));
+        reportedErrors.clear();
+        ASSERT_EQUALS(true, reportedErrors.insert(1ULL));
+
+        // Each error is added once when threads add the same errors
+        std::vector<int> added(4, 0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&reportedErrors, &added, t]() {
+                for (unsigned long long fingerprint = 100; fingerprint < 1100; ++fingerprint)
+                    added[t] += reportedErrors.insert(fingerprint * 0x9E3779B97F4A7C15ULL) ? 1 : 0;
+            });
+        }
+        for (std::thread &t : threads)
+            t.join();
+        ASSERT_EQUALS(1000, added[0] + added[1] + added[2] + added[3]);
+    }
+
+    void toxml() const {
+        ASSERT_EQUALS("abc", ErrorLogger::toxml("abc"));
+        ASSERT_EQUALS("a&lt;b&gt;&amp;&quot;&apos;", ErrorLogger::toxml("a<b>&\"'"));
+        ASSERT_EQUALS("\\0x", ErrorLogger::toxml(std::string("\0\t", 2)));
+    }
+
     void suppressUnmatchedSuppressions() {
         std::list<Suppressions::Suppression> suppressions;
 
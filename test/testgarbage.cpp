@@ -1672,6 +1672,7 @@ private:
         ASSERT_THROW(checkCode("&p(!{}e x){({(0?:?){({})}()})}"), InternalError); // #7118
         ASSERT_THROW(checkCode("<class T> { struct { typename D4:typename Base<T*> }; };"), InternalError); // #3533
         ASSERT_THROW(checkCode(" > template < . > struct Y < T > { = } ;\n"), InternalError); // #6108
+        ASSERT_THROW(checkCode("operator f ( int x , typedef int A ; ) const { }"), InternalError);
     }
 
     void syntaxErrorLastToken() {
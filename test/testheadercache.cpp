@@ -0,0 +1,189 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2020 Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "headercache.h"
+#include "testsuite.h"
+
+#include <simplecpp.h>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class TestHeaderCache : public TestFixture {
+public:
+    TestHeaderCache() : TestFixture("TestHeaderCache") {
+    }
+
+private:
+    void run() OVERRIDE {
+        TEST_CASE(reuseTokens);
+        TEST_CASE(fileChanged);
+        TEST_CASE(fileStamp);
+        TEST_CASE(load);
+        TEST_CASE(missedFiles);
+    }
+
+    static void writeFile(const std::string &filename, const std::string &code) {
+        std::ofstream fout(filename);
+        fout << code;
+    }
+
+    static std::string read(HeaderCache &headerCache, std::vector<std::string> &files, const std::string &filename, simplecpp::OutputList *outputList = nullptr) {
+        std::ifstream fin(filename);
+        const std::unique_ptr<simplecpp::TokenList> tokens(headerCache.read(fin, files, filename, outputList));
+        std::string ret;
+        for (const simplecpp::Token *tok = tokens->cfront(); tok; tok = tok->next)
+            ret += tok->location.file() + ':' + std::to_string(tok->location.line) + ':' + tok->str() + ' ';
+        return ret;
+    }
+
+    void reuseTokens() {
+        const std::string filename("testheadercache1.h");
+        writeFile(filename, "int x;\n"
+                  "#line 10 \"other.h\"\n"
+                  "int y;\n"
+                  "int z; \\ \n");
+
+        HeaderCache headerCache;
+        std::vector<std::string> files1(1, "test1.cpp");
+        simplecpp::OutputList outputList1;
+        const std::string tokens1 = read(headerCache, files1, filename, &outputList1);
+        ASSERT_EQUALS(0, headerCache.hits());
+        ASSERT_EQUALS(1, headerCache.misses());
+
+        // The tokens are copied from the cache and the files are mapped to this translation unit
+        std::vector<std::string> files2;
+        files2.push_back("test2.cpp");
+        files2.push_back("other.h");
+        simplecpp::OutputList outputList2;
+        const std::string tokens2 = read(headerCache, files2, filename, &outputList2);
+        ASSERT_EQUALS(1, headerCache.hits());
+        ASSERT_EQUALS(1, headerCache.misses());
+
+        ASSERT_EQUALS("testheadercache1.h:1:int testheadercache1.h:1:x testheadercache1.h:1:; "
+                      "testheadercache1.h:2:# testheadercache1.h:2:line testheadercache1.h:2:10 testheadercache1.h:2:\"other.h\" "
+                      "other.h:10:int other.h:10:y other.h:10:; "
+                      "other.h:11:int other.h:11:z other.h:11:; ", tokens1);
+        ASSERT_EQUALS(tokens1, tokens2);
+        ASSERT_EQUALS(3U, files1.size());
+        ASSERT_EQUALS(3U, files2.size());
+        ASSERT_EQUALS("other.h", files2[1]);
+        ASSERT_EQUALS(filename, files2[2]);
+
+        // Output from the tokenizing is repeated
+        ASSERT_EQUALS(1U, outputList1.size());
+        ASSERT_EQUALS(1U, outputList2.size());
+        ASSERT_EQUALS(outputList1.front().msg, outputList2.front().msg);
+        ASSERT_EQUALS(outputList1.front().location.file(), outputList2.front().location.file());
+
+        std::remove(filename.c_str());
+    }
+
+    void fileChanged() {
+        const std::string filename("testheadercache2.h");
+        writeFile(filename, "int x;");
+
+        HeaderCache headerCache;
+        std::vector<std::string> files(1, "test.cpp");
+        ASSERT_EQUALS("testheadercache2.h:1:int testheadercache2.h:1:x testheadercache2.h:1:; ", read(headerCache, files, filename));
+
+        // The size changed => the file is read again
+        writeFile(filename, "int xy;");
+        ASSERT_EQUALS("testheadercache2.h:1:int testheadercache2.h:1:xy testheadercache2.h:1:; ", read(headerCache, files, filename));
+        ASSERT_EQUALS(0, headerCache.hits());
+        ASSERT_EQUALS(2, headerCache.misses());
+
+        std::remove(filename.c_str());
+    }
+
+    void fileStamp() {
+        const std::string filename("testheadercache5.h");
+        writeFile(filename, "int x;");
+
+        long long mtime = 0;
+        long long size = 0;
+        ASSERT_EQUALS(true, HeaderCache::getFileStamp(filename, &mtime, &size));
+        ASSERT_EQUALS(6, size);
+        ASSERT(mtime != 0);
+
+        std::remove(filename.c_str());
+        ASSERT_EQUALS(false, HeaderCache::getFileStamp(filename, &mtime, &size));
+    }
+
+    void load() {
+        const std::string filename("testheadercache3.h");
+        writeFile(filename, "int x;");
+
+        const char code[] = "#include \"testheadercache3.h\"\n";
+        HeaderCache headerCache;
+        for (int i = 0; i < 2; ++i) {
+            std::vector<std::string> files;
+            std::istringstream istr(code);
+            const simplecpp::TokenList rawtokens(istr, files, "test.cpp");
+            std::map<std::string, simplecpp::TokenList *> filedata = simplecpp::load(rawtokens, files, simplecpp::DUI(), nullptr, &headerCache);
+            ASSERT_EQUALS(1U, filedata.size());
+            ASSERT_EQUALS("int", filedata[filename]->cfront()->str());
+            ASSERT_EQUALS(filename, filedata[filename]->cfront()->location.file());
+            simplecpp::cleanup(filedata);
+        }
+        ASSERT_EQUALS(1, headerCache.hits());
+        ASSERT_EQUALS(1, headerCache.misses());
+
+        std::remove(filename.c_str());
+    }
+
+    void missedFiles() {
+        writeFile("testheadercache4.h", "int x;");
+
+        const char code[] = "#include \"testheadercache4.h\"\n"
+                            "#include <testheadercache4.h>\n"
+                            "#include <missing.h>\n";
+        std::vector<std::string> files;
+        std::istringstream istr(code);
+        const simplecpp::TokenList rawtokens(istr, files, "dir/test.cpp");
+        simplecpp::DUI dui;
+        dui.includePaths.push_back("inc");
+        dui.includePaths.push_back(".");
+
+        // The paths that are tried before a file is found, a file that is not found is tried everywhere
+        std::set<std::string> missedFiles;
+        ASSERT_EQUALS(true, HeaderCache::getMissedFiles(rawtokens, dui, &missedFiles));
+        ASSERT_EQUALS("dir/missing.h dir/testheadercache4.h inc/missing.h inc/testheadercache4.h missing.h ", join(missedFiles));
+
+        // A file that is included with a macro can't be known
+        std::istringstream istr2("#include HEADER\n");
+        const simplecpp::TokenList rawtokens2(istr2, files, "test.cpp");
+        ASSERT_EQUALS(false, HeaderCache::getMissedFiles(rawtokens2, dui, &missedFiles));
+
+        std::remove("testheadercache4.h");
+    }
+
+    static std::string join(const std::set<std::string> &strings) {
+        std::string ret;
+        for (const std::string &s : strings)
+            ret += s + ' ';
+        return ret;
+    }
+};
+
+REGISTER_TEST(TestHeaderCache)
@@ -17,6 +17,8 @@
  */
 
 #include "library.h"
+#include "librarycache.h"
+#include "path.h"
 #include "settings.h"
 #include "standards.h"
 #include "testsuite.h"
@@ -25,6 +27,10 @@
 #include "tokenlist.h"
 
 #include <tinyxml2.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <list>
 #include <map>
 #include <set>
 #include <string>
@@ -56,6 +62,7 @@ private:
         TEST_CASE(function_namespace);
         TEST_CASE(function_method);
         TEST_CASE(function_baseClassMethod); // calling method in base class
+        TEST_CASE(function_nameMemo);
         TEST_CASE(function_warn);
         TEST_CASE(memory);
         TEST_CASE(memory2); // define extra "free" allocation functions
@@ -65,6 +72,8 @@ private:
         TEST_CASE(container);
         TEST_CASE(version);
         TEST_CASE(loadLibErrors);
+        TEST_CASE(cache);
+        TEST_CASE(cacheStd);
     }
 
     static Library::Error readLibrary(Library& library, const char* xmldata) {
@@ -567,6 +576,43 @@ private:
         }
     }
 
+    void function_nameMemo() const {
+        const char xmldata[] = "<?xml version=\"1.0\"?>\n"
+                               "<def>\n"
+                               "  <function name=\"CString::Format\">\n"
+                               "    <noreturn>false</noreturn>\n"
+                               "  </function>\n"
+                               "</def>";
+        Library library;
+        ASSERT_EQUALS(true, Library::OK == (readLibrary(library, xmldata)).errorcode);
+
+        Tokenizer tokenizer(&settings, nullptr);
+        std::istringstream istr("CString str; str.Format();");
+        tokenizer.tokenize(istr, "test.cpp");
+        Token *tok = const_cast<Token *>(Token::findsimplematch(tokenizer.tokens(), "Format"));
+
+        // The name is looked up once and then remembered by the token
+        tok->clearLibraryFunctionName(); // remembered for settings.library by the tokenizer
+        ASSERT(tok->libraryFunctionName(&library) == nullptr);
+        ASSERT_EQUALS("CString::Format", library.getFunctionName(tok));
+        ASSERT(tok->libraryFunctionName(&library) != nullptr);
+        ASSERT_EQUALS("CString::Format", *tok->libraryFunctionName(&library));
+        ASSERT_EQUALS("CString::Format", library.getFunctionName(tok));
+        ASSERT(library.isnotnoreturn(tok));
+
+        // A remembered name is not replaced, the name is still looked up for other libraries
+        ASSERT(tok->libraryFunctionName(&settings.library) == nullptr);
+        ASSERT_EQUALS("CString::Format", settings.library.getFunctionName(tok));
+        ASSERT(tok->libraryFunctionName(&settings.library) == nullptr);
+        tok->libraryFunctionName(&library, "Format");
+        ASSERT_EQUALS("CString::Format", *tok->libraryFunctionName(&library));
+
+        // Looked up again when the AST is changed
+        tok->clearAst();
+        ASSERT(tok->libraryFunctionName(&library) == nullptr);
+        ASSERT_EQUALS("", library.getFunctionName(tok)); // member functions are not looked up without AST
+    }
+
     void function_baseClassMethod() const {
         const char xmldata[] = "<?xml version=\"1.0\"?>\n"
                                "<def>\n"
@@ -968,6 +1014,96 @@ private:
         // comma followed by dot
         LOADLIB_ERROR_INVALID_RANGE("-10:0,.5:");
     }
+
+    static std::string readFile(const std::string &filename) {
+        std::ifstream fin(filename, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+    }
+
+    static bool fileExists(const std::string &filename) {
+        return std::ifstream(filename).is_open();
+    }
+
+    void cache() const {
+        const std::string cfg("testlibrarycache.cfg");
+        const char xmldata[] = "<?xml version=\"1.0\"?>\n"
+                               "<def>\n"
+                               "  <function name=\"foo\">\n"
+                               "    <noreturn>true</noreturn>\n"
+                               "    <arg nr=\"1\"><not-null/><valid>0:10</valid></arg>\n"
+                               "  </function>\n"
+                               "  <podtype name=\"s16\" sign=\"s\" size=\"2\"/>\n"
+                               "</def>";
+        {
+            std::ofstream fout(cfg);
+            fout << xmldata;
+        }
+        const unsigned long long key = LibraryCache::hash(LibraryCache::hash(0, Path::getAbsoluteFilePath(cfg)), xmldata);
+        const std::string cacheFile = "./" + LibraryCache::filename(key);
+        std::remove(cacheFile.c_str());
+
+        // The cache file is written when the cfg file is loaded the first time
+        Library library1;
+        library1.setCacheDir(".");
+        ASSERT_EQUALS(true, Library::OK == library1.load(nullptr, cfg.c_str()).errorcode);
+        ASSERT_EQUALS(true, fileExists(cacheFile));
+
+        // The library is loaded from the cache file
+        Library library2;
+        library2.setCacheDir(".");
+        ASSERT_EQUALS(false, library2.loadCache(nullptr, std::list<std::string>(1, "missing.cfg")));
+        ASSERT_EQUALS(true, library2.loadCache(nullptr, std::list<std::string>(1, cfg)));
+        ASSERT_EQUALS(1U, library2.functions.count("foo"));
+        ASSERT_EQUALS(true, library2.functions.at("foo").argumentChecks.at(1).notnull);
+        ASSERT_EQUALS("0:10", library2.functions.at("foo").argumentChecks.at(1).valid);
+        ASSERT_EQUALS(2U, library2.podtype("s16")->size);
+        ASSERT_EQUALS(library1.checksum(), library2.checksum());
+        ASSERT_EQUALS(true, Library::OK == library2.load(nullptr, cfg.c_str()).errorcode); // duplicate
+
+        // Write another library to the cache file so it can be seen that the cache is used
+        Library other;
+        ASSERT_EQUALS(true, Library::OK == readLibrary(other, "<?xml version=\"1.0\"?>\n<def><function name=\"bar\"/></def>").errorcode);
+        ASSERT_EQUALS(true, LibraryCache::save(other, cacheFile, key));
+        ASSERT_EQUALS(false, LibraryCache::load(other, cacheFile, key + 1));
+        Library library3;
+        library3.setCacheDir(".");
+        ASSERT_EQUALS(true, Library::OK == library3.load(nullptr, cfg.c_str()).errorcode);
+        ASSERT_EQUALS(0U, library3.functions.count("foo"));
+        ASSERT_EQUALS(1U, library3.functions.count("bar"));
+        ASSERT_EQUALS(true, library3.checksum() != library1.checksum());
+
+        // A changed cfg file is loaded again
+        {
+            std::ofstream fout(cfg);
+            fout << "<?xml version=\"1.0\"?>\n<def/>";
+        }
+        Library library4;
+        library4.setCacheDir(".");
+        ASSERT_EQUALS(true, Library::OK == library4.load(nullptr, cfg.c_str()).errorcode);
+        ASSERT_EQUALS(true, library4.functions.empty());
+
+        const unsigned long long key4 = LibraryCache::hash(LibraryCache::hash(0, Path::getAbsoluteFilePath(cfg)), "<?xml version=\"1.0\"?>\n<def/>");
+        ASSERT_EQUALS(true, fileExists("./" + LibraryCache::filename(key4)));
+
+        std::remove(cfg.c_str());
+        std::remove(cacheFile.c_str());
+        std::remove(("./" + LibraryCache::filename(key4)).c_str());
+    }
+
+    void cacheStd() {
+        // Everything in std.cfg is restored from the cache
+        Library library1;
+        LOAD_LIB_2(library1, "std.cfg");
+        ASSERT_EQUALS(true, LibraryCache::save(library1, "testlibrarycache1.cfgcache", 1));
+        Library library2;
+        ASSERT_EQUALS(true, LibraryCache::load(library2, "testlibrarycache1.cfgcache", 1));
+        ASSERT_EQUALS(true, LibraryCache::save(library2, "testlibrarycache2.cfgcache", 1));
+        ASSERT_EQUALS(true, readFile("testlibrarycache1.cfgcache") == readFile("testlibrarycache2.cfgcache"));
+        ASSERT_EQUALS(library1.functions.size(), library2.functions.size());
+        ASSERT_EQUALS(library1.containers.size(), library2.containers.size());
+        std::remove("testlibrarycache1.cfgcache");
+        std::remove("testlibrarycache2.cfgcache");
+    }
 };
 
 REGISTER_TEST(TestLibrary)
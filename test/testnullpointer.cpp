@@ -132,6 +132,7 @@ private:
         TEST_CASE(isPointerDeRefFunctionDecl);
 
         TEST_CASE(ctu);
+        TEST_CASE(ctuJobs);
     }
 
     void check(const char code[], bool inconclusive = false, const char filename[] = "test.cpp") {
@@ -3415,6 +3416,32 @@ private:
             "}\n");
         ASSERT_EQUALS("", errout.str());
     }
+
+    void ctuJobs() {
+        // The error paths are searched in parallel, the errors are reported in order
+        setMultiline();
+        settings.jobs = 4;
+        ctu("void f1(int *p) { a = *p; }\n"
+            "void f2(int *p) { a = *p; }\n"
+            "void f3(int *p) { a = *p; }\n"
+            "void g(int *p) { f3(p); }\n"
+            "int main() {\n"
+            "  f1(0);\n"
+            "  f2(0);\n"
+            "  g(0);\n"
+            "}");
+        settings.jobs = 1;
+        ASSERT_EQUALS("test.cpp:1:error:Null pointer dereference: p\n"
+                      "test.cpp:6:note:Calling function f1, 1st argument is null\n"
+                      "test.cpp:1:note:Dereferencing argument p that is null\n"
+                      "test.cpp:2:error:Null pointer dereference: p\n"
+                      "test.cpp:7:note:Calling function f2, 1st argument is null\n"
+                      "test.cpp:2:note:Dereferencing argument p that is null\n"
+                      "test.cpp:3:error:Null pointer dereference: p\n"
+                      "test.cpp:8:note:Calling function g, 1st argument is null\n"
+                      "test.cpp:4:note:Calling function f3, 1st argument is null\n"
+                      "test.cpp:3:note:Dereferencing argument p that is null\n", errout.str());
+    }
 };
 
 REGISTER_TEST(TestNullPointer)
@@ -26,10 +26,13 @@
 #include "testsuite.h"
 
 #include <simplecpp.h>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <list>
 #include <map>
 #include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -246,6 +249,8 @@ private:
         TEST_CASE(testDirectiveIncludeTypes);
         TEST_CASE(testDirectiveIncludeLocations);
         TEST_CASE(testDirectiveIncludeComments);
+
+        TEST_CASE(checksum);
     }
 
     void preprocess(const char* code, std::map<std::string, std::string>& actual, const char filename[] = "file.c") {
@@ -2362,6 +2367,38 @@ private:
         preprocessor.dump(ostr);
         ASSERT_EQUALS(dumpdata, ostr.str());
     }
+
+    unsigned long long getChecksum(const char code[], const std::string &toolinfo = "toolinfo") {
+        Preprocessor preprocessor(settings0, this);
+        std::vector<std::string> files;
+        std::istringstream istr(code);
+        simplecpp::TokenList tokens(istr, files, "test.c");
+        preprocessor.loadFiles(tokens, files);
+        tokens.removeComments();
+        preprocessor.removeComments();
+        return preprocessor.calculateChecksum(tokens, toolinfo);
+    }
+
+    static void writeFile(const char filename[], const char data[]) {
+        std::ofstream fout(filename);
+        fout << data;
+    }
+
+    void checksum() {
+        const char code[] = "#include \"testchecksum.h\"\nint x;";
+        writeFile("testchecksum.h", "int a;");
+        const unsigned long long checksum1 = getChecksum(code);
+        ASSERT_EQUALS(checksum1, getChecksum(code));
+        ASSERT_EQUALS(checksum1, getChecksum("#include \"testchecksum.h\" // comment\nint x;"));
+        ASSERT(checksum1 != getChecksum(code, "toolinfo2"));
+        ASSERT(checksum1 != getChecksum("#include \"testchecksum.h\"\nint y;"));
+
+        // The header is changed
+        writeFile("testchecksum.h", "int ab;");
+        ASSERT(checksum1 != getChecksum(code));
+
+        std::remove("testchecksum.h");
+    }
 };
 
 REGISTER_TEST(TestPreprocessor)
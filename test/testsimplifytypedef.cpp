@@ -169,6 +169,7 @@ private:
         TEST_CASE(simplifyTypedef131); // ticket #9446
         TEST_CASE(simplifyTypedef132); // ticket #9739 - using
         TEST_CASE(simplifyTypedef133); // ticket #9812 - using
+        TEST_CASE(simplifyTypedef134); // all uses are substituted when the search stops early
 
         TEST_CASE(simplifyTypedefFunction1);
         TEST_CASE(simplifyTypedefFunction2); // ticket #1685
@@ -2660,6 +2661,23 @@ private:
         ASSERT_EQUALS("using array_p = const unsigned char ( * ) [ 16 ] ; array_p x ;", tok(code, false));
     }
 
+    void simplifyTypedef134() {
+        // B is used in the substituted type of A
+        const char code[] = "typedef B A;\n"
+                            "typedef int B;\n"
+                            "A a1;\n"
+                            "struct S { typedef long L; L f(); };\n"
+                            "S::L S::f() { L l = 0; return l; }\n"
+                            "void g() { { A a2; } B b; }\n"
+                            "void h() { S::L l; }";
+        const char exp[] = "int a1 ; "
+                           "struct S { long f ( ) ; } ; "
+                           "long S :: f ( ) { long l ; l = 0 ; return l ; } "
+                           "void g ( ) { { int a2 ; } int b ; } "
+                           "void h ( ) { long l ; }";
+        ASSERT_EQUALS(exp, tok(code, false));
+    }
+
     void simplifyTypedefFunction1() {
         {
             const char code[] = "typedef void (*my_func)();\n"
@@ -48,6 +48,7 @@ private:
         TEST_CASE(suppressionsPathSeparator);
         TEST_CASE(suppressionsLine0);
         TEST_CASE(suppressionsFileComment);
+        TEST_CASE(suppressionsMatchOrder);
 
         TEST_CASE(inlinesuppress);
         TEST_CASE(inlinesuppress_symbolname);
@@ -80,6 +81,42 @@ private:
         ASSERT_EQUALS("", suppressions.parseFile(s2));
     }
 
+    void suppressionsMatchOrder() const {
+        // The first matching suppression in the list is marked as matched, whatever kind of suppression it is
+        Suppressions suppressions;
+        std::istringstream s("*:a.cpp\n"
+                             "abc:a.cpp:1\n"
+                             "abc:*.cpp\n"
+                             "abc\n"
+                             "def:sub\\b.cpp:2\n"
+                             "def:b.cpp\n");
+        ASSERT_EQUALS("", suppressions.parseFile(s));
+        Suppressions::Suppression hashSuppression;
+        hashSuppression.hash = 123;
+        ASSERT_EQUALS("", suppressions.addSuppression(hashSuppression));
+
+        ASSERT_EQUALS(true, suppressions.isSuppressed(errorMessage("abc", "a.cpp", 1)));
+        ASSERT_EQUALS(true, suppressions.isSuppressed(errorMessage("abc", "c.c", 1)));
+        ASSERT_EQUALS(true, suppressions.isSuppressed(errorMessage("def", "sub/b.cpp", 2)));
+        ASSERT_EQUALS(false, suppressions.isSuppressed(errorMessage("def", "sub/b.cpp", 3)));
+        Suppressions::ErrorMessage errmsg = errorMessage("ghi", "c.cpp", 1);
+        errmsg.hash = 123;
+        ASSERT_EQUALS(true, suppressions.isSuppressed(errmsg));
+        ASSERT_EQUALS(false, suppressions.isSuppressedLocal(errorMessage("abc", "c.cpp", 1)));
+        ASSERT_EQUALS(false, suppressions.isSuppressed(errorMessage("unmatchedSuppression", "a.cpp", 1)));
+
+        std::string unmatched;
+        for (const Suppressions::Suppression &suppression : suppressions.getUnmatchedLocalSuppressions("a.cpp", true))
+            unmatched += suppression.getText() + '\n';
+        for (const Suppressions::Suppression &suppression : suppressions.getUnmatchedLocalSuppressions("b.cpp", true))
+            unmatched += suppression.getText() + '\n';
+        for (const Suppressions::Suppression &suppression : suppressions.getUnmatchedGlobalSuppressions(true))
+            unmatched += suppression.getText() + '\n';
+        ASSERT_EQUALS("abc fileName=a.cpp lineNumber=1\n"
+                      "def fileName=b.cpp\n"
+                      "abc fileName=*.cpp\n", unmatched);
+    }
+
     Suppressions::ErrorMessage errorMessage(const std::string &errorId) const {
         Suppressions::ErrorMessage ret;
         ret.errorId = errorId;
@@ -165,6 +165,7 @@ private:
         TEST_CASE(findVariableType1);
         TEST_CASE(findVariableType2);
         TEST_CASE(findVariableType3);
+        TEST_CASE(findVariableType4); // record, enumerator and function looked up by name in the nested scopes
         TEST_CASE(findVariableTypeExternC);
 
         TEST_CASE(rangeBasedFor);
@@ -1152,6 +1153,38 @@ private:
         ASSERT(avar && avar->type() != nullptr);
     }
 
+    void findVariableType4() {
+        GET_SYMBOL_DB("namespace N {\n"
+                      "    void S() {}\n"
+                      "    struct S { int x; };\n"
+                      "    enum E { A, B };\n"
+                      "}\n"
+                      "namespace { int g() { return 0; } }\n"
+                      "void f() {\n"
+                      "    N::S s;\n"
+                      "    int b = N::B + g();\n"
+                      "}");
+        ASSERT(db != nullptr);
+        if (!db)
+            return;
+
+        const Scope *ns = db->scopeList.front().findRecordInNestedList("N");
+        ASSERT(ns && ns->type == Scope::eNamespace);
+        if (!ns)
+            return;
+        const Scope *structScope = ns->findRecordInNestedList("S");
+        ASSERT(structScope && structScope->type == Scope::eStruct);
+
+        const Variable *svar = Token::findsimplematch(tokenizer.tokens(), "s ;")->variable();
+        ASSERT(svar && svar->type() && svar->type()->classScope == structScope);
+
+        const Token *enumeratorTok = Token::findsimplematch(tokenizer.tokens(), "B +");
+        ASSERT(enumeratorTok && enumeratorTok->enumerator() && enumeratorTok->enumerator()->value == 1);
+
+        const Token *callTok = Token::findsimplematch(tokenizer.tokens(), "g ( ) ;");
+        ASSERT(callTok && callTok->function() && callTok->function()->name() == "g");
+    }
+
     void findVariableTypeExternC() {
         GET_SYMBOL_DB("extern \"C\" { typedef int INT; }\n"
                       "void bar() {\n"
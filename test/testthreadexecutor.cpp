@@ -16,11 +16,18 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "analyzerinfo.h"
+#include "checkunusedfunctions.h"
+#include "cppcheck.h"
+#include "cppcheckexecutor.h"
 #include "settings.h"
 #include "testsuite.h"
 #include "threadexecutor.h"
 
 #include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <list>
 #include <map>
 #include <ostream>
 #include <string>
@@ -71,6 +78,9 @@ private:
         TEST_CASE(no_errors_equal_amount_files);
         TEST_CASE(one_error_less_files);
         TEST_CASE(one_error_several_files);
+        TEST_CASE(largest_file_first);
+        TEST_CASE(process_executor);
+        TEST_CASE(whole_program_analysis);
     }
 
     void deadlock_with_many_errors() {
@@ -135,6 +145,79 @@ private:
               "  return 0;\n"
               "}");
     }
+
+    void largest_file_first() {
+        output.str("");
+        if (!ThreadExecutor::isEnabled())
+            return;
+
+        std::map<std::string, std::size_t> filemap;
+        filemap["a.cpp"] = 10;
+        filemap["b.cpp"] = 30;
+        filemap["c.cpp"] = 20;
+
+        settings.jobs = 1;
+        ThreadExecutor executor(filemap, settings, *this);
+        for (std::map<std::string, std::size_t>::const_iterator i = filemap.begin(); i != filemap.end(); ++i)
+            executor.addFileContent(i->first, "void f();");
+        ASSERT_EQUALS(0, executor.check());
+        ASSERT_EQUALS("Checking b.cpp ...\n"
+                      "Checking c.cpp ...\n"
+                      "Checking a.cpp ...\n", output.str());
+    }
+
+    void process_executor() {
+#ifdef THREADING_MODEL_FORK
+        settings.executor = Settings::ExecutorType::Process;
+        deadlock_with_many_errors();
+        one_error_several_files();
+        whole_program_analysis();
+        settings.executor = Settings::ExecutorType::Thread;
+#endif
+    }
+
+    void whole_program_analysis() {
+        errout.str("");
+        if (!ThreadExecutor::isEnabled())
+            return;
+
+        std::map<std::string, std::size_t> filemap;
+        filemap["a.cpp"] = 1;
+        filemap["b.cpp"] = 1;
+
+        // The functions of the other tests must not be reported
+        CheckUnusedFunctions::clear();
+
+        // The functions are matched by the location of their declaration
+        {
+            std::ofstream fout("whole_program.h");
+            fout << "void f(int *p);\n";
+        }
+
+        Settings s = settings;
+        s.jobs = 2;
+        s.addEnabled("unusedFunction");
+        ThreadExecutor executor(filemap, s, *this);
+        executor.addFileContent("a.cpp", "#include \"whole_program.h\"\n"
+                                "void f(int *p) { *p = 0; }\n"
+                                "void unused() {}\n");
+        executor.addFileContent("b.cpp", "#include \"whole_program.h\"\n"
+                                "int main() { f(0); return 0; }\n");
+        executor.check();
+        errout.str("");
+        std::remove("whole_program.h");
+
+        const std::list<AnalyzerInformation::TranslationUnitInfo> &fileInfo = executor.getFileInfo();
+        ASSERT_EQUALS(2U, fileInfo.size());
+        ASSERT_EQUALS("a.cpp", fileInfo.front().sourcefile);
+        ASSERT_EQUALS("b.cpp", fileInfo.back().sourcefile);
+
+        CppCheck cppcheck(*this, true, CppCheckExecutor::executeCommand);
+        cppcheck.settings() = s;
+        cppcheck.analyseWholeProgram(fileInfo);
+        ASSERT_EQUALS("[a.cpp:3]: (style) The function 'unused' is never used.\n"
+                      "[b.cpp:2] -> [a.cpp:2]: (error) Null pointer dereference: p\n", errout.str());
+    }
 };
 
 REGISTER_TEST(TestThreadExecutor)
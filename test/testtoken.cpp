@@ -17,6 +17,7 @@
  */
 
 #include "settings.h"
+#include "symboldatabase.h"
 #include "testsuite.h"
 #include "testutils.h"
 #include "token.h"
@@ -110,6 +111,8 @@ private:
         TEST_CASE(expressionString);
 
         TEST_CASE(hasKnownIntValue);
+
+        TEST_CASE(valueChanges);
     }
 
     void nextprevious() const {
@@ -1135,6 +1138,48 @@ private:
         ASSERT_EQUALS(true, token.addValue(v2));
         ASSERT_EQUALS(false, token.hasKnownIntValue());
     }
+
+    void valueChanges() {
+        const Scope scope(nullptr, nullptr, nullptr);
+        Token token;
+        token.scope(&scope);
+
+        ValueFlow::Value v(1);
+        v.setKnown();
+        ASSERT_EQUALS(true, token.addValue(v));
+        ASSERT_EQUALS(1U, scope.valueChanges);
+
+        // same known value => no change
+        ASSERT_EQUALS(true, token.addValue(v));
+        ASSERT_EQUALS(1U, scope.valueChanges);
+
+        v.intvalue = 2;
+        ASSERT_EQUALS(true, token.addValue(v));
+        ASSERT_EQUALS(2U, scope.valueChanges);
+
+        token.removeValues([](const ValueFlow::Value &) {
+            return false;
+        });
+        ASSERT_EQUALS(2U, scope.valueChanges);
+        token.removeValues([](const ValueFlow::Value &) {
+            return true;
+        });
+        ASSERT_EQUALS(3U, scope.valueChanges);
+
+        // removing a possible value is a change
+        ValueFlow::Value possible(3);
+        ASSERT_EQUALS(true, token.addValue(possible));
+        ASSERT_EQUALS(4U, scope.valueChanges);
+        ASSERT_EQUALS(true, token.addValue(v));
+        ASSERT_EQUALS(5U, scope.valueChanges);
+
+        // the same known value replaces the known value and a possible value
+        ASSERT_EQUALS(true, token.addValue(possible));
+        ASSERT_EQUALS(6U, scope.valueChanges);
+        ASSERT_EQUALS(true, token.addValue(v));
+        ASSERT_EQUALS(7U, scope.valueChanges);
+        ASSERT_EQUALS(1U, token.values().size());
+    }
 };
 
 REGISTER_TEST(TestToken)
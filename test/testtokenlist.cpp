@@ -36,6 +36,7 @@ private:
         TEST_CASE(testaddtoken2);
         TEST_CASE(inc);
         TEST_CASE(isKeyword);
+        TEST_CASE(calculateHash);
     }
 
     // inspired by #5895
@@ -108,6 +109,22 @@ private:
             ASSERT_EQUALS(false, tokenlist.front()->tokAt(4)->isControlFlowKeyword());
         }
     }
+
+    unsigned long long calculateHash(const char code[]) const {
+        TokenList tokenlist(&settings);
+        std::istringstream istr(code);
+        tokenlist.createTokens(istr, "a.cpp");
+        return tokenlist.calculateHash();
+    }
+
+    void calculateHash() const {
+        const unsigned long long hash = calculateHash("template<class T> struct S { T x; };\nS<int> s;");
+        ASSERT_EQUALS(hash, calculateHash("template<class T> struct S { T x; };\nS<int> s;"));
+        ASSERT(hash != calculateHash("template<class T> struct S { T x; };\nS<char> s;"));
+        ASSERT(hash != calculateHash("template<class T> struct S { T x; };\n\nS<int> s;"));
+        ASSERT(hash != calculateHash("template<class T> struct S { T x; };\n S<int> s;"));
+        ASSERT(calculateHash("ab c") != calculateHash("a bc"));
+    }
 };
 
 REGISTER_TEST(TestTokenList)
@@ -29,6 +29,7 @@ private:
     void run() OVERRIDE {
         TEST_CASE(isValidGlobPattern);
         TEST_CASE(matchglob);
+        TEST_CASE(hash64);
     }
 
     void isValidGlobPattern() {
@@ -67,6 +68,29 @@ private:
         ASSERT_EQUALS(true, ::matchglob("?y?", "xyz"));
         ASSERT_EQUALS(true, ::matchglob("?/?/?", "x/y/z"));
     }
+
+    static unsigned long long getHash64(const std::string &data) {
+        Hash64 hash;
+        hash.update(data);
+        return hash.digest();
+    }
+
+    void hash64() {
+        // xxHash64 reference values
+        ASSERT_EQUALS(0xEF46DB3751D8E999ULL, getHash64(""));
+        ASSERT_EQUALS(0xD24EC4F1A98C6E5BULL, getHash64("a"));
+        ASSERT_EQUALS(0x44BC2CF5AD770999ULL, getHash64("abc"));
+        ASSERT_EQUALS(0xFBCEA83C8A378BF1ULL, getHash64("Nobody inspects the spammish repetition"));
+
+        // The data can be added in pieces
+        std::string data;
+        for (int i = 0; i < 1000; ++i)
+            data += static_cast<char>(i * 7);
+        Hash64 hash;
+        for (std::string::size_type pos = 0; pos < data.size(); pos += 13)
+            hash.update(data.substr(pos, 13));
+        ASSERT_EQUALS(getHash64(data), hash.digest());
+    }
 };
 
 REGISTER_TEST(TestUtils)
@@ -140,6 +140,11 @@ private:
         TEST_CASE(valueFlowCrashConstructorInitialization);
 
         TEST_CASE(valueFlowUnknownMixedOperators);
+
+        TEST_CASE(valueFlowJobs);
+        TEST_CASE(valueFlowChangedFunctions);
+
+        TEST_CASE(errorPathChain);
     }
 
     static bool isNotTokValue(const ValueFlow::Value &val) {
@@ -4984,6 +4989,130 @@ private:
 
         ASSERT_EQUALS(false, testValueOfXKnown(code, 4U, 1));
     }
+
+    void valueFlowJobs() {
+        // The functions are analysed by several threads
+        settings.valueFlowJobs = 4;
+
+        const char *code = "void f1(int x) {\n"
+                           "    a = x;\n"
+                           "    if (x == 1) {}\n"
+                           "}\n"
+                           "void f2() {\n"
+                           "    int x = 2;\n"
+                           "    a = x;\n"
+                           "}\n"
+                           "void f3(int x) {\n"
+                           "    if (x == 3) {\n"
+                           "        a = x;\n"
+                           "    }\n"
+                           "}\n"
+                           "void f4(int x) {\n"
+                           "    a = x;\n"
+                           "}\n"
+                           "void f5() {\n"
+                           "    f4(5);\n"
+                           "}\n"
+                           "void f6() {\n"
+                           "    struct S {\n"
+                           "        void g() {\n"
+                           "            int x = 6;\n"
+                           "            a = x;\n"
+                           "        }\n"
+                           "    };\n"
+                           "    int x = 7;\n"
+                           "    a = x;\n"
+                           "}";
+        ASSERT_EQUALS(true, testValueOfX(code, 2U, 1));
+        ASSERT_EQUALS(true, testValueOfXKnown(code, 7U, 2));
+        ASSERT_EQUALS(true, testValueOfX(code, 11U, 3));
+        ASSERT_EQUALS(true, testValueOfX(code, 15U, 5));
+        ASSERT_EQUALS(true, testValueOfXKnown(code, 24U, 6));
+        ASSERT_EQUALS(true, testValueOfXKnown(code, 28U, 7));
+
+        // The bailouts are reported in the order of the functions
+        bailout("void f1(int a) {\n"
+                "    a = g();\n"
+                "    if (a == 1) {}\n"
+                "}\n"
+                "void f2(int b) {\n"
+                "    b = g();\n"
+                "    if (b == 2) {}\n"
+                "}\n"
+                "void f3(int c) {\n"
+                "    c = g();\n"
+                "    if (c == 3) {}\n"
+                "}");
+        ASSERT_EQUALS_WITHOUT_LINENUMBERS("[test.cpp:2]: (debug) valueflow.cpp::valueFlowReverse bailout: assignment of a\n"
+                                          "[test.cpp:6]: (debug) valueflow.cpp::valueFlowReverse bailout: assignment of b\n"
+                                          "[test.cpp:10]: (debug) valueflow.cpp::valueFlowReverse bailout: assignment of c\n", errout.str());
+
+        settings.valueFlowJobs = 1;
+    }
+
+    void valueFlowChangedFunctions() {
+        // The value reaches f1 in the second iteration, the assignment in f1 is analysed again in the third iteration
+        const char code[] = "void f1(int y) {\n"
+                            "    int x = y;\n"
+                            "    a = x;\n"
+                            "}\n"
+                            "void f2(int y) {\n"
+                            "    f1(y);\n"
+                            "}\n"
+                            "void f3() {\n"
+                            "    f2(1);\n"
+                            "}";
+        ASSERT_EQUALS(true, testValueOfX(code, 3U, 1));
+    }
+
+    static std::string errorPathString(const ValueFlow::ErrorPathChain &errorPath) {
+        std::string ret;
+        for (const ValueFlow::Value::ErrorPathItem &item : errorPath)
+            ret += item.second + ';';
+        return ret;
+    }
+
+    void errorPathChain() {
+        ValueFlow::Value v1;
+        v1.errorPath.emplace_back(nullptr, "a");
+        v1.errorPath.emplace_back(nullptr, "b");
+
+        // The copy shares the items, appending does not change the other value
+        ValueFlow::Value v2(v1);
+        v2.errorPath.emplace_back(nullptr, "c");
+        v1.errorPath.emplace_back(nullptr, "d");
+        ASSERT_EQUALS("a;b;d;", errorPathString(v1.errorPath));
+        ASSERT_EQUALS("a;b;c;", errorPathString(v2.errorPath));
+        ASSERT_EQUALS(3U, v2.errorPath.size());
+        ASSERT_EQUALS("c", v2.errorPath.back().second);
+
+        ErrorPath errorPath(1, ErrorPathItem(nullptr, "x"));
+        v2.errorPath.insert(v2.errorPath.begin(), errorPath.begin(), errorPath.end());
+        v2.errorPath.emplace_front(nullptr, "y");
+        ASSERT_EQUALS("y;x;a;b;c;", errorPathString(v2.errorPath));
+        ASSERT_EQUALS("a;b;d;", errorPathString(v1.errorPath));
+
+        errorPath = v2.errorPath;
+        ASSERT_EQUALS(5U, errorPath.size());
+
+        // The iterators keep the items alive when the path is cleared
+        std::string items;
+        v1.errorPath = v2.errorPath;
+        const ValueFlow::ErrorPathChain::const_iterator end = v1.errorPath.end();
+        for (ValueFlow::ErrorPathChain::const_iterator it = v1.errorPath.begin(); it != end; ++it) {
+            v1.errorPath.clear();
+            items += it->second + ';';
+        }
+        ASSERT_EQUALS("y;x;a;b;c;", items);
+        v1.errorPath = v2.errorPath;
+        const ValueFlow::ErrorPathChain::const_iterator first = v1.errorPath.begin();
+        v1.errorPath.clear();
+        ASSERT_EQUALS("y", first->second);
+
+        v2.errorPath.clear();
+        ASSERT_EQUALS(true, v2.errorPath.empty());
+        ASSERT_EQUALS("", errorPathString(v2.errorPath));
+    }
 };
 
 REGISTER_TEST(TestValueFlow)
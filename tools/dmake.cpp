@@ -286,6 +286,9 @@ int main(int argc, char **argv)
          << "else # !COMSPEC\n"
          << "    uname_S := $(shell sh -c 'uname -s 2>/dev/null || echo not')\n"
          << "\n"
+         << "    # std::thread is used when checking configurations in parallel\n"
+         << "    LIBS += -pthread\n"
+         << "\n"
          << "    ifeq ($(uname_S),Linux)\n"
          << "        ifndef CPPCHK_GLIBCXX_DEBUG\n"
          << "            CPPCHK_GLIBCXX_DEBUG=-D_GLIBCXX_DEBUG\n"
@@ -0,0 +1,48 @@
+#!/usr/bin/env python3
+#
+# Generate a large C++ file for measuring the variable id assignment.
+#
+# The code has many scopes that shadow variables, struct member accesses and
+# classes with member functions implemented outside the class. Compare the
+# "Tokenizer::tokenize::setVarId" time of two cppcheck binaries:
+#
+#   python3 tools/generate-varid-benchmark.py 2000 > varid.cpp
+#   ./cppcheck --showtime=summary --quiet varid.cpp | grep setVarId
+
+import sys
+
+
+def generate(count):
+    out = []
+    out.append('struct Point { int x; int y; struct { int r, g, b; } color; };')
+    for i in range(count):
+        out.append('class C%d {' % i)
+        out.append('public:')
+        out.append('    int get() const;')
+        out.append('    void set(int value);')
+        out.append('private:')
+        out.append('    int mValue%d;' % i)
+        out.append('    Point mPoint;')
+        out.append('};')
+        out.append('int C%d::get() const { return mValue%d + mPoint.x; }' % (i, i))
+        out.append('void C%d::set(int value) { mValue%d = value; mPoint.y = value; }' % (i, i))
+        out.append('int f%d(int a, int b) {' % i)
+        out.append('    int x = a;')
+        out.append('    Point p = { .x = a, .y = b };')
+        out.append('    for (int i = 0; i < b; i++) {')
+        out.append('        int x = i * a;')
+        out.append('        p.color.r += x;')
+        out.append('        if (x > %d) {' % i)
+        out.append('            int a = x + p.y;')
+        out.append('            p.x = a;')
+        out.append('        }')
+        out.append('    }')
+        out.append('    C%d c;' % i)
+        out.append('    c.set(x + p.x + p.color.r);')
+        out.append('    return c.get();')
+        out.append('}')
+    return '\n'.join(out) + '\n'
+
+
+if __name__ == '__main__':
+    sys.stdout.write(generate(int(sys.argv[1]) if len(sys.argv) > 1 else 2000))